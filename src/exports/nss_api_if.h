@@ -63,6 +63,7 @@
 #include "nss_portid.h"
 #include "nss_oam.h"
 #include "nss_dtls.h"
+#include "nss_tstamp.h"
 
 /*
  * Interface numbers are reserved in the
@@ -117,6 +117,27 @@ extern int nss_dynamic_interface_alloc_node(enum nss_dynamic_interface_type type
  */
 extern nss_tx_status_t nss_dynamic_interface_dealloc_node(int if_num, enum nss_dynamic_interface_type type);
 
+/**
+ * @brief Deallocate a batch of nodes of one type on NSS
+ *
+ * @param if_nums interface numbers of the dynamic interfaces
+ * @param count number of entries in if_nums
+ * @param type nss dynamic interface type
+ *
+ * @return nss_tx_status_t Tx status, failure if any node was not deallocated
+ */
+extern nss_tx_status_t nss_dynamic_interface_dealloc_nodes(int *if_nums, uint32_t count, enum nss_dynamic_interface_type type);
+
+/**
+ * @brief Keep nodes of a type allocated on NSS ahead of demand
+ *
+ * @param type nss dynamic interface type
+ * @param count number of nodes to keep ready, 0 releases the pool
+ *
+ * @return the number of nodes that will be kept ready or -EINVAL
+ */
+extern int nss_dynamic_interface_pool_reserve(enum nss_dynamic_interface_type type, uint32_t count);
+
 /**
  * @brief The inferface number belong to the dynamic interface
  *
@@ -135,6 +156,26 @@ extern bool nss_is_dynamic_interface(int if_num);
  */
 extern enum nss_dynamic_interface_type nss_dynamic_interface_get_type(int if_num);
 
+/**
+ * @brief Returns the core a dynamic interface was allocated on
+ *
+ * @param if_num interface number of dynamic interface
+ * @param type nss dynamic interface type, its default core is returned for unknown interfaces
+ *
+ * @return core id
+ */
+extern uint32_t nss_dynamic_interface_get_core(int if_num, enum nss_dynamic_interface_type type);
+
+/**
+ * @brief Returns the context of the core a dynamic interface was allocated on
+ *
+ * @param if_num interface number of dynamic interface
+ * @param type nss dynamic interface type, the context of its default core is returned for unknown interfaces
+ *
+ * @return nss context
+ */
+extern struct nss_ctx_instance *nss_dynamic_interface_get_nss_ctx(int if_num, enum nss_dynamic_interface_type type);
+
 /**
  * @brief Transmits an asynchronous message to firmware.
  *
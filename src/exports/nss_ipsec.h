@@ -263,6 +263,17 @@ extern nss_tx_status_t nss_ipsec_tx_msg(struct nss_ctx_instance *nss_ctx, struct
  */
 extern nss_tx_status_t nss_ipsec_tx_buf(struct sk_buff *skb, uint32_t if_num);
 
+/**
+ * @brief send an IPsec process request to a given IPsec core
+ *
+ * @param nss_ctx[IN] NSS HLOS driver's context of the core owning the SA
+ * @param skb Data buffer
+ * @param if_num NSS interface number
+ *
+ * @return Status
+ */
+extern nss_tx_status_t nss_ipsec_tx_buf_ctx(struct nss_ctx_instance *nss_ctx, struct sk_buff *skb, uint32_t if_num);
+
 /**
  * @brief register a event callback handler with HLOS driver
  *
@@ -274,9 +285,24 @@ extern nss_tx_status_t nss_ipsec_tx_buf(struct sk_buff *skb, uint32_t if_num);
  */
 extern struct nss_ctx_instance *nss_ipsec_notify_register(uint32_t if_num, nss_ipsec_msg_callback_t cb, void *app_data);
 
+/**
+ * @brief register a event callback handler for the events of one IPsec core
+ *
+ * @param core_id[IN] NSS core running IPsec
+ * @param if_num[IN] receive events from this interface (Encap, Decap or C2C)
+ * @param cb[IN] event callback function
+ * @param app_data[IN] context of the callback user
+ *
+ * @return NSS HLOS driver's context of the core, NULL if the core does not run IPsec
+ */
+extern struct nss_ctx_instance *nss_ipsec_notify_register_core(uint8_t core_id, uint32_t if_num, nss_ipsec_msg_callback_t cb, void *app_data);
+
 /**
  * @brief register a data callback handler with HLOS driver
  *
+ * The data callbacks are shared by all IPsec cores; packets for if_num from
+ * any of them are delivered to cb.
+ *
  * @param if_num[IN] receive data from this interface (Encap, Decap or C2C)
  * @param cb[IN] data callback function
  * @param netdev associated netdevice.
@@ -313,6 +339,15 @@ extern void nss_ipsec_data_unregister(struct nss_ctx_instance *ctx, uint32_t if_
  */
 extern struct nss_ctx_instance *nss_ipsec_get_context(void);
 
+/**
+ * @brief get the NSS context of the IPsec core an SA is placed on
+ *
+ * @param sa_hash[IN] caller chosen value identifying the SA, e.g. a hash of its SPI
+ *
+ * @return nss_ctx_instance; the same sa_hash always returns the same core
+ */
+extern struct nss_ctx_instance *nss_ipsec_get_context_by_sa(uint32_t sa_hash);
+
 /**
  * @brief Initialize ipsec message
  *
@@ -533,6 +533,8 @@ struct nss_shaper_configure {
 };
 
 typedef void (*nss_shaper_bounced_callback_t)(void *app_data, struct sk_buff *skb);	/* Registrant callback to receive shaper bounced packets */
+typedef void (*nss_shaper_bounced_list_callback_t)(void *app_data, struct sk_buff_head *list);
+											/* Registrant callback to receive the shaper bounced packets of one poll */
 
 /**
  * @brief Register for basic shaping operations
@@ -557,9 +559,21 @@ extern void nss_shaper_unregister_shaping(void *ctx);
  */
 extern void *nss_shaper_register_shaper_bounce_interface(uint32_t if_num, nss_shaper_bounced_callback_t cb, void *app_data, struct module *owner);
 
+/**
+ * @brief Register to received shaper bounced packets in lists (interface bounce)
+ * @param if_num Interface to be registered on
+ * @param cb Callback invoked with the sk_buffs the NSS returned in one poll; the callback takes off the list each sk_buff it keeps, and those left on the list when it returns are freed
+ * @param app_data Given to the callback along with the list to provide context to the registrant (state)
+ * @param owner Pass THIS_MODULE for this parameter - your module is held until you unregister
+ * @return void * NSS context or NULL on failure
+ */
+extern void *nss_shaper_register_shaper_bounce_interface_list(uint32_t if_num, nss_shaper_bounced_list_callback_t cb, void *app_data, struct module *owner);
+
 /**
  * @brief Unregister for interface shaper bouncing
  * @param if_num Interface to be unregistered
+ *
+ * Sleeps until no bounced callback of the registrant is running.
  */
 extern void nss_shaper_unregister_shaper_bounce_interface(uint32_t if_num);
 
@@ -573,9 +587,21 @@ extern void nss_shaper_unregister_shaper_bounce_interface(uint32_t if_num);
  */
 extern void *nss_shaper_register_shaper_bounce_bridge(uint32_t if_num, nss_shaper_bounced_callback_t cb, void *app_data, struct module *owner);
 
+/**
+ * @brief Register to received shaper bounced packets in lists (bridge bounce)
+ * @param if_num Interface to be registered on
+ * @param cb Callback invoked with the sk_buffs the NSS returned in one poll; the callback takes off the list each sk_buff it keeps, and those left on the list when it returns are freed
+ * @param app_data Given to the callback along with the list to provide context to the registrant (state)
+ * @param owner Pass THIS_MODULE for this parameter - your module is held until you unregister
+ * @return void * NSS context or NULL on failure
+ */
+extern void *nss_shaper_register_shaper_bounce_bridge_list(uint32_t if_num, nss_shaper_bounced_list_callback_t cb, void *app_data, struct module *owner);
+
 /**
  * @brief Unregister for bridge shaper bouncing
  * @param if_num Interface to be unregistered
+ *
+ * Sleeps until no bounced callback of the registrant is running.
  */
 extern void nss_shaper_unregister_shaper_bounce_bridge (uint32_t if_num);
 
@@ -585,18 +611,42 @@ extern void nss_shaper_unregister_shaper_bounce_bridge (uint32_t if_num);
  * @param if_num Interface to be bounced to
  * @param skb The packet
  * @return nss_tx_status_t Succes or failure to issue packet to NSS
+ *
+ * With packet latency telemetry enabled, the last 8 bytes of skb->cb are
+ * used while the packet is bounced.
  */
 extern nss_tx_status_t nss_shaper_bounce_interface_packet(void *ctx, uint32_t if_num, struct sk_buff *skb);
 
+/**
+ * @brief Issue a list of packets for shaping via bounce operations, with one doorbell to the NSS
+ * @param ctx NSS context you were given when you registered for shaper bouncing
+ * @param if_num Interface to be bounced to
+ * @param list The packets; the caller serialises access to the list
+ * @return nss_tx_status_t Success if all packets were issued; on failure the packets not issued are left on the list
+ */
+extern nss_tx_status_t nss_shaper_bounce_interface_packets(void *ctx, uint32_t if_num, struct sk_buff_head *list);
+
 /**
  * @brief Issue a packet for shaping via a bounce operation
  * @param ctx NSS context you were given when you registered for shaper bouncing
  * @param if_num Interface to be bounced to
  * @param skb The packet
  * @return nss_tx_status_t Succes or failure to issue packet to NSS
+ *
+ * With packet latency telemetry enabled, the last 8 bytes of skb->cb are
+ * used while the packet is bounced.
  */
 extern nss_tx_status_t nss_shaper_bounce_bridge_packet(void *ctx, uint32_t if_num, struct sk_buff *skb);
 
+/**
+ * @brief Issue a list of packets for shaping via bounce operations, with one doorbell to the NSS
+ * @param ctx NSS context you were given when you registered for shaper bouncing
+ * @param if_num Interface to be bounced to
+ * @param list The packets; the caller serialises access to the list
+ * @return nss_tx_status_t Success if all packets were issued; on failure the packets not issued are left on the list
+ */
+extern nss_tx_status_t nss_shaper_bounce_bridge_packets(void *ctx, uint32_t if_num, struct sk_buff_head *list);
+
 /**
  * @brief Send a shaping configuration message
  * @param ctx NSS context
@@ -0,0 +1,86 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/**
+ * nss_stats_genl.h
+ *	NSS statistics generic netlink family definitions
+ *
+ * This header is shared with userspace monitoring tools and must only
+ * contain definitions that are valid outside of the kernel.
+ */
+
+#ifndef __NSS_STATS_GENL_H
+#define __NSS_STATS_GENL_H
+
+#define NSS_STATS_GENL_FAMILY_NAME	"nss_stats"	/**< Generic netlink family name */
+#define NSS_STATS_GENL_MCGRP_NAME	"nss_stats_ev"	/**< Multicast group carrying sync events */
+#define NSS_STATS_GENL_VERSION		2		/**< Family version */
+
+/**
+ * Generic netlink commands
+ */
+enum nss_stats_genl_cmd {
+	NSS_STATS_GENL_CMD_UNSPEC,
+	NSS_STATS_GENL_CMD_GET,		/**< Dump current totals (request, dump only) */
+	NSS_STATS_GENL_CMD_SYNC,	/**< Counter totals after a firmware sync (event) */
+	NSS_STATS_GENL_CMD_CONN_SYNC,	/**< Aggregate of the connection syncs of one message (event) */
+	NSS_STATS_GENL_CMD_MAX,
+};
+
+/**
+ * Generic netlink attributes
+ */
+enum nss_stats_genl_attr {
+	NSS_STATS_GENL_ATTR_UNSPEC,
+	NSS_STATS_GENL_ATTR_GROUP,	/**< u32, enum nss_stats_genl_group */
+	NSS_STATS_GENL_ATTR_INSTANCE,	/**< u32, interface/core/radio index within the group */
+	NSS_STATS_GENL_ATTR_CORE,	/**< u32, NSS core that sent the sync */
+	NSS_STATS_GENL_ATTR_COUNTERS,	/**< Binary array of u64 counters, debugfs order or enum nss_stats_genl_conn */
+	NSS_STATS_GENL_ATTR_CONN_SYNC,	/**< Unused since version 2; connection tuples are not multicast */
+	NSS_STATS_GENL_ATTR_MAX,
+};
+
+/**
+ * Statistics groups
+ */
+enum nss_stats_genl_group {
+	NSS_STATS_GENL_GROUP_DRV,	/**< HLOS driver stats, single instance */
+	NSS_STATS_GENL_GROUP_NODE,	/**< Node stats, instance is the interface number */
+	NSS_STATS_GENL_GROUP_IPV4,	/**< IPv4 stats followed by IPv4 exception events */
+	NSS_STATS_GENL_GROUP_IPV6,	/**< IPv6 stats followed by IPv6 exception events */
+	NSS_STATS_GENL_GROUP_N2H,	/**< N2H stats, instance is the core id */
+	NSS_STATS_GENL_GROUP_GMAC,	/**< GMAC stats, instance is the GMAC id */
+	NSS_STATS_GENL_GROUP_WIFI,	/**< Wifi stats, instance is the radio id */
+	NSS_STATS_GENL_GROUP_MAX,
+};
+
+/**
+ * Counters of a NSS_STATS_GENL_CMD_CONN_SYNC event, summed over its connections
+ */
+enum nss_stats_genl_conn {
+	NSS_STATS_GENL_CONN_SYNCS,		/**< Connection sync records */
+	NSS_STATS_GENL_CONN_FLOW_RX_PACKETS,	/**< Flow direction RX packets */
+	NSS_STATS_GENL_CONN_FLOW_RX_BYTES,	/**< Flow direction RX bytes */
+	NSS_STATS_GENL_CONN_FLOW_TX_PACKETS,	/**< Flow direction TX packets */
+	NSS_STATS_GENL_CONN_FLOW_TX_BYTES,	/**< Flow direction TX bytes */
+	NSS_STATS_GENL_CONN_RETURN_RX_PACKETS,	/**< Return direction RX packets */
+	NSS_STATS_GENL_CONN_RETURN_RX_BYTES,	/**< Return direction RX bytes */
+	NSS_STATS_GENL_CONN_RETURN_TX_PACKETS,	/**< Return direction TX packets */
+	NSS_STATS_GENL_CONN_RETURN_TX_BYTES,	/**< Return direction TX bytes */
+	NSS_STATS_GENL_CONN_MAX,
+};
+
+#endif /* __NSS_STATS_GENL_H */
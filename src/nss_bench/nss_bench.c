@@ -0,0 +1,524 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_bench.c
+ *	Host <-> NSS packet rate benchmark
+ *
+ * Creates a virtual interface and sends test frames to the NSS through
+ * nss_virt_if_tx_buf(). Frames the firmware hands back on the virtual
+ * interface are matched by a magic in the payload and used for latency.
+ *
+ * Build with "make NSS_BENCH=y", then:
+ *	echo 1 > /sys/kernel/debug/qca-nss-bench/run
+ *	cat /sys/kernel/debug/qca-nss-bench/run
+ * Test parameters are module parameters under /sys/module/qca_nss_bench/parameters.
+ */
+#include <linux/module.h>
+#include <linux/version.h>
+#include <linux/kernel.h>
+#include <linux/netdevice.h>
+#include <linux/etherdevice.h>
+#include <linux/skbuff.h>
+#include <linux/debugfs.h>
+#include <linux/workqueue.h>
+#include <linux/timex.h>
+#include <linux/ktime.h>
+#include <linux/delay.h>
+#include <linux/uaccess.h>
+#include <nss_api_if.h>
+
+#define NSS_BENCH_MAGIC		0x4e535342	/* Payload marker of benchmark frames */
+#define NSS_BENCH_ETHERTYPE	0x88b5		/* IEEE local experimental ethertype */
+#define NSS_BENCH_LAT_BUCKETS	40		/* log2(ns) latency buckets */
+#define NSS_BENCH_QFULL_RETRIES	10000		/* Retries of one frame on a full H2N queue */
+#define NSS_BENCH_PKT_SIZE_MAX	9216		/* Largest frame, jumbo included */
+#define NSS_BENCH_FRAG_SEGS_MAX	16		/* Most buffers in one frame */
+
+static int packets = 100000;
+module_param(packets, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(packets, "Frames sent per run");
+
+static int pkt_size = 64;
+module_param(pkt_size, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(pkt_size, "Frame size in bytes, including the Ethernet header");
+
+static int frag_segs = 1;
+module_param(frag_segs, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(frag_segs, "Number of buffers per frame; > 1 builds a frag_list chain");
+
+static int gso_size;
+module_param(gso_size, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(gso_size, "GSO size passed to the NSS as MSS, 0 disables GSO");
+
+/*
+ * nss_bench_hdr
+ *	Payload of a benchmark frame, right after the Ethernet header
+ */
+struct nss_bench_hdr {
+	uint32_t magic;		/* NSS_BENCH_MAGIC */
+	uint32_t seq;		/* Sequence number */
+	uint64_t tx_ns;		/* Send time */
+} __attribute__((packed));
+
+/*
+ * nss_bench_params
+ *	Test parameters a run was started with
+ */
+struct nss_bench_params {
+	int packets;		/* Frames sent */
+	int pkt_size;		/* Frame size, including the Ethernet header */
+	int frag_segs;		/* Buffers per frame */
+	int gso_size;		/* MSS handed to the NSS, 0 for none */
+};
+
+#define NSS_BENCH_HEAD_MIN	(ETH_HLEN + (int)sizeof(struct nss_bench_hdr))
+					/* Smallest head buffer; holds the headers the frame is built from */
+
+/*
+ * nss_bench_result
+ *	Counters of the last run
+ */
+struct nss_bench_result {
+	uint64_t sent;				/* Frames accepted by the driver */
+	uint64_t tx_errors;			/* Frames rejected for other reasons */
+	uint64_t queue_full;			/* NSS_TX_FAILURE_QUEUE returns */
+	uint64_t alloc_fails;			/* skb allocation failures */
+	uint64_t tx_cycles;			/* Cycles spent in nss_virt_if_tx_buf() */
+	uint64_t elapsed_ns;			/* Duration of the send loop */
+	atomic64_t received;			/* Benchmark frames returned by the NSS */
+	atomic64_t lat_hist[NSS_BENCH_LAT_BUCKETS];
+						/* Round trip latency histogram */
+	atomic64_t lat_max_ns;			/* Worst round trip latency */
+};
+
+static struct nss_bench_result nss_bench_res;
+static struct nss_bench_params nss_bench_cfg;
+static struct net_device *nss_bench_dev;
+static struct nss_virt_if_handle *nss_bench_handle;
+static struct dentry *nss_bench_dentry;
+static struct work_struct nss_bench_work;
+static unsigned long nss_bench_flags;
+
+#define NSS_BENCH_FLAG_RUNNING	0	/* A run is scheduled or in progress */
+
+/*
+ * nss_bench_now_ns()
+ */
+static inline uint64_t nss_bench_now_ns(void)
+{
+	return ktime_to_ns(ktime_get());
+}
+
+/*
+ * nss_bench_params_valid()
+ *	Check the module parameters describe a frame that can be built
+ */
+static bool nss_bench_params_valid(void)
+{
+	if (packets < 0) {
+		pr_warn("qca-nss-bench: packets %d is negative\n", packets);
+		return false;
+	}
+
+	if (pkt_size < NSS_BENCH_HEAD_MIN || pkt_size > NSS_BENCH_PKT_SIZE_MAX) {
+		pr_warn("qca-nss-bench: pkt_size %d not in [%d, %d]\n", pkt_size, NSS_BENCH_HEAD_MIN, NSS_BENCH_PKT_SIZE_MAX);
+		return false;
+	}
+
+	/*
+	 * Each frag_list segment carries at least one byte beyond the head
+	 */
+	if (frag_segs < 1 || frag_segs > NSS_BENCH_FRAG_SEGS_MAX || frag_segs - 1 > pkt_size - NSS_BENCH_HEAD_MIN) {
+		pr_warn("qca-nss-bench: frag_segs %d not valid for pkt_size %d\n", frag_segs, pkt_size);
+		return false;
+	}
+
+	if (gso_size < 0 || gso_size > pkt_size - ETH_HLEN) {
+		pr_warn("qca-nss-bench: gso_size %d not in [0, %d]\n", gso_size, pkt_size - ETH_HLEN);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * nss_bench_rx()
+ *	Data callback of the benchmark virtual interface
+ */
+static void nss_bench_rx(struct net_device *netdev, struct sk_buff *skb, struct napi_struct *napi)
+{
+	struct nss_bench_hdr *hdr;
+	uint64_t lat, max;
+	int bucket;
+
+	if (skb_linearize(skb) || skb->len < ETH_HLEN + sizeof(*hdr)) {
+		goto done;
+	}
+
+	hdr = (struct nss_bench_hdr *)(skb->data + ETH_HLEN);
+	if (hdr->magic != NSS_BENCH_MAGIC) {
+		hdr = (struct nss_bench_hdr *)skb->data;
+		if (hdr->magic != NSS_BENCH_MAGIC) {
+			goto done;
+		}
+	}
+
+	lat = nss_bench_now_ns() - hdr->tx_ns;
+	bucket = lat ? fls64(lat) - 1 : 0;
+	if (bucket >= NSS_BENCH_LAT_BUCKETS) {
+		bucket = NSS_BENCH_LAT_BUCKETS - 1;
+	}
+
+	atomic64_inc(&nss_bench_res.received);
+	atomic64_inc(&nss_bench_res.lat_hist[bucket]);
+
+	max = atomic64_read(&nss_bench_res.lat_max_ns);
+	while (lat > max) {
+		uint64_t old = atomic64_cmpxchg(&nss_bench_res.lat_max_ns, max, lat);
+		if (old == max) {
+			break;
+		}
+		max = old;
+	}
+
+done:
+	dev_kfree_skb_any(skb);
+}
+
+/*
+ * nss_bench_alloc()
+ *	Build one benchmark frame
+ */
+static struct sk_buff *nss_bench_alloc(uint32_t seq)
+{
+	struct sk_buff *skb, *seg, *prev = NULL;
+	struct nss_bench_hdr *hdr;
+	struct ethhdr *eth;
+	int segs = nss_bench_cfg.frag_segs;
+	int len = nss_bench_cfg.pkt_size;
+	int seg_len = 0;
+	int head_len;
+	int i;
+
+	/*
+	 * The head holds the Ethernet and benchmark headers; only what is
+	 * beyond them is spread over the frag_list segments, any remainder
+	 * staying in the head.
+	 */
+	if (segs > 1) {
+		seg_len = (len - NSS_BENCH_HEAD_MIN) / (segs - 1);
+	}
+
+	head_len = len - (seg_len * (segs - 1));
+
+	skb = dev_alloc_skb(head_len);
+	if (!skb) {
+		return NULL;
+	}
+
+	eth = (struct ethhdr *)skb_put(skb, head_len);
+	memset(eth, 0, skb->len);
+	memcpy(eth->h_dest, nss_bench_dev->dev_addr, ETH_ALEN);
+	memcpy(eth->h_source, nss_bench_dev->dev_addr, ETH_ALEN);
+	eth->h_proto = htons(NSS_BENCH_ETHERTYPE);
+
+	/*
+	 * The remaining segments are chained on the frag_list.
+	 */
+	for (i = 1; i < segs; i++) {
+		seg = dev_alloc_skb(seg_len);
+		if (!seg) {
+			dev_kfree_skb_any(skb);
+			return NULL;
+		}
+
+		memset(skb_put(seg, seg_len), 0, seg_len);
+		if (prev) {
+			prev->next = seg;
+		} else {
+			skb_shinfo(skb)->frag_list = seg;
+		}
+
+		prev = seg;
+		skb->len += seg_len;
+		skb->data_len += seg_len;
+		skb->truesize += seg->truesize;
+	}
+
+	/*
+	 * The frames carry no IP header, so no protocol GSO type applies; the
+	 * NSS only takes gso_size as the MSS.
+	 */
+	if (nss_bench_cfg.gso_size) {
+		skb_shinfo(skb)->gso_size = nss_bench_cfg.gso_size;
+		skb_shinfo(skb)->gso_type = SKB_GSO_DODGY;
+		skb_shinfo(skb)->gso_segs = DIV_ROUND_UP(len - ETH_HLEN, nss_bench_cfg.gso_size);
+	}
+
+	skb->dev = nss_bench_dev;
+	hdr = (struct nss_bench_hdr *)(eth + 1);
+	hdr->magic = NSS_BENCH_MAGIC;
+	hdr->seq = seq;
+	hdr->tx_ns = nss_bench_now_ns();
+
+	return skb;
+}
+
+/*
+ * nss_bench_run()
+ *	Send loop
+ */
+static void nss_bench_run(struct work_struct *work)
+{
+	struct sk_buff *skb;
+	nss_tx_status_t status;
+	cycles_t c0;
+	uint64_t start;
+	int i, retries;
+
+	memset(&nss_bench_res, 0, sizeof(nss_bench_res));
+	start = nss_bench_now_ns();
+
+	for (i = 0; i < nss_bench_cfg.packets; i++) {
+		skb = nss_bench_alloc(i);
+		if (!skb) {
+			nss_bench_res.alloc_fails++;
+			continue;
+		}
+
+		retries = 0;
+		do {
+			c0 = get_cycles();
+			status = nss_virt_if_tx_buf(nss_bench_handle, skb);
+			nss_bench_res.tx_cycles += get_cycles() - c0;
+
+			if (status != NSS_TX_FAILURE_QUEUE) {
+				break;
+			}
+
+			nss_bench_res.queue_full++;
+			cpu_relax();
+		} while (++retries < NSS_BENCH_QFULL_RETRIES);
+
+		if (status != NSS_TX_SUCCESS) {
+			nss_bench_res.tx_errors++;
+			dev_kfree_skb_any(skb);
+			continue;
+		}
+
+		nss_bench_res.sent++;
+
+		if (!(i & 0xff)) {
+			cond_resched();
+		}
+	}
+
+	nss_bench_res.elapsed_ns = nss_bench_now_ns() - start;
+
+	/*
+	 * Let the stragglers come back before the results are read
+	 */
+	msleep(100);
+	clear_bit(NSS_BENCH_FLAG_RUNNING, &nss_bench_flags);
+}
+
+/*
+ * nss_bench_percentile()
+ *	Upper bound (ns) of the latency bucket holding the given per-mille
+ */
+static uint64_t nss_bench_percentile(uint64_t total, uint32_t per_mille)
+{
+	uint64_t want = div_u64(total * per_mille + 999, 1000);
+	uint64_t seen = 0;
+	int i;
+
+	for (i = 0; i < NSS_BENCH_LAT_BUCKETS; i++) {
+		seen += atomic64_read(&nss_bench_res.lat_hist[i]);
+		if (seen >= want) {
+			return 2ULL << i;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * nss_bench_run_read()
+ *	Report the last run
+ */
+static ssize_t nss_bench_run_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_bench_result *r = &nss_bench_res;
+	uint64_t received = atomic64_read(&r->received);
+	uint64_t attempts = r->sent + r->tx_errors + r->queue_full;
+	size_t size_al = 1024;
+	size_t size_wr = 0;
+	ssize_t bytes_read;
+	char *lbuf;
+
+	lbuf = kzalloc(size_al, GFP_KERNEL);
+	if (!lbuf) {
+		return 0;
+	}
+
+	if (test_bit(NSS_BENCH_FLAG_RUNNING, &nss_bench_flags)) {
+		size_wr = scnprintf(lbuf, size_al, "running\n");
+		goto done;
+	}
+
+	size_wr = scnprintf(lbuf, size_al,
+			"params: packets = %d pkt_size = %d frag_segs = %d gso_size = %d\n"
+			"sent = %llu tx_errors = %llu queue_full = %llu alloc_fails = %llu received = %llu\n"
+			"elapsed_ns = %llu pps = %llu cycles_per_pkt = %llu queue_full_per_sec = %llu\n",
+			nss_bench_cfg.packets, nss_bench_cfg.pkt_size, nss_bench_cfg.frag_segs, nss_bench_cfg.gso_size,
+			r->sent, r->tx_errors, r->queue_full, r->alloc_fails, received,
+			r->elapsed_ns,
+			r->elapsed_ns ? div64_u64(r->sent * NSEC_PER_SEC, r->elapsed_ns) : 0,
+			attempts ? div64_u64(r->tx_cycles, attempts) : 0,
+			r->elapsed_ns ? div64_u64(r->queue_full * NSEC_PER_SEC, r->elapsed_ns) : 0);
+
+	if (received) {
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"latency_ns: p50 < %llu p90 < %llu p99 < %llu p999 < %llu max = %llu\n",
+				nss_bench_percentile(received, 500), nss_bench_percentile(received, 900),
+				nss_bench_percentile(received, 990), nss_bench_percentile(received, 999),
+				(uint64_t)atomic64_read(&r->lat_max_ns));
+	}
+
+done:
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	kfree(lbuf);
+	return bytes_read;
+}
+
+/*
+ * nss_bench_run_write()
+ *	Start a run
+ *
+ * The parameters are checked and copied here, so writes to them while a
+ * run is in progress do not change the frames it builds.
+ */
+static ssize_t nss_bench_run_write(struct file *fp, const char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	if (test_and_set_bit(NSS_BENCH_FLAG_RUNNING, &nss_bench_flags)) {
+		return -EBUSY;
+	}
+
+	if (!nss_bench_params_valid()) {
+		clear_bit(NSS_BENCH_FLAG_RUNNING, &nss_bench_flags);
+		return -EINVAL;
+	}
+
+	nss_bench_cfg.packets = packets;
+	nss_bench_cfg.pkt_size = pkt_size;
+	nss_bench_cfg.frag_segs = frag_segs;
+	nss_bench_cfg.gso_size = gso_size;
+
+	schedule_work(&nss_bench_work);
+	return sz;
+}
+
+static const struct file_operations nss_bench_run_ops = {
+	.read = nss_bench_run_read,
+	.write = nss_bench_run_write,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_bench_xmit()
+ *	The benchmark netdevice is never used for Linux transmit
+ */
+static netdev_tx_t nss_bench_xmit(struct sk_buff *skb, struct net_device *dev)
+{
+	dev_kfree_skb_any(skb);
+	return NETDEV_TX_OK;
+}
+
+static const struct net_device_ops nss_bench_netdev_ops = {
+	.ndo_start_xmit = nss_bench_xmit,
+};
+
+/*
+ * nss_bench_init()
+ */
+static int __init nss_bench_init(void)
+{
+	int ret;
+
+	if (!nss_bench_params_valid()) {
+		return -EINVAL;
+	}
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 17, 0))
+	nss_bench_dev = alloc_netdev(0, "nssbench%d", ether_setup);
+#else
+	nss_bench_dev = alloc_netdev(0, "nssbench%d", NET_NAME_UNKNOWN, ether_setup);
+#endif
+	if (!nss_bench_dev) {
+		return -ENOMEM;
+	}
+
+	nss_bench_dev->netdev_ops = &nss_bench_netdev_ops;
+	random_ether_addr(nss_bench_dev->dev_addr);
+
+	ret = register_netdev(nss_bench_dev);
+	if (ret) {
+		free_netdev(nss_bench_dev);
+		return ret;
+	}
+
+	nss_bench_handle = nss_virt_if_create_sync(nss_bench_dev);
+	if (!nss_bench_handle) {
+		pr_warn("qca-nss-bench: unable to create virtual interface\n");
+		unregister_netdev(nss_bench_dev);
+		free_netdev(nss_bench_dev);
+		return -ENODEV;
+	}
+
+	nss_virt_if_register(nss_bench_handle, nss_bench_rx, nss_bench_dev);
+	INIT_WORK(&nss_bench_work, nss_bench_run);
+
+	nss_bench_dentry = debugfs_create_dir("qca-nss-bench", NULL);
+	if (nss_bench_dentry) {
+		debugfs_create_file("run", 0600, nss_bench_dentry, NULL, &nss_bench_run_ops);
+	}
+
+	return 0;
+}
+
+/*
+ * nss_bench_exit()
+ */
+static void __exit nss_bench_exit(void)
+{
+	debugfs_remove_recursive(nss_bench_dentry);
+	cancel_work_sync(&nss_bench_work);
+
+	nss_virt_if_unregister(nss_bench_handle);
+	if (nss_virt_if_destroy_sync(nss_bench_handle) != NSS_TX_SUCCESS) {
+		pr_warn("qca-nss-bench: unable to destroy virtual interface\n");
+	}
+
+	unregister_netdev(nss_bench_dev);
+	free_netdev(nss_bench_dev);
+}
+
+module_init(nss_bench_init);
+module_exit(nss_bench_exit);
+
+MODULE_DESCRIPTION("QCA NSS host data path benchmark");
+MODULE_LICENSE("Dual BSD/GPL");
@@ -402,6 +402,15 @@ bool nss_capwap_get_stats(uint32_t if_num, struct nss_capwap_tunnel_stats *stats
 }
 EXPORT_SYMBOL(nss_capwap_get_stats);
 
+/*
+ * nss_capwap_get_if_ctx()
+ *	Context of the core a CAPWAP tunnel was placed on
+ */
+static inline struct nss_ctx_instance *nss_capwap_get_if_ctx(uint32_t if_num)
+{
+	return nss_dynamic_interface_get_nss_ctx(if_num, NSS_DYNAMIC_INTERFACE_TYPE_CAPWAP);
+}
+
 /*
  * nss_capwap_notify_register()
  *	Registers a message notifier with NSS FW. It should not be called from
@@ -411,7 +420,7 @@ struct nss_ctx_instance *nss_capwap_notify_register(uint32_t if_num, nss_capwap_
 {
 	struct nss_ctx_instance *nss_ctx;
 
-	nss_ctx = &nss_top_main.nss[nss_top_main.capwap_handler_id];
+	nss_ctx = nss_capwap_get_if_ctx(if_num);
 
 	if (nss_capwap_verify_if_num(if_num) == false) {
 		nss_warning("%p: notfiy register received for invalid interface %d", nss_ctx, if_num);
@@ -485,7 +494,7 @@ struct nss_ctx_instance *nss_capwap_data_register(uint32_t if_num, nss_capwap_bu
 	struct nss_ctx_instance *nss_ctx;
 	int core_status;
 
-	nss_ctx = nss_capwap_get_ctx();
+	nss_ctx = nss_capwap_get_if_ctx(if_num);
 	if (nss_capwap_verify_if_num(if_num) == false) {
 		nss_warning("%p: data register received for invalid interface %d", nss_ctx, if_num);
 		return NULL;
@@ -527,7 +536,7 @@ bool nss_capwap_data_unregister(uint32_t if_num)
 	struct nss_ctx_instance *nss_ctx;
 	struct nss_capwap_handle *h;
 
-	nss_ctx = nss_capwap_get_ctx();
+	nss_ctx = nss_capwap_get_if_ctx(if_num);
 	if (nss_capwap_verify_if_num(if_num) == false) {
 		nss_warning("%p: data unregister received for invalid interface %d", nss_ctx, if_num);
 		return false;
@@ -561,23 +570,23 @@ EXPORT_SYMBOL(nss_capwap_data_unregister);
 /*
  * nss_capwap_get_ctx()
  *	Return a CAPWAP NSS context.
+ *
+ * This is the default core of CAPWAP; a tunnel may have been placed on
+ * another core, see nss_dynamic_interface_get_nss_ctx().
  */
 struct nss_ctx_instance *nss_capwap_get_ctx()
 {
-	struct nss_ctx_instance *nss_ctx;
-
-	nss_ctx = &nss_top_main.nss[nss_top_main.capwap_handler_id];
-	return nss_ctx;
+	return nss_dynamic_interface_get_nss_ctx(-1, NSS_DYNAMIC_INTERFACE_TYPE_CAPWAP);
 }
 EXPORT_SYMBOL(nss_capwap_get_ctx);
 
 /*
  * nss_capwap_ifnum_with_core_id()
- *	Append core id to capwap interface num
+ *	Append the id of the core the tunnel was placed on to capwap interface num
  */
 int nss_capwap_ifnum_with_core_id(int if_num)
 {
-	struct nss_ctx_instance *nss_ctx = nss_capwap_get_ctx();
+	struct nss_ctx_instance *nss_ctx = nss_capwap_get_if_ctx(if_num);
 
 	NSS_VERIFY_CTX_MAGIC(nss_ctx);
 	if (nss_is_dynamic_interface(if_num) == false) {
@@ -0,0 +1,605 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_conn_sync.c
+ *	NSS host driven connection stats pull engine
+ *
+ * Walks the IPv4 and IPv6 connection tables of the firmware one page at a
+ * time using the CONN_STATS_SYNC_MANY messages. The records in each
+ * response are folded into the driver statistics by the regular IPv4/IPv6
+ * message handlers; this engine only paces the requests.
+ *
+ * The firmware keeps pushing its own periodic syncs and has no message to
+ * turn them off, so the engine only adds requests when those are not enough:
+ * while the measured per-connection sync lag stays within target_age_ms the
+ * page interval backs off towards max_interval_ms. Once the lag exceeds the
+ * target, the interval is chosen so that a full walk of the active
+ * connections takes about target_age_ms, shortened further in proportion to
+ * the excess. The lag is measured on the host for every connection sync
+ * (pushed or pulled) with a small direct mapped table of last sync times.
+ *
+ * Every request carries a generation number in its app_data; a response
+ * whose generation is not the outstanding one is stale and ignored.
+ */
+#include <linux/sysctl.h>
+#include <linux/jhash.h>
+#include "nss_tx_rx_common.h"
+
+#define NSS_CONN_SYNC_PAGE_SIZE		PAGE_SIZE	/* Response buffer size per request */
+#define NSS_CONN_SYNC_TIMEOUT_MS	1000		/* Give up on a response after this long */
+#define NSS_CONN_SYNC_LAG_TABLE_BITS	13
+#define NSS_CONN_SYNC_LAG_TABLE_SIZE	(1 << NSS_CONN_SYNC_LAG_TABLE_BITS)
+#define NSS_CONN_SYNC_LAG_TABLE_MASK	(NSS_CONN_SYNC_LAG_TABLE_SIZE - 1)
+#define NSS_CONN_SYNC_LAG_BUCKETS	7
+
+/*
+ * Upper bounds (ms) of the sync lag histogram buckets; the last bucket is open ended.
+ */
+static const uint32_t nss_conn_sync_lag_bounds[NSS_CONN_SYNC_LAG_BUCKETS - 1] = {
+	100, 250, 500, 1000, 2000, 5000
+};
+
+static int8_t *nss_conn_sync_lag_str[NSS_CONN_SYNC_LAG_BUCKETS] = {
+	"lag_lt_100ms",
+	"lag_lt_250ms",
+	"lag_lt_500ms",
+	"lag_lt_1s",
+	"lag_lt_2s",
+	"lag_lt_5s",
+	"lag_ge_5s",
+};
+
+/*
+ * nss_conn_sync_lag_slot
+ *	Last sync time of a connection, tagged with the full hash of its tuple
+ */
+struct nss_conn_sync_lag_slot {
+	uint32_t tag;			/* Tuple hash */
+	unsigned long last;		/* Jiffies of the last sync */
+};
+
+/*
+ * nss_conn_sync_engine
+ *	Pull state of one IP version
+ */
+struct nss_conn_sync_engine {
+	spinlock_t lock;			/* Protects the state below */
+	struct delayed_work dwork;		/* Page request work */
+	uint32_t version;			/* 4 or 6 */
+	bool running;				/* Work is scheduled */
+	bool in_flight;				/* A page request is outstanding */
+	unsigned long sent;			/* Jiffies the outstanding request was sent */
+	uint16_t index;				/* Next connection index to request */
+	uint32_t gen;				/* Generation of the outstanding request */
+	unsigned long round_start;		/* Jiffies the current walk started */
+	uint32_t round_conns;			/* Records received in the current walk */
+	uint32_t round_pages;			/* Pages requested in the current walk */
+	uint32_t active_conns;			/* Records received in the last complete walk */
+	uint32_t pages;				/* Pages needed by the last complete walk */
+	uint32_t last_round_ms;			/* Duration of the last complete walk */
+	uint32_t interval_ms;			/* Current delay between page requests */
+
+	uint64_t requests;			/* Page requests sent */
+	uint64_t responses;			/* Page responses received */
+	uint64_t records;			/* Connection records received */
+	uint64_t tx_fails;			/* Page requests that could not be sent */
+	uint64_t nacks;				/* Page requests nacked by the firmware */
+	uint64_t timeouts;			/* Page requests that were never answered */
+	uint64_t stale;				/* Responses to requests that already timed out */
+	uint64_t rounds;			/* Complete walks */
+
+	struct nss_conn_sync_lag_slot *lag_table;	/* Last sync time per connection */
+	uint64_t lag_hist[NSS_CONN_SYNC_LAG_BUCKETS];	/* Sync lag histogram */
+	uint32_t lag_avg_ms;				/* Moving average of the sync lag */
+	uint32_t lag_max_ms;				/* Worst sync lag seen */
+};
+
+static struct nss_conn_sync_engine nss_conn_sync_ipv4 = { .version = 4 };
+static struct nss_conn_sync_engine nss_conn_sync_ipv6 = { .version = 6 };
+
+int nss_conn_sync_enable __read_mostly = 0;
+static int nss_conn_sync_target_age_ms = 1000;
+static int nss_conn_sync_min_interval_ms = 5;
+static int nss_conn_sync_max_interval_ms = 1000;
+
+static struct dentry *nss_conn_sync_dentry;
+
+/*
+ * nss_conn_sync_lag_update()
+ *	Account the sync lag of one connection
+ */
+static void nss_conn_sync_lag_update(struct nss_conn_sync_engine *nse, uint32_t hash)
+{
+	struct nss_conn_sync_lag_slot *slot;
+	unsigned long now = jiffies;
+	uint32_t lag_ms;
+	int i;
+
+	spin_lock_bh(&nse->lock);
+	if (unlikely(!nse->lag_table)) {
+		spin_unlock_bh(&nse->lock);
+		return;
+	}
+
+	slot = &nse->lag_table[hash & NSS_CONN_SYNC_LAG_TABLE_MASK];
+	if (slot->tag == hash && slot->last) {
+		lag_ms = jiffies_to_msecs(now - slot->last);
+
+		for (i = 0; i < NSS_CONN_SYNC_LAG_BUCKETS - 1; i++) {
+			if (lag_ms < nss_conn_sync_lag_bounds[i]) {
+				break;
+			}
+		}
+		nse->lag_hist[i]++;
+
+		if (lag_ms > nse->lag_max_ms) {
+			nse->lag_max_ms = lag_ms;
+		}
+
+		/*
+		 * avg += (lag - avg) / 16
+		 */
+		nse->lag_avg_ms = nse->lag_avg_ms - (nse->lag_avg_ms >> 4) + (lag_ms >> 4);
+	}
+
+	slot->tag = hash;
+	slot->last = now;
+	spin_unlock_bh(&nse->lock);
+}
+
+/*
+ * nss_conn_sync_ipv4_record()
+ *	Called for every IPv4 connection sync record
+ */
+void nss_conn_sync_ipv4_record(struct nss_ipv4_conn_sync *nirs)
+{
+	uint32_t hash = jhash_3words(nirs->flow_ip, nirs->return_ip,
+				(nirs->flow_ident << 16) ^ nirs->return_ident, nirs->protocol);
+
+	nss_conn_sync_lag_update(&nss_conn_sync_ipv4, hash);
+}
+
+/*
+ * nss_conn_sync_ipv6_record()
+ *	Called for every IPv6 connection sync record
+ */
+void nss_conn_sync_ipv6_record(struct nss_ipv6_conn_sync *nics)
+{
+	uint32_t hash = jhash2(nics->flow_ip, 4, nics->protocol);
+
+	hash = jhash2(nics->return_ip, 4, hash);
+	hash = jhash_2words(nics->flow_ident, nics->return_ident, hash);
+
+	nss_conn_sync_lag_update(&nss_conn_sync_ipv6, hash);
+}
+
+/*
+ * nss_conn_sync_adapt()
+ *	Choose the page interval for the next walk. Called with the engine lock held.
+ */
+static void nss_conn_sync_adapt(struct nss_conn_sync_engine *nse)
+{
+	uint32_t target = nss_conn_sync_target_age_ms;
+	uint32_t interval;
+
+	if (!nse->active_conns) {
+		nse->interval_ms = nss_conn_sync_max_interval_ms;
+		return;
+	}
+
+	/*
+	 * The pushed syncs keep connections fresh enough; back off so the
+	 * engine does not add load on top of them.
+	 */
+	if (nse->lag_avg_ms <= target) {
+		interval = nse->interval_ms * 2;
+	} else {
+		/*
+		 * Spread one walk over the target age and, as connections are
+		 * older than wanted, speed up proportionally.
+		 */
+		interval = target / (nse->pages ? nse->pages : 1);
+		interval = (interval * target) / nse->lag_avg_ms;
+	}
+
+	if (interval < nss_conn_sync_min_interval_ms) {
+		interval = nss_conn_sync_min_interval_ms;
+	} else if (interval > nss_conn_sync_max_interval_ms) {
+		interval = nss_conn_sync_max_interval_ms;
+	}
+
+	nse->interval_ms = interval;
+}
+
+/*
+ * nss_conn_sync_response()
+ *	Handle a SYNC_MANY response. The records were already consumed by the IPv4/IPv6 handler.
+ */
+static void nss_conn_sync_response(struct nss_conn_sync_engine *nse, uint32_t gen, enum nss_cmn_response response,
+					uint16_t index, uint16_t next, uint16_t count)
+{
+	spin_lock_bh(&nse->lock);
+	if (!nse->in_flight || gen != nse->gen || index != nse->index) {
+		/*
+		 * Late response to a request that already timed out
+		 */
+		nse->stale++;
+		spin_unlock_bh(&nse->lock);
+		return;
+	}
+
+	nse->in_flight = false;
+
+	if (response != NSS_CMN_RESPONSE_ACK) {
+		nse->nacks++;
+		spin_unlock_bh(&nse->lock);
+		return;
+	}
+
+	nse->responses++;
+	nse->records += count;
+	nse->round_conns += count;
+
+	/*
+	 * The firmware wraps next back to zero (or below the requested index)
+	 * once the end of its connection table is reached.
+	 */
+	if (next == 0 || next <= index) {
+		nse->rounds++;
+		nse->active_conns = nse->round_conns;
+		nse->pages = nse->round_pages;
+		nse->last_round_ms = jiffies_to_msecs(jiffies - nse->round_start);
+		nse->round_conns = 0;
+		nse->round_pages = 0;
+		nse->index = 0;
+		nss_conn_sync_adapt(nse);
+	} else {
+		nse->index = next;
+	}
+
+	spin_unlock_bh(&nse->lock);
+}
+
+/*
+ * nss_conn_sync_ipv4_callback()
+ */
+static void nss_conn_sync_ipv4_callback(void *app_data, struct nss_ipv4_msg *nim)
+{
+	struct nss_ipv4_conn_sync_many_msg *nicsm = &nim->msg.conn_stats_many;
+
+	nss_conn_sync_response(&nss_conn_sync_ipv4, (uint32_t)(unsigned long)app_data, nim->cm.response, nicsm->index, nicsm->next, nicsm->count);
+}
+
+/*
+ * nss_conn_sync_ipv6_callback()
+ */
+static void nss_conn_sync_ipv6_callback(void *app_data, struct nss_ipv6_msg *nim)
+{
+	struct nss_ipv6_conn_sync_many_msg *nicsm = &nim->msg.conn_stats_many;
+
+	nss_conn_sync_response(&nss_conn_sync_ipv6, (uint32_t)(unsigned long)app_data, nim->cm.response, nicsm->index, nicsm->next, nicsm->count);
+}
+
+/*
+ * nss_conn_sync_request()
+ *	Send a SYNC_MANY request for the given index, tagged with its generation
+ */
+static nss_tx_status_t nss_conn_sync_request(struct nss_conn_sync_engine *nse, uint16_t index, uint32_t gen)
+{
+	if (nse->version == 4) {
+		struct nss_ipv4_msg nim;
+
+		memset(&nim, 0, sizeof(nim));
+		nss_ipv4_msg_init(&nim, NSS_IPV4_RX_INTERFACE, NSS_IPV4_TX_CONN_STATS_SYNC_MANY_MSG,
+				sizeof(struct nss_ipv4_conn_sync_many_msg), nss_conn_sync_ipv4_callback, (void *)(unsigned long)gen);
+		nim.msg.conn_stats_many.index = index;
+		nim.msg.conn_stats_many.size = NSS_CONN_SYNC_PAGE_SIZE;
+		return nss_ipv4_tx_with_size(nss_ipv4_get_mgr(), &nim, NSS_CONN_SYNC_PAGE_SIZE);
+	} else {
+		struct nss_ipv6_msg nim;
+
+		memset(&nim, 0, sizeof(nim));
+		nss_ipv6_msg_init(&nim, NSS_IPV6_RX_INTERFACE, NSS_IPV6_TX_CONN_STATS_SYNC_MANY_MSG,
+				sizeof(struct nss_ipv6_conn_sync_many_msg), nss_conn_sync_ipv6_callback, (void *)(unsigned long)gen);
+		nim.msg.conn_stats_many.index = index;
+		nim.msg.conn_stats_many.size = NSS_CONN_SYNC_PAGE_SIZE;
+		return nss_ipv6_tx_with_size(nss_ipv6_get_mgr(), &nim, NSS_CONN_SYNC_PAGE_SIZE);
+	}
+}
+
+/*
+ * nss_conn_sync_work()
+ *	Request the next page, then re-arm after the current interval
+ */
+static void nss_conn_sync_work(struct work_struct *work)
+{
+	struct nss_conn_sync_engine *nse = container_of(to_delayed_work(work), struct nss_conn_sync_engine, dwork);
+	uint32_t delay, gen;
+	uint16_t index;
+
+	spin_lock_bh(&nse->lock);
+	if (!nse->running) {
+		spin_unlock_bh(&nse->lock);
+		return;
+	}
+
+	if (nse->in_flight) {
+		if (time_before(jiffies, nse->sent + msecs_to_jiffies(NSS_CONN_SYNC_TIMEOUT_MS))) {
+			goto rearm;
+		}
+
+		/*
+		 * Lost response; restart the walk
+		 */
+		nse->timeouts++;
+		nse->in_flight = false;
+		nse->index = 0;
+		nse->round_conns = 0;
+		nse->round_pages = 0;
+	}
+
+	if (nse->index == 0 && nse->round_pages == 0) {
+		nse->round_start = jiffies;
+	}
+
+	index = nse->index;
+	gen = ++nse->gen;
+	nse->in_flight = true;
+	nse->sent = jiffies;
+	nse->round_pages++;
+	nse->requests++;
+	spin_unlock_bh(&nse->lock);
+
+	if (nss_conn_sync_request(nse, index, gen) != NSS_TX_SUCCESS) {
+		spin_lock_bh(&nse->lock);
+		nse->tx_fails++;
+		nse->requests--;
+		nse->round_pages--;
+		nse->in_flight = false;
+		delay = nss_conn_sync_max_interval_ms;
+		goto requeue;
+	}
+
+	spin_lock_bh(&nse->lock);
+rearm:
+	delay = nse->interval_ms;
+requeue:
+	if (nse->running) {
+		schedule_delayed_work(&nse->dwork, msecs_to_jiffies(delay));
+	}
+	spin_unlock_bh(&nse->lock);
+}
+
+/*
+ * nss_conn_sync_start()
+ *	Start pulling stats for one IP version
+ */
+static void nss_conn_sync_start(struct nss_conn_sync_engine *nse)
+{
+	struct nss_conn_sync_lag_slot *table;
+
+	table = vzalloc(sizeof(struct nss_conn_sync_lag_slot) * NSS_CONN_SYNC_LAG_TABLE_SIZE);
+	if (!table) {
+		nss_warning("%u: unable to allocate the conn sync lag table", nse->version);
+		return;
+	}
+
+	spin_lock_bh(&nse->lock);
+	if (nse->running) {
+		spin_unlock_bh(&nse->lock);
+		vfree(table);
+		return;
+	}
+
+	nse->lag_table = table;
+	nse->running = true;
+	nse->in_flight = false;
+	nse->index = 0;
+	nse->round_conns = 0;
+	nse->round_pages = 0;
+	nse->interval_ms = nss_conn_sync_min_interval_ms;
+	schedule_delayed_work(&nse->dwork, 0);
+	spin_unlock_bh(&nse->lock);
+}
+
+/*
+ * nss_conn_sync_stop()
+ *	Stop pulling stats for one IP version
+ */
+static void nss_conn_sync_stop(struct nss_conn_sync_engine *nse)
+{
+	struct nss_conn_sync_lag_slot *table;
+
+	spin_lock_bh(&nse->lock);
+	nse->running = false;
+	spin_unlock_bh(&nse->lock);
+
+	cancel_delayed_work_sync(&nse->dwork);
+
+	spin_lock_bh(&nse->lock);
+	table = nse->lag_table;
+	nse->lag_table = NULL;
+	nse->in_flight = false;
+	spin_unlock_bh(&nse->lock);
+
+	vfree(table);
+}
+
+/*
+ * nss_conn_sync_engine_print()
+ *	Print the state of one engine
+ */
+static size_t nss_conn_sync_engine_print(struct nss_conn_sync_engine *nse, char *lbuf, size_t size_al)
+{
+	size_t size_wr;
+	int i;
+
+	spin_lock_bh(&nse->lock);
+	size_wr = scnprintf(lbuf, size_al, "ipv%u conn sync:\n", nse->version);
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+			"running = %u\nactive_conns = %u\npages = %u\nlast_round_ms = %u\ninterval_ms = %u\n",
+			nse->running, nse->active_conns, nse->pages, nse->last_round_ms, nse->interval_ms);
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+			"requests = %llu\nresponses = %llu\nrecords = %llu\ntx_fails = %llu\nnacks = %llu\n"
+			"timeouts = %llu\nstale = %llu\nrounds = %llu\n",
+			nse->requests, nse->responses, nse->records, nse->tx_fails, nse->nacks, nse->timeouts,
+			nse->stale, nse->rounds);
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "lag_avg_ms = %u\nlag_max_ms = %u\n",
+			nse->lag_avg_ms, nse->lag_max_ms);
+
+	for (i = 0; i < NSS_CONN_SYNC_LAG_BUCKETS; i++) {
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%s = %llu\n",
+				nss_conn_sync_lag_str[i], nse->lag_hist[i]);
+	}
+
+	spin_unlock_bh(&nse->lock);
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+	return size_wr;
+}
+
+/*
+ * nss_conn_sync_stats_read()
+ *	Read the pull engine statistics
+ */
+static ssize_t nss_conn_sync_stats_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	size_t size_al = 2048;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	char *lbuf;
+
+	lbuf = kzalloc(size_al, GFP_KERNEL);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	size_wr = nss_conn_sync_engine_print(&nss_conn_sync_ipv4, lbuf, size_al);
+	size_wr += nss_conn_sync_engine_print(&nss_conn_sync_ipv6, lbuf + size_wr, size_al - size_wr);
+
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	kfree(lbuf);
+
+	return bytes_read;
+}
+
+static const struct file_operations nss_conn_sync_stats_ops = {
+	.read = nss_conn_sync_stats_read,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_conn_sync_enable_handler()
+ *	Start/stop the pull engine
+ */
+static int nss_conn_sync_enable_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	int ret;
+
+	ret = proc_dointvec(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		return ret;
+	}
+
+	if (nss_conn_sync_enable) {
+		nss_conn_sync_start(&nss_conn_sync_ipv4);
+		nss_conn_sync_start(&nss_conn_sync_ipv6);
+		return 0;
+	}
+
+	nss_conn_sync_stop(&nss_conn_sync_ipv4);
+	nss_conn_sync_stop(&nss_conn_sync_ipv6);
+	return 0;
+}
+
+static int nss_conn_sync_ms_min = 1;
+static int nss_conn_sync_ms_max = 60000;
+
+/*
+ * nss_conn_sync_table
+ *	dev/nss/conn_sync, registered with the driver sysctl tree in nss_init.c
+ */
+struct ctl_table nss_conn_sync_table[] = {
+	{
+		.procname		= "enable",
+		.data			= &nss_conn_sync_enable,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &nss_conn_sync_enable_handler,
+	},
+	{
+		.procname		= "target_age_ms",
+		.data			= &nss_conn_sync_target_age_ms,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec_minmax,
+		.extra1			= &nss_conn_sync_ms_min,
+		.extra2			= &nss_conn_sync_ms_max,
+	},
+	{
+		.procname		= "min_interval_ms",
+		.data			= &nss_conn_sync_min_interval_ms,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec_minmax,
+		.extra1			= &nss_conn_sync_ms_min,
+		.extra2			= &nss_conn_sync_ms_max,
+	},
+	{
+		.procname		= "max_interval_ms",
+		.data			= &nss_conn_sync_max_interval_ms,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec_minmax,
+		.extra1			= &nss_conn_sync_ms_min,
+		.extra2			= &nss_conn_sync_ms_max,
+	},
+	{ }
+};
+
+/*
+ * nss_conn_sync_init()
+ *	Initialize the pull engine; it stays idle until enabled through sysctl
+ */
+void nss_conn_sync_init(void)
+{
+	spin_lock_init(&nss_conn_sync_ipv4.lock);
+	spin_lock_init(&nss_conn_sync_ipv6.lock);
+	INIT_DELAYED_WORK(&nss_conn_sync_ipv4.dwork, nss_conn_sync_work);
+	INIT_DELAYED_WORK(&nss_conn_sync_ipv6.dwork, nss_conn_sync_work);
+
+	nss_conn_sync_dentry = debugfs_create_file("conn_sync", 0400, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_conn_sync_stats_ops);
+	if (unlikely(nss_conn_sync_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/conn_sync file in debugfs");
+	}
+}
+
+/*
+ * nss_conn_sync_exit()
+ *	Stop the pull engine and release its resources
+ */
+void nss_conn_sync_exit(void)
+{
+	debugfs_remove(nss_conn_sync_dentry);
+	nss_conn_sync_dentry = NULL;
+
+	nss_conn_sync_enable = 0;
+	nss_conn_sync_stop(&nss_conn_sync_ipv4);
+	nss_conn_sync_stop(&nss_conn_sync_ipv6);
+}
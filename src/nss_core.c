@@ -27,7 +27,11 @@
 #include "nss_tx_rx_common.h"
 #include "nss_data_plane.h"
 
+#define CREATE_TRACE_POINTS
+#include "nss_tracepoint.h"
+
 #define NSS_CORE_JUMBO_LINEAR_BUF_SIZE 128
+#define NSS_CORE_VIRT_IF_EGRESS_BUDGET 64	/* Backlog packets sent per interface per NAPI poll */
 
 static int max_ipv4_conn = NSS_DEFAULT_NUM_CONN;
 module_param(max_ipv4_conn, int, S_IRUGO);
@@ -50,18 +54,15 @@ static atomic_t jumbo_mru;
 static atomic_t paged_mode;
 
 /*
- * local structure declarations
+ * Virtual interface egress backlog limit per interface, how long a backlog
+ * may wait for a netdev that takes nothing, and the timer that schedules
+ * NAPI to retry a stalled netdev when no other traffic does
  */
-
-/*
- * NSS Rx per interface callback structure
- */
-struct nss_rx_cb_list {
-	nss_core_rx_callback_t cb;
-	void *app_data;
-};
-
-static struct nss_rx_cb_list nss_rx_interface_handlers[NSS_MAX_NET_INTERFACES];
+int nss_core_virt_if_egress_limit = 256;
+int nss_core_virt_if_egress_max_age_ms = 200;
+int nss_core_napi_stats_enable __read_mostly = 0;
+static void nss_core_virt_if_egress_timer_fn(unsigned long data);
+static DEFINE_TIMER(nss_core_virt_if_egress_timer, nss_core_virt_if_egress_timer_fn, 0, 0);
 
 /*
  * nss_core_max_ipv4_conn_get()
@@ -136,13 +137,13 @@ uint32_t nss_core_register_handler(uint32_t interface, nss_core_rx_callback_t cb
 	/*
 	 * Check if already registered
 	 */
-	if (nss_rx_interface_handlers[interface].cb != NULL) {
+	if (nss_top_main.subsys_dp_register[interface].msg_cb != NULL) {
 		printk("Error - Duplicate Interface CB Registered for interface %d\n", interface);
 		return NSS_CORE_STATUS_FAILURE;
 	}
 
-	nss_rx_interface_handlers[interface].cb = cb;
-	nss_rx_interface_handlers[interface].app_data = app_data;
+	nss_top_main.subsys_dp_register[interface].msg_cb = cb;
+	nss_top_main.subsys_dp_register[interface].msg_app_data = app_data;
 
 	return NSS_CORE_STATUS_SUCCESS;
 }
@@ -157,8 +158,8 @@ uint32_t nss_core_unregister_handler(uint32_t interface)
 		return NSS_CORE_STATUS_FAILURE;
 	}
 
-	nss_rx_interface_handlers[interface].cb = NULL;
-	nss_rx_interface_handlers[interface].app_data = NULL;
+	nss_top_main.subsys_dp_register[interface].msg_cb = NULL;
+	nss_top_main.subsys_dp_register[interface].msg_app_data = NULL;
 
 	return NSS_CORE_STATUS_SUCCESS;
 }
@@ -212,14 +213,23 @@ void nss_core_handle_nss_status_pkt(struct nss_ctx_instance *nss_ctx, struct sk_
 		return;
 	}
 
-	cb = nss_rx_interface_handlers[nss_if].cb;
-	app_data = nss_rx_interface_handlers[nss_if].app_data;
+	cb = nss_ctx->nss_top->subsys_dp_register[nss_if].msg_cb;
+	app_data = nss_ctx->nss_top->subsys_dp_register[nss_if].msg_app_data;
 
 	if (!cb) {
 		nss_warning("%p: Callback not registered for interface %d", nss_ctx, nss_if);
 		return;
 	}
 
+	/*
+	 * Account the round trip before the handler gets to modify the message
+	 */
+	if (unlikely(nss_msg_lat_enable)) {
+		nss_msg_lat_rx(nss_ctx, ncm);
+	}
+
+	trace_nss_msg_rx(nss_ctx->id, ncm);
+
 	cb(nss_ctx, ncm, app_data);
 
 	if (ncm->interface != nss_if) {
@@ -331,60 +341,369 @@ static inline int nss_core_skb_needs_linearize(struct sk_buff *skb, uint32_t fea
 				!(features & NETIF_F_SG)));
 }
 
+/*
+ * nss_core_bounce_batch
+ *	Bounced packets of one list registrant gathered during a queue poll
+ */
+struct nss_core_bounce_batch {
+	struct nss_shaper_bounce_registrant *reg;	/* Registrant of the gathered packets */
+	struct sk_buff_head q;				/* Gathered packets */
+};
+
+/*
+ * nss_core_bounce_batch_flush()
+ *	Hand the gathered bounced packets to their registrant, RCU read lock held
+ */
+static void nss_core_bounce_batch_flush(struct nss_core_bounce_batch *batch)
+{
+	struct nss_shaper_bounce_registrant *reg = batch->reg;
+
+	if (!reg) {
+		return;
+	}
+
+	batch->reg = NULL;
+	if (skb_queue_empty(&batch->q)) {
+		return;
+	}
+
+	reg->bounced_list_callback(reg->app_data, &batch->q);
+
+	/*
+	 * The registrant takes the packets it keeps off the list; any it
+	 * left behind are freed here.
+	 */
+	__skb_queue_purge(&batch->q);
+}
+
 /*
  * nss_core_handle_bounced_pkt()
  * 	Bounced packet is returned from an interface/bridge bounce operation.
  *
- * Return the skb to the registrant.
+ * Return the skb to the registrant. The RCU read lock held across the queue
+ * poll keeps the registrant alive; unregistration waits for it.
  */
 static inline void nss_core_handle_bounced_pkt(struct nss_ctx_instance *nss_ctx,
+						struct nss_core_bounce_batch *batch,
 						struct nss_shaper_bounce_registrant *reg,
 						struct sk_buff *nbuf)
 {
-	void *app_data;
-	struct module *owner;
-	nss_shaper_bounced_callback_t bounced_callback;
-	struct nss_top_instance *nss_top = nss_ctx->nss_top;
-
-	spin_lock_bh(&nss_top->lock);
-
 	/*
 	 * Do we have a registrant?
 	 */
-	if (!reg->registered) {
-		spin_unlock_bh(&nss_top->lock);
+	if (unlikely(!reg)) {
 		dev_kfree_skb_any(nbuf);
 		return;
 	}
 
-	/*
-	 * Get handle to the owning registrant
-	 */
-	bounced_callback = reg->bounced_callback;
-	app_data = reg->app_data;
-	owner = reg->owner;
+	if (!reg->bounced_list_callback) {
+		reg->bounced_callback(reg->app_data, nbuf);
+		return;
+	}
 
 	/*
-	 * Callback is active, unregistration is not permitted while this is in progress
+	 * Gather packets while they keep coming for the same registrant
 	 */
-	reg->callback_active = true;
-	spin_unlock_bh(&nss_top->lock);
-	if (!try_module_get(owner)) {
-		spin_lock_bh(&nss_top->lock);
-		reg->callback_active = false;
-		spin_unlock_bh(&nss_top->lock);
+	if (batch->reg != reg) {
+		nss_core_bounce_batch_flush(batch);
+		batch->reg = reg;
+	}
+
+	__skb_queue_tail(&batch->q, nbuf);
+}
+
+/*
+ * nss_core_virt_if_txq_stopped()
+ *	Whether the netdev transmit queue of the packet is stopped
+ *
+ * Packets are handed to ndo_start_xmit() directly, so the driver uses the
+ * queue mapping the packet already carries.
+ */
+static inline bool nss_core_virt_if_txq_stopped(struct net_device *ndev, struct sk_buff *nbuf)
+{
+	uint16_t qid = skb_get_queue_mapping(nbuf);
+
+	if (unlikely(qid >= ndev->real_num_tx_queues)) {
+		qid = 0;
+	}
+
+	return netif_tx_queue_stopped(netdev_get_tx_queue(ndev, qid));
+}
+
+/*
+ * nss_core_virt_if_egress_drop()
+ *	Free the backlog of a virtual interface, accounting every packet in counter
+ */
+static void nss_core_virt_if_egress_drop(struct nss_virt_if_egress *egress, atomic64_t *counter)
+{
+	struct sk_buff *nbuf;
+
+	while ((nbuf = skb_dequeue(&egress->q)) != NULL) {
+		atomic64_inc(counter);
+		dev_kfree_skb_any(nbuf);
+	}
+}
+
+/*
+ * nss_core_virt_if_egress_queue()
+ *	Queue a virtual interface packet the netdev cannot take right now.
+ *
+ * Tail drop: a packet arriving at a full queue is freed. Cores may queue
+ * for the same interface, so the limit is checked under the queue lock.
+ */
+static void nss_core_virt_if_egress_queue(struct nss_ctx_instance *nss_ctx, unsigned int interface_num,
+						struct nss_virt_if_egress *egress, struct sk_buff *nbuf)
+{
+	unsigned long flags;
+	uint32_t depth;
+
+	spin_lock_irqsave(&egress->q.lock, flags);
+	depth = skb_queue_len(&egress->q);
+	if (unlikely(depth >= nss_core_virt_if_egress_limit)) {
+		spin_unlock_irqrestore(&egress->q.lock, flags);
+		atomic64_inc(&egress->dropped_full);
 		dev_kfree_skb_any(nbuf);
 		return;
 	}
 
 	/*
-	 * Pass bounced packet back to registrant
+	 * The age limit counts from the moment a backlog starts
 	 */
-	bounced_callback(app_data, nbuf);
-	spin_lock_bh(&nss_top->lock);
-	reg->callback_active = false;
-	spin_unlock_bh(&nss_top->lock);
-	module_put(owner);
+	if (!depth) {
+		egress->progress = jiffies;
+	}
+
+	__skb_queue_tail(&egress->q, nbuf);
+	if (depth + 1 > egress->max_depth) {
+		egress->max_depth = depth + 1;
+	}
+	spin_unlock_irqrestore(&egress->q.lock, flags);
+
+	atomic64_inc(&egress->queued);
+
+	set_bit(interface_num, nss_ctx->virt_if_egress_pending);
+	if (!timer_pending(&nss_core_virt_if_egress_timer)) {
+		mod_timer(&nss_core_virt_if_egress_timer, jiffies + 1);
+	}
+}
+
+/*
+ * nss_core_virt_if_egress_dequeue()
+ *	Take the head of the backlog unless its netdev transmit queue is stopped
+ */
+static struct sk_buff *nss_core_virt_if_egress_dequeue(struct nss_virt_if_egress *egress, struct net_device *ndev)
+{
+	struct sk_buff *nbuf;
+	unsigned long flags;
+
+	spin_lock_irqsave(&egress->q.lock, flags);
+	nbuf = skb_peek(&egress->q);
+	if (nbuf && !nss_core_virt_if_txq_stopped(ndev, nbuf)) {
+		__skb_unlink(nbuf, &egress->q);
+	} else {
+		nbuf = NULL;
+	}
+	spin_unlock_irqrestore(&egress->q.lock, flags);
+
+	return nbuf;
+}
+
+/*
+ * nss_core_virt_if_egress_xmit()
+ *	Send the backlog of one virtual interface, returns true if packets are left.
+ *
+ * The backlog is dropped when nothing can send it: the netdev went away or
+ * down, or it took no packet for nss_core_virt_if_egress_max_age_ms. The
+ * caller then stops retrying.
+ */
+static bool nss_core_virt_if_egress_xmit(struct nss_ctx_instance *nss_ctx, unsigned int interface_num)
+{
+	struct nss_subsystem_dataplane_register *subsys_dp_reg = &nss_ctx->nss_top->subsys_dp_register[interface_num];
+	struct nss_if_cold *cold = nss_core_if_cold(nss_ctx->nss_top, interface_num);
+	struct net_device *ndev = subsys_dp_reg->ndev;
+	struct nss_virt_if_egress *egress;
+	struct sk_buff *nbuf;
+	int budget = NSS_CORE_VIRT_IF_EGRESS_BUDGET;
+
+	if (unlikely(cold == NULL)) {
+		return false;
+	}
+
+	egress = &cold->egress;
+	if (unlikely(ndev == NULL)) {
+		/*
+		 * Interface has gone away with packets still waiting
+		 */
+		nss_core_virt_if_egress_drop(egress, &egress->dropped_nodev);
+		return false;
+	}
+
+	dev_hold(ndev);
+	if (unlikely(!netif_running(ndev))) {
+		dev_put(ndev);
+		nss_core_virt_if_egress_drop(egress, &egress->dropped_nodev);
+		return false;
+	}
+
+	while (budget--) {
+		nbuf = nss_core_virt_if_egress_dequeue(egress, ndev);
+		if (!nbuf) {
+			break;
+		}
+
+		nbuf->dev = ndev;
+		if (unlikely(ndev->netdev_ops->ndo_start_xmit(nbuf, ndev) == NETDEV_TX_BUSY)) {
+			atomic64_inc(&egress->busy);
+			skb_queue_head(&egress->q, nbuf);
+			break;
+		}
+
+		atomic64_inc(&egress->sent);
+		egress->progress = jiffies;
+	}
+	dev_put(ndev);
+
+	if (skb_queue_empty(&egress->q)) {
+		return false;
+	}
+
+	if (unlikely(time_after(jiffies, egress->progress + msecs_to_jiffies(nss_core_virt_if_egress_max_age_ms)))) {
+		nss_core_virt_if_egress_drop(egress, &egress->dropped_aged);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * nss_core_virt_if_egress_drain()
+ *	Send the virtual interface backlog of a core from its NAPI poll.
+ */
+static void nss_core_virt_if_egress_drain(struct nss_ctx_instance *nss_ctx)
+{
+	unsigned int interface_num;
+
+	for_each_set_bit(interface_num, nss_ctx->virt_if_egress_pending, NSS_MAX_NET_INTERFACES) {
+		/*
+		 * Clear before draining so that a packet queued meanwhile sets it again
+		 */
+		clear_bit(interface_num, nss_ctx->virt_if_egress_pending);
+		if (!nss_core_virt_if_egress_xmit(nss_ctx, interface_num)) {
+			continue;
+		}
+
+		/*
+		 * The netdev is still stopped, retry on the next poll or tick;
+		 * nss_core_virt_if_egress_xmit() bounds how long that goes on
+		 */
+		set_bit(interface_num, nss_ctx->virt_if_egress_pending);
+		if (!timer_pending(&nss_core_virt_if_egress_timer)) {
+			mod_timer(&nss_core_virt_if_egress_timer, jiffies + 1);
+		}
+	}
+}
+
+/*
+ * nss_core_virt_if_egress_timer_fn()
+ *	Schedule NAPI of the cores with virtual interface backlog.
+ *
+ * Netdevs do not notify us when they wake their queue, so a core with
+ * backlog and no other traffic is polled once per tick. The timer is only
+ * re-armed while a backlog is left, which the age limit bounds.
+ */
+static void nss_core_virt_if_egress_timer_fn(unsigned long data)
+{
+	struct nss_ctx_instance *nss_ctx;
+	int i;
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		nss_ctx = &nss_top_main.nss[i];
+		if ((nss_ctx->state != NSS_CORE_STATE_INITIALIZED)
+				|| bitmap_empty(nss_ctx->virt_if_egress_pending, NSS_MAX_NET_INTERFACES)) {
+			continue;
+		}
+
+		napi_schedule(&nss_ctx->int_ctx[0].napi);
+	}
+}
+
+/*
+ * nss_core_if_cold_get()
+ *	Cold state of an interface, allocated on first use.
+ *
+ * May be called from NAPI; two racing callers agree on one block. The
+ * block stays until the driver unloads since interface numbers are reused.
+ */
+struct nss_if_cold *nss_core_if_cold_get(uint32_t if_num)
+{
+	struct nss_top_instance *nss_top = &nss_top_main;
+	struct nss_if_cold *cold;
+
+	if (unlikely(if_num >= NSS_MAX_NET_INTERFACES)) {
+		return NULL;
+	}
+
+	cold = nss_core_if_cold(nss_top, if_num);
+	if (likely(cold)) {
+		return cold;
+	}
+
+	cold = kzalloc(sizeof(*cold), GFP_ATOMIC);
+	if (unlikely(cold == NULL)) {
+		nss_warning("Failed to allocate state of interface %u", if_num);
+		return NULL;
+	}
+
+	skb_queue_head_init(&cold->egress.q);
+
+	if (cmpxchg(&nss_top->if_cold[if_num], NULL, cold) != NULL) {
+		kfree(cold);
+	}
+
+	return nss_core_if_cold(nss_top, if_num);
+}
+
+/*
+ * nss_core_if_registry_exit()
+ *	Stop the egress retry timer and free the cold interface state
+ */
+void nss_core_if_registry_exit(void)
+{
+	struct nss_if_cold *cold;
+	int i;
+
+	del_timer_sync(&nss_core_virt_if_egress_timer);
+
+	for (i = 0; i < NSS_MAX_NET_INTERFACES; i++) {
+		cold = nss_top_main.if_cold[i];
+		if (!cold) {
+			continue;
+		}
+
+		skb_queue_purge(&cold->egress.q);
+		nss_top_main.if_cold[i] = NULL;
+		kfree(cold);
+	}
+}
+
+/*
+ * nss_core_virt_if_egress_purge()
+ *	Drop the egress backlog of a virtual interface being unregistered
+ */
+void nss_core_virt_if_egress_purge(uint32_t if_num)
+{
+	struct nss_if_cold *cold;
+
+	if (unlikely(if_num >= NSS_MAX_NET_INTERFACES)) {
+		return;
+	}
+
+	cold = nss_core_if_cold(&nss_top_main, if_num);
+	if (!cold) {
+		return;
+	}
+
+	nss_core_virt_if_egress_drop(&cold->egress, &cold->egress.dropped_nodev);
 }
 
 /*
@@ -397,6 +716,8 @@ static inline void nss_core_handle_virt_if_pkt(struct nss_ctx_instance *nss_ctx,
 {
 	struct nss_top_instance *nss_top = nss_ctx->nss_top;
 	struct nss_subsystem_dataplane_register *subsys_dp_reg = &nss_top->subsys_dp_register[interface_num];
+	struct nss_virt_if_egress *egress;
+	struct nss_if_cold *cold;
 	struct net_device *ndev = NULL;
 
 	uint32_t xmit_ret;
@@ -444,6 +765,30 @@ static inline void nss_core_handle_virt_if_pkt(struct nss_ctx_instance *nss_ctx,
 		return;
 	}
 
+	cold = nss_core_if_cold_get(interface_num);
+	if (unlikely(cold == NULL)) {
+		/*
+		 * No backlog without the interface state, send or drop
+		 */
+		if (ndev->netdev_ops->ndo_start_xmit(nbuf, ndev) == NETDEV_TX_BUSY) {
+			dev_kfree_skb_any(nbuf);
+		}
+		dev_put(ndev);
+		return;
+	}
+
+	/*
+	 * Stay behind packets already waiting and do not offer packets to
+	 * a netdev that stopped the queue of the packet; the backlog is sent
+	 * from NAPI.
+	 */
+	egress = &cold->egress;
+	if (unlikely(!skb_queue_empty(&egress->q) || nss_core_virt_if_txq_stopped(ndev, nbuf))) {
+		nss_core_virt_if_egress_queue(nss_ctx, interface_num, egress, nbuf);
+		dev_put(ndev);
+		return;
+	}
+
 	/*
 	 * Send the packet to virtual interface
 	 * NOTE: Invoking this will BYPASS any assigned QDisc - this is OKAY
@@ -451,12 +796,56 @@ static inline void nss_core_handle_virt_if_pkt(struct nss_ctx_instance *nss_ctx,
 	 */
 	xmit_ret = ndev->netdev_ops->ndo_start_xmit(nbuf, ndev);
 	if (unlikely(xmit_ret == NETDEV_TX_BUSY)) {
-		dev_kfree_skb_any(nbuf);
-		nss_info("%p: Congestion at virtual interface %d, %p", nss_ctx, interface_num, ndev);
+		/*
+		 * The netdev did not take the packet, keep it for a retry
+		 */
+		atomic64_inc(&egress->busy);
+		nss_core_virt_if_egress_queue(nss_ctx, interface_num, egress, nbuf);
+		nss_trace("%p: Congestion at virtual interface %d, %p", nss_ctx, interface_num, ndev);
 	}
 	dev_put(ndev);
 }
 
+/*
+ * nss_core_gro_receive()
+ *	Give an exception packet to the stack through GRO and account the result.
+ *
+ * GRO only merges when the netdev has NETIF_F_GRO, so it can be turned off
+ * per interface with ethtool. TCP only merges packets the NSS marked
+ * CHECKSUM_UNNECESSARY.
+ */
+static inline void nss_core_gro_receive(struct napi_struct *napi, struct sk_buff *nbuf, struct nss_gro_stats *gs)
+{
+	if (unlikely(gs == NULL)) {
+		napi_gro_receive(napi, nbuf);
+		return;
+	}
+
+	atomic64_inc(&gs->rx_packets);
+	if (unlikely(nbuf->ip_summed == CHECKSUM_NONE)) {
+		atomic64_inc(&gs->csum_none);
+	}
+
+	switch (napi_gro_receive(napi, nbuf)) {
+	case GRO_MERGED:
+	case GRO_MERGED_FREE:
+		atomic64_inc(&gs->merged);
+		break;
+
+	case GRO_HELD:
+		atomic64_inc(&gs->held);
+		break;
+
+	case GRO_DROP:
+		atomic64_inc(&gs->dropped);
+		break;
+
+	default:
+		atomic64_inc(&gs->normal);
+		break;
+	}
+}
+
 /*
  * nss_core_handle_buffer_pkt()
  * 	Handle data packet received on physical or virtual interface.
@@ -470,6 +859,7 @@ static inline void nss_core_handle_buffer_pkt(struct nss_ctx_instance *nss_ctx,
 	struct nss_top_instance *nss_top = nss_ctx->nss_top;
 	struct nss_subsystem_dataplane_register *subsys_dp_reg = &nss_top->subsys_dp_register[interface_num];
 	struct net_device *ndev = NULL;
+	struct nss_if_cold *cold;
 	nss_phys_if_rx_callback_t cb;
 
 	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_top->stats_drv[NSS_STATS_DRV_RX_PACKET]);
@@ -506,15 +896,16 @@ static inline void nss_core_handle_buffer_pkt(struct nss_ctx_instance *nss_ctx,
 		 */
 
 		/*
-		 * Give the packet to stack
-		 *
-		 * TODO: Change to gro receive later
+		 * Give the packet to stack through GRO on the NAPI of this
+		 * interrupt context; the held packets are flushed when the
+		 * poll completes.
 		 */
 		if (ndev) {
 			dev_hold(ndev);
 			nbuf->dev = ndev;
 			nbuf->protocol = eth_type_trans(nbuf, ndev);
-			netif_receive_skb(nbuf);
+			cold = nss_core_if_cold_get(interface_num);
+			nss_core_gro_receive(napi, nbuf, cold ? &cold->gro_stats : NULL);
 			dev_put(ndev);
 		} else {
 			/*
@@ -576,22 +967,28 @@ static inline void nss_core_handle_ext_buffer_pkt(struct nss_ctx_instance *nss_c
  * nss_core_rx_pbuf()
  *	Receive a pbuf from the NSS into Linux.
  */
-static inline void nss_core_rx_pbuf(struct nss_ctx_instance *nss_ctx, struct n2h_descriptor *desc, struct napi_struct *napi, uint8_t buffer_type, struct sk_buff *nbuf)
+static inline void nss_core_rx_pbuf(struct nss_ctx_instance *nss_ctx, struct n2h_descriptor *desc, struct napi_struct *napi,
+					struct nss_core_bounce_batch *batch, uint8_t buffer_type, struct sk_buff *nbuf)
 {
 	unsigned int interface_num = desc->interface_num;
 	struct nss_top_instance *nss_top = nss_ctx->nss_top;
-	struct nss_shaper_bounce_registrant *reg = NULL;
+	struct nss_if_cold *cold;
 
 	NSS_PKT_STATS_DECREMENT(nss_ctx, &nss_ctx->nss_top->stats_drv[NSS_STATS_DRV_NSS_SKB_COUNT]);
+	trace_nss_rx_pbuf(nss_ctx->id, buffer_type, interface_num, nbuf->len);
+
+	if (unlikely(nss_pkt_lat_enable)) {
+		nss_pkt_lat_rx(nss_ctx, desc, buffer_type, nbuf);
+	}
 
 	switch (buffer_type) {
 	case N2H_BUFFER_SHAPER_BOUNCED_INTERFACE:
-		reg = &nss_top->bounce_interface_registrants[interface_num];
-		nss_core_handle_bounced_pkt(nss_ctx, reg, nbuf);
+		cold = nss_core_if_cold(nss_top, interface_num);
+		nss_core_handle_bounced_pkt(nss_ctx, batch, cold ? rcu_dereference(cold->bounce_interface) : NULL, nbuf);
 		break;
 	case N2H_BUFFER_SHAPER_BOUNCED_BRIDGE:
-		reg = &nss_top->bounce_bridge_registrants[interface_num];
-		nss_core_handle_bounced_pkt(nss_ctx, reg, nbuf);
+		cold = nss_core_if_cold(nss_top, interface_num);
+		nss_core_handle_bounced_pkt(nss_ctx, batch, cold ? rcu_dereference(cold->bounce_bridge) : NULL, nbuf);
 		break;
 	case N2H_BUFFER_PACKET_VIRTUAL:
 		nss_core_handle_virt_if_pkt(nss_ctx, interface_num, nbuf);
@@ -928,6 +1325,7 @@ static int32_t nss_core_handle_cause_queue(struct int_ctx_instance *int_ctx, uin
 	struct n2h_descriptor *desc;
 	struct nss_ctx_instance *nss_ctx = int_ctx->nss_ctx;
 	struct nss_if_mem_map *if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
+	struct nss_core_bounce_batch batch;
 
 	qid = nss_core_cause_to_queue(cause);
 
@@ -947,7 +1345,7 @@ static int32_t nss_core_handle_cause_queue(struct int_ctx_instance *int_ctx, uin
 	/*
 	 * Check if there is work to be done for this queue
 	 */
-	count = ((nss_index - hlos_index) + size) & (mask);
+	count = nss_core_n2h_ring_pending(nss_index, hlos_index, size);
 	if (unlikely(count == 0)) {
 		return 0;
 	}
@@ -959,6 +1357,13 @@ static int32_t nss_core_handle_cause_queue(struct int_ctx_instance *int_ctx, uin
 		count = weight;
 	}
 
+	/*
+	 * Bounce registrants are looked up under RCU for the whole poll
+	 */
+	batch.reg = NULL;
+	__skb_queue_head_init(&batch.q);
+	rcu_read_lock();
+
 	count_temp = count;
 	while (count_temp) {
 		unsigned int buffer_type;
@@ -1074,15 +1479,19 @@ static int32_t nss_core_handle_cause_queue(struct int_ctx_instance *int_ctx, uin
 		}
 
 consume:
-		nss_core_rx_pbuf(nss_ctx, desc, &(int_ctx->napi), buffer_type, nbuf);
+		nss_core_rx_pbuf(nss_ctx, desc, &(int_ctx->napi), &batch, buffer_type, nbuf);
 
 next:
 		hlos_index = (hlos_index + 1) & (mask);
 		count_temp--;
 	}
 
+	nss_core_bounce_batch_flush(&batch);
+	rcu_read_unlock();
+
 	n2h_desc_ring->hlos_index = hlos_index;
 	if_map->n2h_hlos_index[qid] = hlos_index;
+	trace_nss_cause_queue(nss_ctx->id, cause, count, weight);
 	return count;
 }
 
@@ -1254,7 +1663,7 @@ static void nss_core_handle_cause_nonqueue(struct int_ctx_instance *int_ctx, uin
 		size = h2n_desc_ring->desc_ring.size;
 
 		mask = size - 1;
-		count = ((nss_index - hlos_index - 1) + size) & (mask);
+		count = nss_core_h2n_ring_free(nss_index, hlos_index, size);
 
 		nss_trace("%p: Adding %d buffers to empty queue", nss_ctx, count);
 
@@ -1365,6 +1774,8 @@ static void nss_core_handle_cause_nonqueue(struct int_ctx_instance *int_ctx, uin
 			count--;
 		}
 
+		trace_nss_empty_refill(nss_ctx->id, count + ((hlos_index - h2n_desc_ring->hlos_index) & mask),
+					(hlos_index - h2n_desc_ring->hlos_index) & mask);
 		h2n_desc_ring->hlos_index = hlos_index;
 		if_map->h2n_hlos_index[NSS_IF_EMPTY_BUFFER_QUEUE] = hlos_index;
 
@@ -1375,6 +1786,7 @@ static void nss_core_handle_cause_nonqueue(struct int_ctx_instance *int_ctx, uin
 		NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_top->stats_drv[NSS_STATS_DRV_TX_EMPTY]);
 	} else if (cause == NSS_REGS_N2H_INTR_STATUS_TX_UNBLOCKED) {
 		nss_trace("%p: Data queue unblocked", nss_ctx);
+		trace_nss_tx_unblocked(nss_ctx->id, nss_ctx->h2n_desc_rings[NSS_IF_DATA_QUEUE_0].tx_q_full_cnt);
 
 		/*
 		 * Call callback functions of drivers that have registered with us
@@ -1459,6 +1871,55 @@ static uint32_t nss_core_get_prioritized_cause(uint32_t cause, uint32_t *type, i
 	return 0;
 }
 
+/*
+ * nss_core_napi_stats_bucket()
+ *	log2 histogram bucket of a value
+ */
+static inline uint32_t nss_core_napi_stats_bucket(uint32_t val, uint32_t buckets)
+{
+	uint32_t bucket = fls(val);
+
+	return (bucket < buckets) ? bucket : (buckets - 1);
+}
+
+/*
+ * nss_core_napi_stats_sample_rings()
+ *	Sample the occupancy of every descriptor ring at poll time
+ */
+static inline void nss_core_napi_stats_sample_rings(struct nss_ctx_instance *nss_ctx, struct nss_napi_stats *ns)
+{
+	struct nss_if_mem_map *if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
+	uint32_t i, size, used;
+
+	for (i = 0; i < if_map->n2h_rings && i < NSS_N2H_DESC_RING_NUM; i++) {
+		size = nss_ctx->n2h_desc_ring[i].desc_if.size;
+		used = nss_core_n2h_ring_pending(if_map->n2h_nss_index[i], nss_ctx->n2h_desc_ring[i].hlos_index, size);
+		ns->n2h_occ_hist[i][nss_core_napi_stats_bucket(used, NSS_NAPI_STATS_OCC_BUCKETS)]++;
+	}
+
+	for (i = 0; i < if_map->h2n_rings && i < NSS_H2N_DESC_RING_NUM; i++) {
+		size = nss_ctx->h2n_desc_rings[i].desc_ring.size;
+		used = size - 1 - nss_core_h2n_ring_free(if_map->h2n_nss_index[i], nss_ctx->h2n_desc_rings[i].hlos_index, size);
+		ns->h2n_occ_hist[i][nss_core_napi_stats_bucket(used, NSS_NAPI_STATS_OCC_BUCKETS)]++;
+	}
+}
+
+/*
+ * nss_core_napi_stats_cause()
+ *	Account the time spent handling one interrupt cause
+ */
+static inline void nss_core_napi_stats_cause(struct nss_napi_stats *ns, uint32_t prio_cause, uint64_t start_ns)
+{
+	uint32_t bit = ffs(prio_cause);
+
+	if (unlikely(!bit || bit > NSS_NAPI_STATS_CAUSES)) {
+		return;
+	}
+
+	ns->cause_count[bit - 1]++;
+	ns->cause_ns[bit - 1] += ktime_to_ns(ktime_get()) - start_ns;
+}
+
 /*
  * nss_core_handle_napi()
  *	NAPI handler for NSS
@@ -1470,6 +1931,10 @@ int nss_core_handle_napi(struct napi_struct *napi, int budget)
 	struct netdev_priv_instance *ndev_priv = netdev_priv(napi->dev);
 	struct int_ctx_instance *int_ctx = ndev_priv->int_ctx;
 	struct nss_ctx_instance *nss_ctx = int_ctx->nss_ctx;
+	struct nss_napi_stats *ns = &int_ctx->napi_stats;
+	bool stats = unlikely(nss_core_napi_stats_enable);
+	int budget_granted = budget;
+	uint64_t start_ns = 0;
 
 	/*
 	 * Read cause of interrupt
@@ -1478,6 +1943,14 @@ int nss_core_handle_napi(struct napi_struct *napi, int budget)
 	nss_hal_clear_interrupt_cause(nss_ctx->nmap, int_ctx->irq, int_ctx->shift_factor, int_cause);
 	int_ctx->cause |= int_cause;
 
+	if (stats && (nss_ctx->state == NSS_CORE_STATE_INITIALIZED)) {
+		nss_core_napi_stats_sample_rings(nss_ctx, ns);
+	}
+
+	if (unlikely(!bitmap_empty(nss_ctx->virt_if_egress_pending, NSS_MAX_NET_INTERFACES))) {
+		nss_core_virt_if_egress_drain(nss_ctx);
+	}
+
 	do {
 		while ((int_ctx->cause) && (budget)) {
 
@@ -1493,6 +1966,9 @@ int nss_core_handle_napi(struct napi_struct *napi, int budget)
 			}
 
 		processed = 0;
+		if (stats) {
+			start_ns = ktime_to_ns(ktime_get());
+		}
 		switch (cause_type) {
 		case NSS_INTR_CAUSE_QUEUE:
 			processed = nss_core_handle_cause_queue(int_ctx, prio_cause, weight);
@@ -1525,6 +2001,10 @@ int nss_core_handle_napi(struct napi_struct *napi, int budget)
 			nss_assert(0);
 			break;
 		}
+
+		if (stats) {
+			nss_core_napi_stats_cause(ns, prio_cause, start_ns);
+		}
 	}
 
 		nss_hal_read_interrupt_cause(nss_ctx->nmap, int_ctx->irq, int_ctx->shift_factor, &int_cause);
@@ -1532,6 +2012,16 @@ int nss_core_handle_napi(struct napi_struct *napi, int budget)
 		int_ctx->cause |= int_cause;
 	} while ((int_ctx->cause) && (budget));
 
+	if (stats) {
+		ns->polls++;
+		ns->work += count;
+		ns->budget += budget_granted;
+		ns->work_hist[nss_core_napi_stats_bucket(count, NSS_NAPI_STATS_WORK_BUCKETS)]++;
+		if (!budget) {
+			ns->budget_exhausted++;
+		}
+	}
+
 	if (int_ctx->cause == 0) {
 		napi_complete(napi);
 
@@ -1569,7 +2059,7 @@ int32_t nss_core_send_crypto(struct nss_ctx_instance *nss_ctx, void *buf, uint32
 	hlos_index = h2n_desc_ring->hlos_index;
 
 	size = desc_if->size;
-	count = ((nss_index - hlos_index - 1) + size) & (size - 1);
+	count = nss_core_h2n_ring_free(nss_index, hlos_index, size);
 
 	if (unlikely(count < 1)) {
 		/* TODO: What is the use case of TX_STOPPED_FLAGS */
@@ -1992,7 +2482,11 @@ int32_t nss_core_send_buffer(struct nss_ctx_instance *nss_ctx, uint32_t if_num,
 	nss_index = if_map->h2n_nss_index[qid];
 	hlos_index = h2n_desc_ring->hlos_index;
 
-	count = ((nss_index - hlos_index - 1) + size) & (mask);
+	if (unlikely(nss_pkt_lat_enable)) {
+		nss_pkt_lat_h2n_retire(nss_ctx, h2n_desc_ring, nss_index);
+	}
+
+	count = nss_core_h2n_ring_free(nss_index, hlos_index, size);
 
 	if (unlikely(count < (segments + 1))) {
 		/*
@@ -2004,6 +2498,7 @@ int32_t nss_core_send_buffer(struct nss_ctx_instance *nss_ctx, uint32_t if_num,
 		h2n_desc_ring->flags |= NSS_H2N_DESC_RING_FLAGS_TX_STOPPED;
 		spin_unlock_bh(&h2n_desc_ring->lock);
 		nss_warning("%p: Data/Command Queue full reached", nss_ctx);
+		trace_nss_send_buffer(nss_ctx->id, qid, if_num, segments, buffer_type, size - 1 - count, NSS_CORE_STATUS_FAILURE_QUEUE);
 
 #if (NSS_PKT_STATS_ENABLED == 1)
 		if (nss_ctx->id == NSS_CORE_0) {
@@ -2075,11 +2570,28 @@ int32_t nss_core_send_buffer(struct nss_ctx_instance *nss_ctx, uint32_t if_num,
 		return NSS_CORE_STATUS_FAILURE;
 	}
 
+	if (unlikely(nss_pkt_lat_enable) && (buffer_type != H2N_BUFFER_CTRL)) {
+		nss_pkt_lat_h2n_queued(h2n_desc_ring, if_num, hlos_index, nbuf, is_bounce);
+	}
+
 	/*
 	 * Update our host index so the NSS sees we've written a new descriptor.
 	 */
 	hlos_index = (hlos_index + count) & mask;
 	h2n_desc_ring->hlos_index = hlos_index;
+
+	/*
+	 * Timestamp control messages before the NSS can see them, so that
+	 * the response can never be processed ahead of the request.
+	 */
+	if (buffer_type == H2N_BUFFER_CTRL) {
+		if (unlikely(nss_msg_lat_enable)) {
+			nss_msg_lat_tx(nss_ctx, (struct nss_cmn_msg *)nbuf->data);
+		}
+
+		trace_nss_msg_tx(nss_ctx->id, (struct nss_cmn_msg *)nbuf->data);
+	}
+
 	if_map->h2n_hlos_index[qid] = hlos_index;
 
 #ifdef CONFIG_DEBUG_KMEMLEAK
@@ -2101,5 +2613,7 @@ int32_t nss_core_send_buffer(struct nss_ctx_instance *nss_ctx, uint32_t if_num,
 	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->nss_top->stats_drv[NSS_STATS_DRV_NSS_SKB_COUNT]);
 
 	spin_unlock_bh(&h2n_desc_ring->lock);
+	trace_nss_send_buffer(nss_ctx->id, qid, if_num, segments, buffer_type,
+				size - 1 - nss_core_h2n_ring_free(nss_index, hlos_index, size), NSS_CORE_STATUS_SUCCESS);
 	return NSS_CORE_STATUS_SUCCESS;
 }
@@ -32,12 +32,14 @@
 #include <linux/netdevice.h>
 #include <linux/debugfs.h>
 #include <linux/workqueue.h>
+#include <linux/sysctl.h>
 
 #include <nss_api_if.h>
 #include <nss_gmac_api_if.h>
 #include "nss_phys_if.h"
 #include "nss_hlos_if.h"
 #include "nss_oam.h"
+#include "nss_stats_genl.h"
 
 /*
  * XXX:can't add this to api_if.h till the deprecated
@@ -150,6 +152,11 @@
  */
 #define NSS_N2H_DESC_RING_NUM 15
 
+/*
+ * Number of h2n descriptor rings
+ */
+#define NSS_H2N_DESC_RING_NUM 16
+
 /*
  * NSS maximum clients
  */
@@ -460,6 +467,11 @@ enum nss_stats_node {
 	NSS_STATS_NODE_MAX,
 };
 
+/*
+ * Only special interfaces carry node statistics; index of one in stats_node
+ */
+#define NSS_STATS_NODE_IDX(if_num) ((if_num) - NSS_SPECIAL_IF_START)
+
 /*
  * N2H node statistics
  *
@@ -499,6 +511,22 @@ enum nss_stats_n2h {
 	NSS_STATS_N2H_MAX,
 };
 
+/*
+ * IPsec host driver statistics, kept per core
+ *
+ * WARNING: There is a 1:1 mapping between values below and corresponding
+ *	stats string array in nss_stats.c
+ */
+enum nss_stats_ipsec {
+	NSS_STATS_IPSEC_ENCAP_TX_PACKETS,	/* Packets sent to the encap interface */
+	NSS_STATS_IPSEC_DECAP_TX_PACKETS,	/* Packets sent to the decap interface */
+	NSS_STATS_IPSEC_TX_QUEUE_FULL,		/* Packets refused because the H2N queue was full */
+	NSS_STATS_IPSEC_TX_FAILED,		/* Packets refused for any other reason */
+	NSS_STATS_IPSEC_TX_MSG,			/* Messages sent */
+	NSS_STATS_IPSEC_RX_NOTIFY,		/* Notifications received */
+	NSS_STATS_IPSEC_MAX,
+};
+
 /*
  * LSO_RX driver statistics
  *
@@ -638,6 +666,40 @@ struct nss_stats_map_t_instance_debug {
 	bool valid;
 };
 
+/*
+ * Tunnel types whose per-session statistics live in the session store
+ */
+enum nss_session_stats_type {
+	NSS_SESSION_STATS_TYPE_NONE,
+	NSS_SESSION_STATS_TYPE_DTLS,
+	NSS_SESSION_STATS_TYPE_L2TPV2,
+	NSS_SESSION_STATS_TYPE_PPTP,
+	NSS_SESSION_STATS_TYPE_MAP_T,
+	NSS_SESSION_STATS_TYPE_MAX,
+};
+
+/*
+ * Binary statistics export
+ */
+#define NSS_STATS_BIN_MAGIC	0x4e535342	/* "NSSB" */
+#define NSS_STATS_BIN_VERSION	1
+
+/*
+ * nss_stats_bin_hdr
+ *	Header of the qca-nss-drv/stats/bin/data snapshot.
+ *
+ * The header is followed by num_counters 64 bit counters laid out as
+ * described by qca-nss-drv/stats/bin/schema.
+ */
+struct nss_stats_bin_hdr {
+	uint32_t magic;			/* NSS_STATS_BIN_MAGIC */
+	uint16_t version;		/* NSS_STATS_BIN_VERSION */
+	uint16_t hdr_len;		/* Size of this header in bytes */
+	uint32_t num_counters;		/* Number of counters following the header */
+	uint32_t generation;		/* Incremented on every snapshot of this descriptor */
+	uint64_t timestamp;		/* Snapshot time in ns (monotonic) */
+};
+
 /*
  * NSS core state
  */
@@ -667,6 +729,33 @@ struct netdev_priv_instance {
 	struct int_ctx_instance *int_ctx;	/* Back pointer to interrupt context */
 };
 
+/*
+ * NAPI poll statistics
+ *
+ * Histograms use log2 buckets: bucket 0 counts zero, bucket n counts
+ * values in [2^(n-1), 2^n) and the last bucket everything above.
+ */
+#define NSS_NAPI_STATS_WORK_BUCKETS 8	/* Work done per poll, up to 64+ */
+#define NSS_NAPI_STATS_OCC_BUCKETS 12	/* Ring occupancy at poll time, up to 1024+ */
+#define NSS_NAPI_STATS_CAUSES 16	/* Interrupt cause bits */
+
+struct nss_napi_stats {
+	uint64_t polls;			/* NAPI polls */
+	uint64_t work;			/* Buffers processed over all polls */
+	uint64_t budget;		/* Budget granted over all polls */
+	uint64_t budget_exhausted;	/* Polls that used up their budget */
+	uint64_t work_hist[NSS_NAPI_STATS_WORK_BUCKETS];
+					/* Work done per poll */
+	uint64_t cause_count[NSS_NAPI_STATS_CAUSES];
+					/* Times each cause was handled */
+	uint64_t cause_ns[NSS_NAPI_STATS_CAUSES];
+					/* Time spent handling each cause */
+	uint64_t n2h_occ_hist[NSS_N2H_DESC_RING_NUM][NSS_NAPI_STATS_OCC_BUCKETS];
+					/* N2H descriptors pending at poll time */
+	uint64_t h2n_occ_hist[NSS_H2N_DESC_RING_NUM][NSS_NAPI_STATS_OCC_BUCKETS];
+					/* H2N descriptors in use at poll time */
+};
+
 /*
  * Interrupt context instance (one per IRQ per NSS core)
  */
@@ -681,6 +770,8 @@ struct int_ctx_instance {
 					   context */
 	struct napi_struct napi;	/* NAPI handler */
 	bool napi_active;		/* NAPI is active */
+	struct nss_napi_stats napi_stats;
+					/* NAPI poll statistics, only updated by this NAPI instance */
 };
 
 /*
@@ -704,6 +795,8 @@ struct hlos_h2n_desc_rings {
 	spinlock_t lock;			/* Lock to save from simultaneous access */
 	uint32_t flags;				/* Flags */
 	uint64_t tx_q_full_cnt;			/* Descriptor queue full count */
+	struct nss_pkt_lat_slot *lat_slots;	/* Send time per descriptor, latency telemetry only */
+	uint32_t lat_nss_index;			/* NSS index the send times were accounted up to */
 };
 
 #define NSS_H2N_DESC_RING_FLAGS_TX_STOPPED 0x1	/* Tx has been stopped for this queue */
@@ -713,11 +806,29 @@ struct hlos_h2n_desc_rings {
  *	Registrant detail for shaper bounce operations
  */
 struct nss_shaper_bounce_registrant {
+	struct rcu_head rcu;					/* Freed after NAPI is done with it */
 	nss_shaper_bounced_callback_t bounced_callback;		/* Invoked for each shaper bounced packet returned from the NSS */
+	nss_shaper_bounced_list_callback_t bounced_list_callback;
+								/* Invoked with the packets returned in one NAPI poll, if set */
 	void *app_data;						/* Argument given to the callback */
 	struct module *owner;					/* Owning module of the callback + arg */
-	bool registered;
-	volatile bool callback_active;				/* true when the bounce callback is being called */
+};
+
+/*
+ * NSS Core Sampling Structure
+ *
+ * INFO: Running INST_CNT statistic of one NSS core, used for frequency scaling
+ */
+#define NSS_SAMPLE_BUFFER_SIZE 4			/* Ring Buffer should be a Size of two */
+#define NSS_SAMPLE_BUFFER_MASK (NSS_SAMPLE_BUFFER_SIZE - 1)
+
+struct nss_core_sampling {
+	uint32_t buffer[NSS_SAMPLE_BUFFER_SIZE];	/* Sample Ring Buffer */
+	uint32_t buffer_index;				/* Running Buffer Index */
+	uint32_t sum;					/* Total INST_CNT SUM */
+	uint32_t sample_count;				/* Number of Samples stored in Ring Buffer */
+	uint32_t average;				/* Average of INST_CNT */
+	uint32_t last;					/* Latest INST_CNT */
 };
 
 /*
@@ -736,7 +847,7 @@ struct nss_ctx_instance {
 	uint32_t c2c_start;		/* C2C start address */
 	struct int_ctx_instance int_ctx[2];
 					/* Interrupt context instances */
-	struct hlos_h2n_desc_rings h2n_desc_rings[16];
+	struct hlos_h2n_desc_rings h2n_desc_rings[NSS_H2N_DESC_RING_NUM];
 					/* Host to NSS descriptor rings */
 	struct hlos_n2h_desc_ring n2h_desc_ring[NSS_N2H_DESC_RING_NUM];
 					/* NSS to Host descriptor rings */
@@ -753,14 +864,61 @@ struct nss_ctx_instance {
 					/* Current MTU value of physical interface */
 	uint64_t stats_n2h[NSS_STATS_N2H_MAX];
 					/* N2H node stats: includes node, n2h, pbuf in this order */
+	atomic64_t stats_ipsec[NSS_STATS_IPSEC_MAX];
+					/* IPsec host driver stats of this core */
+	DECLARE_BITMAP(virt_if_egress_pending, NSS_MAX_NET_INTERFACES);
+					/* Interfaces with virtual egress backlog to drain from this core's NAPI */
+	struct nss_core_sampling samples;
+					/* Frequency scaling samples of this core */
+	uint32_t inst_cnt_total;	/* Latest INST_CNT reported by this core */
 	uint32_t magic;
 					/* Magic protection */
 };
 
+/*
+ * GRO statistics of exception packets given to the stack for an interface
+ * without an rx callback; updated from the NAPI context of either core
+ */
+struct nss_gro_stats {
+	atomic64_t rx_packets;		/* Packets handed to napi_gro_receive() */
+	atomic64_t merged;		/* Packets merged into a held packet */
+	atomic64_t held;		/* Packets held as the head of a new flow */
+	atomic64_t normal;		/* Packets passed to the stack unmerged */
+	atomic64_t dropped;		/* Packets GRO dropped */
+	atomic64_t csum_none;		/* Packets without a valid NSS transport checksum */
+};
+
+/*
+ * Software queue of virtual interface egress, drained from NAPI while the
+ * target netdev cannot take packets
+ */
+struct nss_virt_if_egress {
+	struct sk_buff_head q;		/* Packets waiting for the netdev */
+	unsigned long progress;		/* Jiffies of the last send, or of queueing into an empty queue */
+	uint32_t max_depth;		/* Deepest queue seen, under the queue lock */
+	atomic64_t queued;		/* Packets queued */
+	atomic64_t sent;		/* Queued packets transmitted later */
+	atomic64_t busy;		/* NETDEV_TX_BUSY returns of the netdev */
+	atomic64_t dropped_full;	/* Packets dropped, queue full */
+	atomic64_t dropped_nodev;	/* Queued packets dropped, netdev gone or down */
+	atomic64_t dropped_aged;	/* Queued packets dropped, netdev took nothing within the age limit */
+};
+
+/*
+ * CB function declarations
+ */
+struct nss_ctx_instance;
+typedef void (*nss_core_rx_callback_t)(struct nss_ctx_instance *, struct nss_cmn_msg *, void *);
+
 /*
  * NSS core <-> subsystem data plane registration related paramaters.
  * This struct is filled in if_register/data_plane register APIs & retrieved
  * when handling a data packet/skb destined to that subsystem interface.
+ *
+ * Every interface has a small hot entry in one dense array with what the
+ * receive dispatch needs. Everything else lives in a cold block that is
+ * only allocated for interfaces that use it, so the per-interface static
+ * footprint is the hot entry plus a pointer.
  */
 struct nss_subsystem_dataplane_register {
 	nss_phys_if_rx_callback_t cb;	/* callback to be invoked */
@@ -771,6 +929,24 @@ struct nss_subsystem_dataplane_register {
 	void *app_data;			/* additional info passed during callback(for future use) */
 	struct net_device *ndev;	/* Netdevice associated with the interface */
 	uint32_t features;		/* skb types supported by this subsystem */
+	nss_core_rx_callback_t msg_cb;	/* Message handler, see nss_core_register_handler() */
+	void *msg_app_data;		/* Argument given to the message handler */
+	nss_if_rx_msg_callback_t if_rx_msg_cb;
+					/* Message callback of the interface owner */
+};
+
+/*
+ * nss_if_cold
+ *	Cold per-interface state, allocated on first use by nss_core_if_cold_get()
+ */
+struct nss_if_cold {
+	struct nss_shaper_bounce_registrant __rcu *bounce_interface;
+					/* Registrant for interface shaper bounce operations */
+	struct nss_shaper_bounce_registrant __rcu *bounce_bridge;
+					/* Registrant for bridge shaper bounce operations */
+	struct nss_gro_stats gro_stats;	/* GRO statistics of exception packets */
+	struct nss_virt_if_egress egress;
+					/* Virtual interface egress backlog */
 };
 
 /*
@@ -811,6 +987,13 @@ struct nss_top_instance {
 	struct dentry *wifi_if_dentry;		/* wifi_if stats dentry */
 	struct dentry *virt_if_dentry;	/* virt_if stats dentry */
 	struct dentry *tx_rx_virt_if_dentry; /* tx_rx_virt_if stats dentry. Will be deprecated soon */
+	struct dentry *stats_bin_dentry;	/* Binary stats export directory */
+	struct dentry *rings_dentry;	/* Descriptor ring state dentry */
+	struct dentry *napi_dentry;	/* NAPI poll statistics dentry */
+	struct dentry *gro_dentry;	/* Exception packet GRO statistics dentry */
+	struct dentry *virt_if_egress_dentry;
+					/* Virtual interface egress backlog statistics dentry */
+	struct dentry *ipsec_dentry;	/* IPsec per core stats dentry */
 	struct nss_ctx_instance nss[NSS_MAX_CORES];
 					/* NSS contexts */
 	/*
@@ -847,8 +1030,6 @@ struct nss_top_instance {
 	/*
 	 * Data/Message callbacks for various interfaces
 	 */
-	nss_if_rx_msg_callback_t if_rx_msg_callback[NSS_MAX_NET_INTERFACES];
-					/* All interfaces message callback functions */
 	nss_phys_if_msg_callback_t phys_if_msg_callback[NSS_MAX_PHYSICAL_INTERFACES];
 					/* Physical interface event callback functions */
 	nss_virt_if_msg_callback_t virt_if_msg_callback[NSS_MAX_VIRTUAL_INTERFACES];
@@ -857,9 +1038,9 @@ struct nss_top_instance {
 					/* IPv4 sync/establish callback function */
 	nss_ipv6_msg_callback_t ipv6_callback;
 					/* IPv6 sync/establish callback function */
-	nss_ipsec_msg_callback_t ipsec_encap_callback;
-	nss_ipsec_msg_callback_t ipsec_decap_callback;
-					/* IPsec event callback function */
+	nss_ipsec_msg_callback_t ipsec_encap_callback[NSS_MAX_CORES];
+	nss_ipsec_msg_callback_t ipsec_decap_callback[NSS_MAX_CORES];
+					/* IPsec event callback functions of each core */
 	nss_crypto_msg_callback_t crypto_msg_callback;
 	nss_crypto_buf_callback_t crypto_buf_callback;
 					/* crypto interface callback functions */
@@ -879,15 +1060,16 @@ struct nss_top_instance {
 					/* ipip6 tunnel interface event callback function */
 	nss_pptp_msg_callback_t pptp_msg_callback;
 					/* PPTP tunnel interface event callback function */
-	struct nss_shaper_bounce_registrant bounce_interface_registrants[NSS_MAX_NET_INTERFACES];
-					/* Registrants for interface shaper bounce operations */
-	struct nss_shaper_bounce_registrant bounce_bridge_registrants[NSS_MAX_NET_INTERFACES];
-					/* Registrants for bridge shaper bounce operations */
+	struct nss_if_cold *if_cold[NSS_MAX_NET_INTERFACES];
+					/* Cold per-interface state, NULL until used */
 	nss_lag_event_callback_t lag_event_callback;
 					/* Registrants for lag operations */
 	nss_oam_msg_callback_t oam_callback;
 					/* OAM call back */
 	uint32_t dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_MAX];
+	uint32_t dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_MAX];
+					/* Bitmap of cores whose firmware runs each dynamic interface type */
+	uint32_t ipsec_cores;		/* Bitmap of cores whose firmware runs IPsec */
 
 	/*
 	 * Interface contexts (non network device)
@@ -898,8 +1080,10 @@ struct nss_top_instance {
 	void *profiler_ctx[NSS_MAX_CORES];
 					/* Profiler interface context */
 
-	void *ipsec_encap_ctx;		/* IPsec encap context */
-	void *ipsec_decap_ctx;		/* IPsec decap context */
+	void *ipsec_encap_ctx[NSS_MAX_CORES];
+					/* IPsec encap context of each core */
+	void *ipsec_decap_ctx[NSS_MAX_CORES];
+					/* IPsec decap context of each core */
 	void *oam_ctx;			/* oam context */
 
 	/*
@@ -925,7 +1109,7 @@ struct nss_top_instance {
 					/* WIFI statistics */
 	uint64_t stats_eth_rx[NSS_STATS_ETH_RX_MAX];
 					/* ETH_RX statistics */
-	uint64_t stats_node[NSS_MAX_NET_INTERFACES][NSS_STATS_NODE_MAX];
+	uint64_t stats_node[NSS_MAX_SPECIAL_INTERFACES][NSS_STATS_NODE_MAX];
 					/* IPv4 statistics per interface */
 	uint64_t stats_if_exception_eth_rx[NSS_EXCEPTION_EVENT_ETH_RX_MAX];
 					/* Unknown protocol exception events per interface */
@@ -1004,8 +1188,6 @@ enum nss_scales {
 /*
  * NSS Core Statistics and Frequencies
  */
-#define NSS_SAMPLE_BUFFER_SIZE 4			/* Ring Buffer should be a Size of two */
-#define NSS_SAMPLE_BUFFER_MASK (NSS_SAMPLE_BUFFER_SIZE - 1)
 #define NSS_FREQUENCY_SCALE_RATE_LIMIT_UP 2		/* Adjust the Rate of Frequency Switching Up */
 #define NSS_FREQUENCY_SCALE_RATE_LIMIT_DOWN 60000	/* Adjust the Rate of Frequency Switching Down */
 #define NSS_MESSAGE_RATE_LIMIT 15000			/* Adjust the Rate of Displaying Statistic Messages */
@@ -1025,8 +1207,8 @@ struct nss_scale_info {
 /*
  * NSS Runtime Sample Structure
  *
- * INFO: Contains the runtime statistic of the NSS core
- *	Also contains the per frequency scale array
+ * INFO: Contains the scaling state of the NSS clock shared by all cores
+ *	Also contains the per frequency scale array; per core samples live in nss_ctx_instance
  */
 struct nss_runtime_sampling {
 	struct nss_scale_info freq_scale[NSS_FREQ_MAX_SCALE];	/* NSS Max Scale Per Freq */
@@ -1034,11 +1216,7 @@ struct nss_runtime_sampling {
 	uint32_t freq_scale_ready;				/* Allow Freq Scaling */
 	uint32_t freq_scale_rate_limit_up;			/* Scaling Change Rate Limit */
 	uint32_t freq_scale_rate_limit_down;			/* Scaling Change Rate Limit */
-	uint32_t buffer[NSS_SAMPLE_BUFFER_SIZE];		/* Sample Ring Buffer */
-	uint32_t buffer_index;					/* Running Buffer Index */
-	uint32_t sum;						/* Total INST_CNT SUM */
-	uint32_t sample_count;					/* Number of Samples stored in Ring Buffer */
-	uint32_t average;					/* Average of INST_CNT */
+	uint32_t average;					/* Average of INST_CNT of the busiest core */
 	uint32_t message_rate_limit;				/* Debug Message Rate Limit */
 	uint32_t initialized;					/* Flag to check for adequate initial samples */
 };
@@ -1109,20 +1287,26 @@ static inline void nss_core_log_msg_failures(struct nss_ctx_instance *nss_ctx, s
 		nss_ctx, ncm->interface, ncm->type, ncm->response, ncm->error);
 }
 
+/*
+ * Fabric and bus performance levels picked by the perf state manager
+ */
+enum nss_freq_perf_level {
+	NSS_FREQ_PERF_LEVEL_IDLE,	/* Idle fabric rates, idle bus vote */
+	NSS_FREQ_PERF_LEVEL_NOMINAL,	/* Nominal fabric rates, nominal bus vote */
+	NSS_FREQ_PERF_LEVEL_TURBO,	/* Turbo fabric rates, turbo bus vote */
+	NSS_FREQ_PERF_LEVEL_MAX,
+};
+
 /*
  * NSS workqueue to change frequencies
  */
 typedef struct {
 	struct work_struct my_work;	/* Work Structure */
-	uint32_t frequency;		/* Frequency To Change */
+	uint32_t frequency;		/* Frequency To Change, 0 to only change the fabric level */
 	uint32_t stats_enable;		/* Auto scale on/off */
+	uint32_t fabric_level;		/* Fabric and bus level, enum nss_freq_perf_level */
 } nss_work_t;
 
-/*
- * CB function declarations
- */
-typedef void (*nss_core_rx_callback_t)(struct nss_ctx_instance *, struct nss_cmn_msg *, void *);
-
 /*
  * APIs provided by nss_core.c
  */
@@ -1136,12 +1320,47 @@ extern uint32_t nss_core_register_handler(uint32_t interface, nss_core_rx_callba
 extern uint32_t nss_core_unregister_handler(uint32_t interface);
 extern int nss_core_max_ipv4_conn_get(void);
 extern int nss_core_max_ipv6_conn_get(void);
+extern int nss_core_virt_if_egress_limit;
+extern int nss_core_virt_if_egress_max_age_ms;
+extern int nss_core_napi_stats_enable;
+extern struct nss_if_cold *nss_core_if_cold_get(uint32_t if_num);
+extern void nss_core_if_registry_exit(void);
+extern void nss_core_virt_if_egress_purge(uint32_t if_num);
+
+/*
+ * nss_core_if_cold()
+ *	Cold state of an interface, NULL until nss_core_if_cold_get() allocated it
+ */
+static inline struct nss_if_cold *nss_core_if_cold(struct nss_top_instance *nss_top, uint32_t if_num)
+{
+	return ACCESS_ONCE(nss_top->if_cold[if_num]);
+}
 
 static inline uint32_t nss_core_get_max_buf_size(struct nss_ctx_instance *nss_ctx)
 {
 	return nss_ctx->max_buf_size;
 }
 
+/*
+ * nss_core_h2n_ring_free()
+ *	Descriptors the HLOS can still write to an H2N ring; one slot is always kept empty.
+ *
+ * Ring sizes are powers of two.
+ */
+static inline uint32_t nss_core_h2n_ring_free(uint32_t nss_index, uint32_t hlos_index, uint32_t size)
+{
+	return ((nss_index - hlos_index - 1) + size) & (size - 1);
+}
+
+/*
+ * nss_core_n2h_ring_pending()
+ *	Descriptors written by the NSS to an N2H ring that the HLOS has not consumed yet
+ */
+static inline uint32_t nss_core_n2h_ring_pending(uint32_t nss_index, uint32_t hlos_index, uint32_t size)
+{
+	return ((nss_index - hlos_index) + size) & (size - 1);
+}
+
 /*
  * APIs provided by nss_tx_rx.c
  */
@@ -1152,14 +1371,107 @@ extern void nss_crypto_buf_handler(struct nss_ctx_instance *nss_ctx, void *buf,
  */
 extern void nss_stats_init(void);
 extern void nss_stats_clean(void);
+extern int nss_stats_rate_interval_ms;
+extern int nss_stats_rate_interval_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos);
+
+/*
+ * APIs provided by nss_session_stats.c
+ */
+extern int nss_session_stats_add(enum nss_session_stats_type type, uint32_t if_num, int32_t if_index);
+extern void nss_session_stats_del(enum nss_session_stats_type type, uint32_t if_num);
+extern void nss_session_stats_del_type(enum nss_session_stats_type type);
+extern uint64_t *nss_session_stats_update_begin(enum nss_session_stats_type type, uint32_t if_num);
+extern void nss_session_stats_update_end(uint64_t *stats);
+extern bool nss_session_stats_read(enum nss_session_stats_type type, uint32_t if_num, int32_t *if_index, uint64_t *stats);
+extern void nss_session_stats_exit(void);
+
+/*
+ * APIs provided by nss_conn_sync.c
+ */
+extern int nss_conn_sync_enable;
+extern struct ctl_table nss_conn_sync_table[];
+extern void nss_conn_sync_init(void);
+extern void nss_conn_sync_exit(void);
+extern void nss_conn_sync_ipv4_record(struct nss_ipv4_conn_sync *nirs);
+extern void nss_conn_sync_ipv6_record(struct nss_ipv6_conn_sync *nics);
+
+/*
+ * APIs provided by nss_flow_stats.c
+ */
+extern int nss_flow_stats_enable;
+extern struct ctl_table nss_flow_stats_table[];
+extern void nss_flow_stats_init(void);
+extern void nss_flow_stats_exit(void);
+extern void nss_flow_stats_ipv4_sync(struct nss_ipv4_conn_sync *nirs);
+extern void nss_flow_stats_ipv6_sync(struct nss_ipv6_conn_sync *nics);
+
+/*
+ * APIs provided by nss_msg_lat.c
+ */
+extern int nss_msg_lat_enable;
+extern int nss_msg_lat_enable_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos);
+extern void nss_msg_lat_init(void);
+extern void nss_msg_lat_exit(void);
+extern void nss_msg_lat_tx(struct nss_ctx_instance *nss_ctx, struct nss_cmn_msg *ncm);
+extern void nss_msg_lat_rx(struct nss_ctx_instance *nss_ctx, struct nss_cmn_msg *ncm);
+
+/*
+ * APIs provided by nss_pkt_lat.c
+ */
+extern int nss_pkt_lat_enable;
+extern struct ctl_table nss_pkt_lat_table[];
+extern void nss_pkt_lat_init(void);
+extern void nss_pkt_lat_exit(void);
+extern void nss_pkt_lat_h2n_queued(struct hlos_h2n_desc_rings *h2n_desc_ring, uint32_t if_num, uint32_t index,
+				struct sk_buff *nbuf, bool is_bounce);
+extern void nss_pkt_lat_h2n_retire(struct nss_ctx_instance *nss_ctx, struct hlos_h2n_desc_rings *h2n_desc_ring, uint32_t nss_index);
+extern void nss_pkt_lat_rx(struct nss_ctx_instance *nss_ctx, struct n2h_descriptor *desc, uint8_t buffer_type, struct sk_buff *nbuf);
+
+/*
+ * APIs provided by nss_stats_genl.c
+ */
+extern void nss_stats_genl_init(void);
+extern void nss_stats_genl_exit(void);
+extern void nss_stats_genl_sync_notify(struct nss_ctx_instance *nss_ctx, uint32_t group, uint32_t instance);
+extern void nss_stats_genl_conn_sync_notify(struct nss_ctx_instance *nss_ctx, uint32_t group, void *sync, size_t len, uint32_t count);
 
 /*
  * APIs provided by nss_log.c
  */
 extern void nss_log_init(void);
+extern void nss_log_exit(void);
 extern bool nss_debug_log_buffer_alloc(uint8_t nss_id, uint32_t nentry);
 extern int nss_logbuffer_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos);
 
+/*
+ * APIs provided by nss_freq.c
+ */
+#define NSS_FREQ_GOVERNOR_NAME_LEN 16
+extern char nss_freq_governor_name[NSS_FREQ_GOVERNOR_NAME_LEN];
+extern int nss_freq_pid_kp;
+extern int nss_freq_pid_ki;
+extern int nss_freq_pid_kd;
+extern int nss_freq_pid_ewma_shift;
+extern int nss_freq_pid_target;
+extern int nss_freq_pid_ring_target;
+extern int nss_freq_pid_ring_gain;
+extern int nss_freq_pid_up_threshold;
+extern int nss_freq_pid_down_threshold;
+extern int nss_freq_pid_down_hold;
+extern int nss_freq_governor_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos);
+extern char nss_freq_perf_policy_name[NSS_FREQ_GOVERNOR_NAME_LEN];
+extern int nss_freq_perf_nominal_mbps;
+extern int nss_freq_perf_turbo_mbps;
+extern int nss_freq_perf_nominal_kpps;
+extern int nss_freq_perf_turbo_kpps;
+extern int nss_freq_perf_down_hold;
+extern int nss_freq_perf_policy_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos);
+extern uint32_t nss_freq_perf_level_get(uint32_t frequency);
+extern void nss_freq_perf_reset(void);
+extern void nss_freq_transition_start(uint32_t to, const char *trigger);
+extern void nss_freq_stats_init(void);
+extern void nss_freq_stats_exit(void);
+
 /*
  * APIs to set jumbo_mru & paged_mode
  */
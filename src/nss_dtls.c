@@ -19,12 +19,6 @@
 
 #define NSS_DTLS_TX_TIMEOUT 3000 /* 3 Seconds */
 
-/*
- * Data structures to store DTLS nss debug stats
- */
-static DEFINE_SPINLOCK(nss_dtls_session_debug_stats_lock);
-static struct nss_stats_dtls_session_debug nss_dtls_session_debug_stats[NSS_MAX_DTLS_SESSIONS];
-
 /*
  * Private data structure
  */
@@ -53,6 +47,15 @@ static bool nss_dtls_verify_if_num(uint32_t if_num)
 	return true;
 }
 
+/*
+ * nss_dtls_get_if_context()
+ *	Context of the core a DTLS session was placed on
+ */
+static inline struct nss_ctx_instance *nss_dtls_get_if_context(uint32_t if_num)
+{
+	return nss_dynamic_interface_get_nss_ctx(if_num, NSS_DYNAMIC_INTERFACE_TYPE_DTLS);
+}
+
 /*
  * nss_dtls_session_stats_sync
  *	Per DTLS session debug stats
@@ -61,60 +64,49 @@ static void nss_dtls_session_stats_sync(struct nss_ctx_instance *nss_ctx,
 					struct nss_dtls_session_stats *stats_msg,
 					uint16_t if_num)
 {
-	int i;
-	struct nss_stats_dtls_session_debug *s = NULL;
+	uint64_t *stats;
 
 	NSS_VERIFY_CTX_MAGIC(nss_ctx);
 
-	spin_lock_bh(&nss_dtls_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_DTLS_SESSIONS; i++) {
-		if (nss_dtls_session_debug_stats[i].if_num != if_num) {
-			continue;
-		}
-
-		s = &nss_dtls_session_debug_stats[i];
-		break;
-	}
-
-	if (!s) {
-		spin_unlock_bh(&nss_dtls_session_debug_stats_lock);
+	stats = nss_session_stats_update_begin(NSS_SESSION_STATS_TYPE_DTLS, if_num);
+	if (!stats) {
 		return;
 	}
 
-	s->stats[NSS_STATS_DTLS_SESSION_RX_PKTS] += stats_msg->node_stats.rx_packets;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_PKTS] += stats_msg->node_stats.tx_packets;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_DROPPED] += stats_msg->node_stats.rx_dropped;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_AUTH_DONE] += stats_msg->rx_auth_done;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_AUTH_DONE] += stats_msg->tx_auth_done;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_CIPHER_DONE] += stats_msg->rx_cipher_done;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_CIPHER_DONE] += stats_msg->tx_cipher_done;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_CBUF_ALLOC_FAIL] += stats_msg->rx_cbuf_alloc_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_CBUF_ALLOC_FAIL] += stats_msg->tx_cbuf_alloc_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_CENQUEUE_FAIL] += stats_msg->tx_cenqueue_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_CENQUEUE_FAIL] += stats_msg->rx_cenqueue_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_DROPPED_HROOM] += stats_msg->tx_dropped_hroom;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_DROPPED_TROOM] += stats_msg->tx_dropped_troom;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_FORWARD_ENQUEUE_FAIL] += stats_msg->tx_forward_enqueue_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_FORWARD_ENQUEUE_FAIL] += stats_msg->rx_forward_enqueue_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_INVALID_VERSION] += stats_msg->rx_invalid_version;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_INVALID_EPOCH] += stats_msg->rx_invalid_epoch;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_MALFORMED] += stats_msg->rx_malformed;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_CIPHER_FAIL] += stats_msg->rx_cipher_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_AUTH_FAIL] += stats_msg->rx_auth_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_CAPWAP_CLASSIFY_FAIL] += stats_msg->rx_capwap_classify_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_SINGLE_REC_DGRAM] += stats_msg->rx_single_rec_dgram;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_MULTI_REC_DGRAM] += stats_msg->rx_multi_rec_dgram;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_REPLAY_FAIL] += stats_msg->rx_replay_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_REPLAY_DUPLICATE] += stats_msg->rx_replay_duplicate;
-	s->stats[NSS_STATS_DTLS_SESSION_RX_REPLAY_OUT_OF_WINDOW] += stats_msg->rx_replay_out_of_window;
-	s->stats[NSS_STATS_DTLS_SESSION_OUTFLOW_QUEUE_FULL] += stats_msg->outflow_queue_full;
-	s->stats[NSS_STATS_DTLS_SESSION_DECAP_QUEUE_FULL] += stats_msg->decap_queue_full;
-	s->stats[NSS_STATS_DTLS_SESSION_PBUF_ALLOC_FAIL] += stats_msg->pbuf_alloc_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_PBUF_COPY_FAIL] += stats_msg->pbuf_copy_fail;
-	s->stats[NSS_STATS_DTLS_SESSION_EPOCH] = stats_msg->epoch;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_SEQ_HIGH] = stats_msg->tx_seq_high;
-	s->stats[NSS_STATS_DTLS_SESSION_TX_SEQ_LOW] = stats_msg->tx_seq_low;
-	spin_unlock_bh(&nss_dtls_session_debug_stats_lock);
+	stats[NSS_STATS_DTLS_SESSION_RX_PKTS] += stats_msg->node_stats.rx_packets;
+	stats[NSS_STATS_DTLS_SESSION_TX_PKTS] += stats_msg->node_stats.tx_packets;
+	stats[NSS_STATS_DTLS_SESSION_RX_DROPPED] += stats_msg->node_stats.rx_dropped;
+	stats[NSS_STATS_DTLS_SESSION_RX_AUTH_DONE] += stats_msg->rx_auth_done;
+	stats[NSS_STATS_DTLS_SESSION_TX_AUTH_DONE] += stats_msg->tx_auth_done;
+	stats[NSS_STATS_DTLS_SESSION_RX_CIPHER_DONE] += stats_msg->rx_cipher_done;
+	stats[NSS_STATS_DTLS_SESSION_TX_CIPHER_DONE] += stats_msg->tx_cipher_done;
+	stats[NSS_STATS_DTLS_SESSION_RX_CBUF_ALLOC_FAIL] += stats_msg->rx_cbuf_alloc_fail;
+	stats[NSS_STATS_DTLS_SESSION_TX_CBUF_ALLOC_FAIL] += stats_msg->tx_cbuf_alloc_fail;
+	stats[NSS_STATS_DTLS_SESSION_TX_CENQUEUE_FAIL] += stats_msg->tx_cenqueue_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_CENQUEUE_FAIL] += stats_msg->rx_cenqueue_fail;
+	stats[NSS_STATS_DTLS_SESSION_TX_DROPPED_HROOM] += stats_msg->tx_dropped_hroom;
+	stats[NSS_STATS_DTLS_SESSION_TX_DROPPED_TROOM] += stats_msg->tx_dropped_troom;
+	stats[NSS_STATS_DTLS_SESSION_TX_FORWARD_ENQUEUE_FAIL] += stats_msg->tx_forward_enqueue_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_FORWARD_ENQUEUE_FAIL] += stats_msg->rx_forward_enqueue_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_INVALID_VERSION] += stats_msg->rx_invalid_version;
+	stats[NSS_STATS_DTLS_SESSION_RX_INVALID_EPOCH] += stats_msg->rx_invalid_epoch;
+	stats[NSS_STATS_DTLS_SESSION_RX_MALFORMED] += stats_msg->rx_malformed;
+	stats[NSS_STATS_DTLS_SESSION_RX_CIPHER_FAIL] += stats_msg->rx_cipher_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_AUTH_FAIL] += stats_msg->rx_auth_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_CAPWAP_CLASSIFY_FAIL] += stats_msg->rx_capwap_classify_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_SINGLE_REC_DGRAM] += stats_msg->rx_single_rec_dgram;
+	stats[NSS_STATS_DTLS_SESSION_RX_MULTI_REC_DGRAM] += stats_msg->rx_multi_rec_dgram;
+	stats[NSS_STATS_DTLS_SESSION_RX_REPLAY_FAIL] += stats_msg->rx_replay_fail;
+	stats[NSS_STATS_DTLS_SESSION_RX_REPLAY_DUPLICATE] += stats_msg->rx_replay_duplicate;
+	stats[NSS_STATS_DTLS_SESSION_RX_REPLAY_OUT_OF_WINDOW] += stats_msg->rx_replay_out_of_window;
+	stats[NSS_STATS_DTLS_SESSION_OUTFLOW_QUEUE_FULL] += stats_msg->outflow_queue_full;
+	stats[NSS_STATS_DTLS_SESSION_DECAP_QUEUE_FULL] += stats_msg->decap_queue_full;
+	stats[NSS_STATS_DTLS_SESSION_PBUF_ALLOC_FAIL] += stats_msg->pbuf_alloc_fail;
+	stats[NSS_STATS_DTLS_SESSION_PBUF_COPY_FAIL] += stats_msg->pbuf_copy_fail;
+	stats[NSS_STATS_DTLS_SESSION_EPOCH] = stats_msg->epoch;
+	stats[NSS_STATS_DTLS_SESSION_TX_SEQ_HIGH] = stats_msg->tx_seq_high;
+	stats[NSS_STATS_DTLS_SESSION_TX_SEQ_LOW] = stats_msg->tx_seq_low;
+	nss_session_stats_update_end(stats);
 }
 
 /*
@@ -123,22 +115,21 @@ static void nss_dtls_session_stats_sync(struct nss_ctx_instance *nss_ctx,
  */
 void nss_dtls_session_debug_stats_get(struct nss_stats_dtls_session_debug *stats)
 {
-	int i;
+	int i, n = 0;
 
 	if (!stats) {
 		nss_warning("No memory to copy dtls session stats");
 		return;
 	}
 
-	spin_lock_bh(&nss_dtls_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_DTLS_SESSIONS; i++) {
-		if (nss_dtls_session_debug_stats[i].valid) {
-			memcpy(stats, &nss_dtls_session_debug_stats[i],
-			       sizeof(struct nss_stats_dtls_session_debug));
+	for (i = 0; (i < NSS_MAX_DYNAMIC_INTERFACES) && (n < NSS_MAX_DTLS_SESSIONS); i++) {
+		if (nss_session_stats_read(NSS_SESSION_STATS_TYPE_DTLS, NSS_DYNAMIC_IF_START + i, &stats->if_index, stats->stats)) {
+			stats->if_num = NSS_DYNAMIC_IF_START + i;
+			stats->valid = true;
 			stats++;
+			n++;
 		}
 	}
-	spin_unlock_bh(&nss_dtls_session_debug_stats_lock);
 }
 
 /*
@@ -411,29 +402,10 @@ struct nss_ctx_instance *nss_dtls_register_if(uint32_t if_num,
 					      uint32_t features,
 					      void *app_ctx)
 {
-	int32_t i;
-
-	struct nss_ctx_instance *nss_ctx = nss_dtls_get_context();
+	struct nss_ctx_instance *nss_ctx = nss_dtls_get_if_context(if_num);
 
 	BUG_ON(!nss_dtls_verify_if_num(if_num));
 
-	spin_lock_bh(&nss_dtls_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_DTLS_SESSIONS; i++) {
-		if (!nss_dtls_session_debug_stats[i].valid) {
-			nss_dtls_session_debug_stats[i].valid = true;
-			nss_dtls_session_debug_stats[i].if_num = if_num;
-			nss_dtls_session_debug_stats[i].if_index = netdev->ifindex;
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_dtls_session_debug_stats_lock);
-
-	if (i == NSS_MAX_DTLS_SESSIONS) {
-		nss_warning("%p: Cannot find free slot for "
-			    "DTLS session stats, I/F:%u\n", nss_ctx, if_num);
-		return NULL;
-	}
-
 	if (nss_top_main.subsys_dp_register[if_num].ndev) {
 		nss_warning("%p: Cannot find free slot for "
 			    "DTLS NSS I/F:%u\n", nss_ctx, if_num);
@@ -441,6 +413,12 @@ struct nss_ctx_instance *nss_dtls_register_if(uint32_t if_num,
 		return NULL;
 	}
 
+	if (nss_session_stats_add(NSS_SESSION_STATS_TYPE_DTLS, if_num, netdev->ifindex)) {
+		nss_warning("%p: Cannot allocate "
+			    "DTLS session stats, I/F:%u\n", nss_ctx, if_num);
+		return NULL;
+	}
+
 	nss_top_main.subsys_dp_register[if_num].ndev = netdev;
 	nss_top_main.subsys_dp_register[if_num].cb = cb;
 	nss_top_main.subsys_dp_register[if_num].app_data = app_ctx;
@@ -449,7 +427,7 @@ struct nss_ctx_instance *nss_dtls_register_if(uint32_t if_num,
 	nss_top_main.dtls_msg_callback = ev_cb;
 	nss_core_register_handler(if_num, nss_dtls_handler, app_ctx);
 
-	return (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.dtls_handler_id];
+	return nss_ctx;
 }
 EXPORT_SYMBOL(nss_dtls_register_if);
 
@@ -458,27 +436,11 @@ EXPORT_SYMBOL(nss_dtls_register_if);
  */
 void nss_dtls_unregister_if(uint32_t if_num)
 {
-	int32_t i;
-
-	struct nss_ctx_instance *nss_ctx = nss_dtls_get_context();
+	struct nss_ctx_instance *nss_ctx = nss_dtls_get_if_context(if_num);
 
 	BUG_ON(!nss_dtls_verify_if_num(if_num));
 
-	spin_lock_bh(&nss_dtls_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_DTLS_SESSIONS; i++) {
-		if (nss_dtls_session_debug_stats[i].if_num == if_num) {
-			memset(&nss_dtls_session_debug_stats[i], 0,
-			       sizeof(struct nss_stats_dtls_session_debug));
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_dtls_session_debug_stats_lock);
-
-	if (i == NSS_MAX_DTLS_SESSIONS) {
-		nss_warning("%p: Cannot find debug stats for "
-			    "DTLS session %d\n", nss_ctx, if_num);
-		return;
-	}
+	nss_session_stats_del(NSS_SESSION_STATS_TYPE_DTLS, if_num);
 
 	if (!nss_top_main.subsys_dp_register[if_num].ndev) {
 		nss_warning("%p: Cannot find registered netdev for "
@@ -499,10 +461,12 @@ EXPORT_SYMBOL(nss_dtls_unregister_if);
 
 /*
  * nss_get_dtls_context()
+ *	Default core of DTLS; a session may have been placed on another core,
+ *	see nss_dynamic_interface_get_nss_ctx().
  */
 struct nss_ctx_instance *nss_dtls_get_context(void)
 {
-	return (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.dtls_handler_id];
+	return nss_dynamic_interface_get_nss_ctx(-1, NSS_DYNAMIC_INTERFACE_TYPE_DTLS);
 }
 EXPORT_SYMBOL(nss_dtls_get_context);
 
@@ -519,10 +483,11 @@ EXPORT_SYMBOL(nss_dtls_msg_init);
 
 /*
  * nss_dtls_get_ifnum_with_coreid()
+ *	Append the id of the core the session was placed on
  */
 int32_t nss_dtls_get_ifnum_with_coreid(int32_t if_num)
 {
-	struct nss_ctx_instance *nss_ctx = nss_dtls_get_context();
+	struct nss_ctx_instance *nss_ctx = nss_dtls_get_if_context(if_num);
 
 	NSS_VERIFY_CTX_MAGIC(nss_ctx);
 	return NSS_INTERFACE_NUM_APPEND_COREID(nss_ctx, if_num);
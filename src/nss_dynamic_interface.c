@@ -15,11 +15,79 @@
  */
 
 #include "nss_tx_rx_common.h"
+#include <linux/debugfs.h>
+#include <linux/sysctl.h>
 
 #define NSS_DYNAMIC_INTERFACE_COMP_TIMEOUT 60000	/* 60 Sec */
+#define NSS_DYNAMIC_INTERFACE_POOL_MAX 16		/* Most nodes kept ready per type */
+
+/*
+ * Weights of the placement score terms, each term is a percentage
+ */
+#define NSS_DYNAMIC_INTERFACE_WEIGHT_LOAD 4		/* INST_CNT relative to the busiest candidate */
+#define NSS_DYNAMIC_INTERFACE_WEIGHT_RING 2		/* Data H2N ring occupancy */
+#define NSS_DYNAMIC_INTERFACE_WEIGHT_IFS 1		/* Dynamic interfaces already on the core */
 
 static struct nss_dynamic_interface_pvt di;
 
+/*
+ * Nodes already allocated on the NSS and waiting to be handed out.
+ *
+ * The pool is a stack so that taking a node is O(1) under a spinlock; the
+ * firmware round trips happen in the refill work.
+ */
+struct nss_dynamic_interface_pool {
+	int if_num[NSS_DYNAMIC_INTERFACE_POOL_MAX];	/* Ready interface numbers */
+	uint32_t count;					/* Entries in if_num[] */
+	uint32_t target;				/* Entries the refill work keeps ready */
+	uint64_t hits;					/* Allocations served from the pool */
+	uint64_t misses;				/* Allocations that went to the NSS */
+	uint64_t refilled;				/* Nodes added by the refill work */
+	uint64_t refill_failed;				/* Refill allocations the NSS refused */
+};
+
+static struct nss_dynamic_interface_pool nss_dynamic_interface_pools[NSS_DYNAMIC_INTERFACE_TYPE_MAX];
+static DEFINE_SPINLOCK(nss_dynamic_interface_pool_lock);
+static struct work_struct nss_dynamic_interface_pool_work;
+static bool nss_dynamic_interface_pool_stopping;
+static struct dentry *nss_dynamic_interface_pool_dentry;
+
+/*
+ * Placement of dynamic interfaces on cores.
+ *
+ * A type runs on every core whose firmware enables it. With more than one
+ * candidate and placement_auto set, a new node goes to the core with the
+ * lowest score unless the administrator pinned the type to a core.
+ *
+ * di.type[], the recorded core, the data plane registry and the session
+ * stats are all keyed by interface number alone. That is only sound while
+ * the firmware hands out distinct numbers across cores, so nodes stay on
+ * the default core of their type unless an administrator opts in.
+ */
+static int nss_dynamic_interface_placement_auto = 0;
+static int nss_dynamic_interface_core_override[NSS_DYNAMIC_INTERFACE_TYPE_MAX] = {
+	[0 ... NSS_DYNAMIC_INTERFACE_TYPE_MAX - 1] = -1
+};
+static int nss_dynamic_interface_core_min = -1;
+static int nss_dynamic_interface_core_max = NSS_MAX_CORES - 1;
+static uint8_t nss_dynamic_interface_core[NSS_MAX_DYNAMIC_INTERFACES];
+static atomic_t nss_dynamic_interface_core_ifs[NSS_MAX_CORES];
+static uint64_t nss_dynamic_interface_core_placed[NSS_MAX_CORES];
+static struct dentry *nss_dynamic_interface_placement_dentry;
+
+/*
+ * Bulk deallocation state, owned by the holder of di.sem.
+ *
+ * Responses carry the generation in app_data so that late answers to a
+ * batch that timed out do not count against the next one.
+ */
+static struct {
+	struct completion complete;
+	atomic_t pending;
+	atomic_t nacks;
+	unsigned long generation;
+} nss_dynamic_interface_bulk;
+
 /*
  * nss_dynamic_interface_handler()
  * 	Handle NSS -> HLOS messages for dynamic interfaces
@@ -59,8 +127,10 @@ static void nss_dynamic_interface_handler(struct nss_ctx_instance *nss_ctx, stru
 			nss_info("%p alloc_node response ack if_num %d\n", nss_ctx, ndim->msg.alloc_node.if_num);
 			di.current_if_num = ndim->msg.alloc_node.if_num;
 			if_num = di.current_if_num;
-			if (if_num > 0) {
+			if (nss_is_dynamic_interface(if_num)) {
 				di.type[if_num - NSS_DYNAMIC_IF_START] = ndim->msg.alloc_node.type;
+				nss_dynamic_interface_core[if_num - NSS_DYNAMIC_IF_START] = nss_ctx->id;
+				atomic_inc(&nss_dynamic_interface_core_ifs[nss_ctx->id]);
 			} else {
 				nss_warning("%p: if_num < 0\n", nss_ctx);
 			}
@@ -73,7 +143,10 @@ static void nss_dynamic_interface_handler(struct nss_ctx_instance *nss_ctx, stru
 			nss_info("%p dealloc_node response ack if_num %d\n", nss_ctx, ndim->msg.dealloc_node.if_num);
 			di.current_if_num = ndim->msg.dealloc_node.if_num;
 			if_num = di.current_if_num;
-			di.type[if_num - NSS_DYNAMIC_IF_START] = NSS_DYNAMIC_INTERFACE_TYPE_NONE;
+			if (nss_is_dynamic_interface(if_num)) {
+				di.type[if_num - NSS_DYNAMIC_IF_START] = NSS_DYNAMIC_INTERFACE_TYPE_NONE;
+				atomic_dec(&nss_dynamic_interface_core_ifs[nss_dynamic_interface_core[if_num - NSS_DYNAMIC_IF_START]]);
+			}
 		}
 
 		break;
@@ -112,11 +185,34 @@ static void nss_dynamic_interface_callback(void *app_data, struct nss_cmn_msg *n
 	complete(&di.complete);
 }
 
+/*
+ * nss_dynamic_interface_bulk_callback()
+ *	Count down the responses of a bulk deallocation
+ */
+static void nss_dynamic_interface_bulk_callback(void *app_data, struct nss_cmn_msg *ncm)
+{
+	if ((unsigned long)app_data != nss_dynamic_interface_bulk.generation) {
+		return;
+	}
+
+	if (ncm->response != NSS_CMN_RESPONSE_ACK) {
+		atomic_inc(&nss_dynamic_interface_bulk.nacks);
+	}
+
+	if (atomic_dec_and_test(&nss_dynamic_interface_bulk.pending)) {
+		complete(&nss_dynamic_interface_bulk.complete);
+	}
+}
+
 /*
  * nss_dynamic_interface_tx_sync()
  *	Send the message to NSS and wait till we get an ACK or NACK for this msg.
+ *
+ * The response and the interface number are copied out before the semaphore
+ * is released, the next caller overwrites them.
  */
-static nss_tx_status_t nss_dynamic_interface_tx_sync(struct nss_ctx_instance *nss_ctx, struct nss_dynamic_interface_msg *ndim)
+static nss_tx_status_t nss_dynamic_interface_tx_sync(struct nss_ctx_instance *nss_ctx, struct nss_dynamic_interface_msg *ndim,
+							enum nss_cmn_response *response, int *if_num)
 {
 	nss_tx_status_t status;
 	int ret;
@@ -144,6 +240,8 @@ static nss_tx_status_t nss_dynamic_interface_tx_sync(struct nss_ctx_instance *ns
 		return NSS_TX_FAILURE;
 	}
 
+	*response = di.response;
+	*if_num = di.current_if_num;
 	up(&di.sem);
 	return status;
 }
@@ -212,26 +310,121 @@ nss_tx_status_t nss_dynamic_interface_tx(struct nss_ctx_instance *nss_ctx, struc
 }
 
 /*
- * nss_dynamic_interface_alloc_node()
- *	Allocates node of perticular type on NSS and returns interface_num for this node or -1 in case of failure.
+ * nss_dynamic_interface_core_score()
+ *	Placement score of a core, lower is better
+ */
+static uint32_t nss_dynamic_interface_core_score(struct nss_ctx_instance *nss_ctx, uint32_t inst_cnt_max)
+{
+	struct nss_if_mem_map *if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
+	struct hlos_h2n_desc_rings *h2n = &nss_ctx->h2n_desc_rings[NSS_IF_DATA_QUEUE_0];
+	uint32_t size = h2n->desc_ring.size;
+	uint32_t load = 0;
+	uint32_t ring = 0;
+	uint32_t ifs;
+
+	if (inst_cnt_max) {
+		load = (uint32_t)div_u64((uint64_t)nss_ctx->inst_cnt_total * 100, inst_cnt_max);
+	}
+
+	if (size) {
+		ring = (size - 1 - nss_core_h2n_ring_free(if_map->h2n_nss_index[NSS_IF_DATA_QUEUE_0], h2n->hlos_index, size)) * 100 / size;
+	}
+
+	ifs = atomic_read(&nss_dynamic_interface_core_ifs[nss_ctx->id]) * 100 / NSS_MAX_DYNAMIC_INTERFACES;
+
+	return (load * NSS_DYNAMIC_INTERFACE_WEIGHT_LOAD) + (ring * NSS_DYNAMIC_INTERFACE_WEIGHT_RING)
+		+ (ifs * NSS_DYNAMIC_INTERFACE_WEIGHT_IFS);
+}
+
+/*
+ * nss_dynamic_interface_core_select()
+ *	Pick the core a new node of a type is allocated on
+ */
+static uint32_t nss_dynamic_interface_core_select(enum nss_dynamic_interface_type type)
+{
+	uint32_t cores = nss_top_main.dynamic_interface_cores[type];
+	uint32_t core_id = nss_top_main.dynamic_interface_table[type];
+	int override = nss_dynamic_interface_core_override[type];
+	struct nss_ctx_instance *nss_ctx;
+	uint32_t inst_cnt_max = 0;
+	uint32_t best = (uint32_t)-1;
+	uint32_t score;
+	uint32_t i;
+
+	if ((override >= 0) && (cores & (1 << override))) {
+		return override;
+	}
+
+	if (!nss_dynamic_interface_placement_auto || (hweight32(cores) < 2)) {
+		return core_id;
+	}
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		if ((cores & (1 << i)) && (nss_top_main.nss[i].inst_cnt_total > inst_cnt_max)) {
+			inst_cnt_max = nss_top_main.nss[i].inst_cnt_total;
+		}
+	}
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		nss_ctx = &nss_top_main.nss[i];
+		if (!(cores & (1 << i)) || (nss_ctx->state != NSS_CORE_STATE_INITIALIZED)) {
+			continue;
+		}
+
+		score = nss_dynamic_interface_core_score(nss_ctx, inst_cnt_max);
+		if (score < best) {
+			best = score;
+			core_id = i;
+		}
+	}
+
+	return core_id;
+}
+
+/*
+ * nss_dynamic_interface_get_core()
+ *	Core a dynamic interface was allocated on.
  *
- * Note: This function should not be called from soft_irq or interrupt context because it blocks till ACK/NACK is
- * received for the message sent to NSS.
+ * Interfaces not allocated through this driver report the default core
+ * of their type.
  */
-int nss_dynamic_interface_alloc_node(enum nss_dynamic_interface_type type)
+uint32_t nss_dynamic_interface_get_core(int if_num, enum nss_dynamic_interface_type type)
+{
+	if (nss_is_dynamic_interface(if_num) && (di.type[if_num - NSS_DYNAMIC_IF_START] != NSS_DYNAMIC_INTERFACE_TYPE_NONE)) {
+		return nss_dynamic_interface_core[if_num - NSS_DYNAMIC_IF_START];
+	}
+
+	if (type >= NSS_DYNAMIC_INTERFACE_TYPE_MAX) {
+		return 0;
+	}
+
+	return nss_top_main.dynamic_interface_table[type];
+}
+
+/*
+ * nss_dynamic_interface_get_nss_ctx()
+ *	Context of the core a dynamic interface was allocated on
+ */
+struct nss_ctx_instance *nss_dynamic_interface_get_nss_ctx(int if_num, enum nss_dynamic_interface_type type)
+{
+	return &nss_top_main.nss[nss_dynamic_interface_get_core(if_num, type)];
+}
+
+/*
+ * nss_dynamic_interface_alloc_node_sync()
+ *	Allocate a node on the NSS and wait for its interface number
+ */
+static int nss_dynamic_interface_alloc_node_sync(enum nss_dynamic_interface_type type)
 {
 	struct nss_ctx_instance *nss_ctx = NULL;
 	struct nss_dynamic_interface_msg ndim;
 	struct nss_dynamic_interface_alloc_node_msg *ndia;
+	enum nss_cmn_response response;
 	uint32_t core_id;
+	int if_num;
 	nss_tx_status_t status;
 
-	if (type >= NSS_DYNAMIC_INTERFACE_TYPE_MAX) {
-		nss_warning("Dynamic if msg drooped as type is wrong %d\n", type);
-		return -1;
-	}
-
-	core_id = nss_top_main.dynamic_interface_table[type];
+	core_id = nss_dynamic_interface_core_select(type);
 	nss_ctx = (struct nss_ctx_instance *)&nss_top_main.nss[core_id];
 
 	nss_dynamic_interface_msg_init(&ndim, NSS_DYNAMIC_INTERFACE, NSS_DYNAMIC_INTERFACE_ALLOC_NODE,
@@ -249,21 +442,64 @@ int nss_dynamic_interface_alloc_node(enum nss_dynamic_interface_type type)
 	/*
 	 * Calling synchronous transmit function.
 	 */
-	status = nss_dynamic_interface_tx_sync(nss_ctx, &ndim);
+	status = nss_dynamic_interface_tx_sync(nss_ctx, &ndim, &response, &if_num);
 	if (status != NSS_TX_SUCCESS) {
 		nss_warning("%p not able to transmit alloc node msg\n", nss_ctx);
 		return -1;
 	}
 
 	/*
-	 * Check di.response and return -1 if its a NACK else proceed.
+	 * Check the response and return -1 if its a NACK else proceed.
 	 */
-	if (di.response != NSS_CMN_RESPONSE_ACK) {
+	if (response != NSS_CMN_RESPONSE_ACK) {
 		nss_warning("%p Received NACK from NSS\n", nss_ctx);
 		return -1;
 	}
 
-	return di.current_if_num;
+	nss_dynamic_interface_core_placed[core_id]++;
+	return if_num;
+}
+
+/*
+ * nss_dynamic_interface_alloc_node()
+ *	Allocates node of perticular type on NSS and returns interface_num for this node or -1 in case of failure.
+ *
+ * A node reserved with nss_dynamic_interface_pool_reserve() is handed out
+ * without a firmware round trip when one is ready.
+ *
+ * Note: This function should not be called from soft_irq or interrupt context because it blocks till ACK/NACK is
+ * received for the message sent to NSS.
+ */
+int nss_dynamic_interface_alloc_node(enum nss_dynamic_interface_type type)
+{
+	struct nss_dynamic_interface_pool *pool;
+	int if_num = -1;
+
+	if (type >= NSS_DYNAMIC_INTERFACE_TYPE_MAX) {
+		nss_warning("Dynamic if msg drooped as type is wrong %d\n", type);
+		return -1;
+	}
+
+	pool = &nss_dynamic_interface_pools[type];
+
+	spin_lock_bh(&nss_dynamic_interface_pool_lock);
+	if (pool->count) {
+		if_num = pool->if_num[--pool->count];
+		pool->hits++;
+	} else if (pool->target) {
+		pool->misses++;
+	}
+
+	if (pool->count < pool->target && !nss_dynamic_interface_pool_stopping) {
+		schedule_work(&nss_dynamic_interface_pool_work);
+	}
+	spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+	if (if_num >= 0) {
+		return if_num;
+	}
+
+	return nss_dynamic_interface_alloc_node_sync(type);
 }
 
 /*
@@ -280,6 +516,8 @@ nss_tx_status_t nss_dynamic_interface_dealloc_node(int if_num, enum nss_dynamic_
 	struct nss_dynamic_interface_msg ndim;
 	struct nss_dynamic_interface_dealloc_node_msg *ndid;
 	uint32_t core_id;
+	enum nss_cmn_response response;
+	int resp_if_num;
 	nss_tx_status_t status;
 
 	if (type >= NSS_DYNAMIC_INTERFACE_TYPE_MAX) {
@@ -287,7 +525,7 @@ nss_tx_status_t nss_dynamic_interface_dealloc_node(int if_num, enum nss_dynamic_
 		return NSS_TX_FAILURE_BAD_PARAM;
 	}
 
-	core_id = nss_top_main.dynamic_interface_table[type];
+	core_id = nss_dynamic_interface_get_core(if_num, type);
 	nss_ctx = (struct nss_ctx_instance *)&nss_top_main.nss[core_id];
 
 	if (nss_is_dynamic_interface(if_num) == false) {
@@ -305,13 +543,13 @@ nss_tx_status_t nss_dynamic_interface_dealloc_node(int if_num, enum nss_dynamic_
 	/*
 	 * Calling synchronous transmit function.
 	 */
-	status = nss_dynamic_interface_tx_sync(nss_ctx, &ndim);
+	status = nss_dynamic_interface_tx_sync(nss_ctx, &ndim, &response, &resp_if_num);
 	if (status != NSS_TX_SUCCESS) {
 		nss_warning("%p not able to transmit alloc node msg\n", nss_ctx);
 		return status;
 	}
 
-	if (di.response != NSS_CMN_RESPONSE_ACK) {
+	if (response != NSS_CMN_RESPONSE_ACK) {
 		nss_warning("%p Received NACK from NSS\n", nss_ctx);
 		return -1;
 	}
@@ -319,6 +557,377 @@ nss_tx_status_t nss_dynamic_interface_dealloc_node(int if_num, enum nss_dynamic_
 	return status;
 }
 
+/*
+ * nss_dynamic_interface_dealloc_nodes()
+ *	Deallocate a batch of nodes of one type in NSS.
+ *
+ * All messages are queued before waiting, so a teardown of many tunnels
+ * costs one firmware round trip instead of one per node. Blocks like
+ * nss_dynamic_interface_dealloc_node().
+ */
+nss_tx_status_t nss_dynamic_interface_dealloc_nodes(int *if_nums, uint32_t count, enum nss_dynamic_interface_type type)
+{
+	struct nss_ctx_instance *nss_ctx = NULL;
+	struct nss_dynamic_interface_msg ndim;
+	struct nss_dynamic_interface_dealloc_node_msg *ndid;
+	nss_tx_status_t status = NSS_TX_SUCCESS;
+	unsigned long generation;
+	uint32_t core_id;
+	uint32_t i;
+	int ret;
+
+	if (type >= NSS_DYNAMIC_INTERFACE_TYPE_MAX) {
+		nss_warning("Dynamic if msg dropped as type is wrong type %d\n", type);
+		return NSS_TX_FAILURE_BAD_PARAM;
+	}
+
+	if (!count) {
+		return NSS_TX_SUCCESS;
+	}
+
+	nss_ctx = (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.dynamic_interface_table[type]];
+
+	for (i = 0; i < count; i++) {
+		if (nss_is_dynamic_interface(if_nums[i]) == false) {
+			nss_warning("%p: nss_dynamic_interface if_num is not in range %d\n", nss_ctx, if_nums[i]);
+			return NSS_TX_FAILURE_BAD_PARAM;
+		}
+	}
+
+	down(&di.sem);
+
+	generation = ++nss_dynamic_interface_bulk.generation;
+	init_completion(&nss_dynamic_interface_bulk.complete);
+	atomic_set(&nss_dynamic_interface_bulk.nacks, 0);
+
+	/*
+	 * One extra count keeps the completion from firing before every
+	 * message has been queued.
+	 */
+	atomic_set(&nss_dynamic_interface_bulk.pending, count + 1);
+
+	for (i = 0; i < count; i++) {
+		nss_dynamic_interface_msg_init(&ndim, NSS_DYNAMIC_INTERFACE, NSS_DYNAMIC_INTERFACE_DEALLOC_NODE,
+					sizeof(struct nss_dynamic_interface_dealloc_node_msg),
+					nss_dynamic_interface_bulk_callback, (void *)generation);
+
+		ndid = &ndim.msg.dealloc_node;
+		ndid->type = type;
+		ndid->if_num = if_nums[i];
+
+		core_id = nss_dynamic_interface_get_core(if_nums[i], type);
+		nss_ctx = (struct nss_ctx_instance *)&nss_top_main.nss[core_id];
+		if (nss_dynamic_interface_tx(nss_ctx, &ndim) != NSS_TX_SUCCESS) {
+			nss_warning("%p not able to transmit dealloc node msg for %d\n", nss_ctx, if_nums[i]);
+			atomic_inc(&nss_dynamic_interface_bulk.nacks);
+			atomic_dec(&nss_dynamic_interface_bulk.pending);
+		}
+	}
+
+	if (!atomic_dec_and_test(&nss_dynamic_interface_bulk.pending)) {
+		ret = wait_for_completion_timeout(&nss_dynamic_interface_bulk.complete,
+						msecs_to_jiffies(NSS_DYNAMIC_INTERFACE_COMP_TIMEOUT));
+		if (ret == 0) {
+			nss_warning("%p: Waiting for %d dealloc acks timed out\n", nss_ctx,
+					atomic_read(&nss_dynamic_interface_bulk.pending));
+			status = NSS_TX_FAILURE;
+		}
+	}
+
+	if (atomic_read(&nss_dynamic_interface_bulk.nacks)) {
+		nss_warning("%p: %d of %u dealloc node msgs failed\n", nss_ctx,
+				atomic_read(&nss_dynamic_interface_bulk.nacks), count);
+		status = NSS_TX_FAILURE;
+	}
+
+	up(&di.sem);
+	return status;
+}
+
+/*
+ * nss_dynamic_interface_pool_refill()
+ *	Bring every pool up to its target, one firmware round trip at a time
+ */
+static void nss_dynamic_interface_pool_refill(struct work_struct *work)
+{
+	struct nss_dynamic_interface_pool *pool;
+	enum nss_dynamic_interface_type type;
+	bool wanted;
+	int if_num;
+
+	for (type = 0; type < NSS_DYNAMIC_INTERFACE_TYPE_MAX; type++) {
+		pool = &nss_dynamic_interface_pools[type];
+
+		for (;;) {
+			spin_lock_bh(&nss_dynamic_interface_pool_lock);
+			wanted = !nss_dynamic_interface_pool_stopping && (pool->count < pool->target);
+			spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+			if (!wanted) {
+				break;
+			}
+
+			if_num = nss_dynamic_interface_alloc_node_sync(type);
+			if (if_num < 0) {
+				/*
+				 * The next allocation of this type retries
+				 */
+				spin_lock_bh(&nss_dynamic_interface_pool_lock);
+				pool->refill_failed++;
+				spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+				break;
+			}
+
+			spin_lock_bh(&nss_dynamic_interface_pool_lock);
+			if (!nss_dynamic_interface_pool_stopping && (pool->count < pool->target)) {
+				pool->if_num[pool->count++] = if_num;
+				pool->refilled++;
+				if_num = -1;
+			}
+			spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+			/*
+			 * The target dropped while the node was being allocated
+			 */
+			if (if_num >= 0) {
+				nss_dynamic_interface_dealloc_node(if_num, type);
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * nss_dynamic_interface_pool_trim()
+ *	Return the nodes above the target of a pool to the NSS
+ */
+static void nss_dynamic_interface_pool_trim(enum nss_dynamic_interface_type type, uint32_t target)
+{
+	struct nss_dynamic_interface_pool *pool = &nss_dynamic_interface_pools[type];
+	int if_nums[NSS_DYNAMIC_INTERFACE_POOL_MAX];
+	uint32_t count = 0;
+
+	spin_lock_bh(&nss_dynamic_interface_pool_lock);
+	while (pool->count > target) {
+		if_nums[count++] = pool->if_num[--pool->count];
+	}
+	spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+	nss_dynamic_interface_dealloc_nodes(if_nums, count, type);
+}
+
+/*
+ * nss_dynamic_interface_pool_reserve()
+ *	Keep a number of nodes of a type allocated ahead of demand.
+ *
+ * Returns the target that was set, it is capped at NSS_DYNAMIC_INTERFACE_POOL_MAX.
+ * A count of 0 returns the pooled nodes to the NSS. May sleep.
+ */
+int nss_dynamic_interface_pool_reserve(enum nss_dynamic_interface_type type, uint32_t count)
+{
+	struct nss_dynamic_interface_pool *pool;
+
+	if (type >= NSS_DYNAMIC_INTERFACE_TYPE_MAX) {
+		nss_warning("Dynamic if pool reserve for wrong type %d\n", type);
+		return -EINVAL;
+	}
+
+	if (count > NSS_DYNAMIC_INTERFACE_POOL_MAX) {
+		count = NSS_DYNAMIC_INTERFACE_POOL_MAX;
+	}
+
+	pool = &nss_dynamic_interface_pools[type];
+
+	spin_lock_bh(&nss_dynamic_interface_pool_lock);
+	pool->target = count;
+	if (pool->count < count && !nss_dynamic_interface_pool_stopping) {
+		schedule_work(&nss_dynamic_interface_pool_work);
+	}
+	spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+	nss_dynamic_interface_pool_trim(type, count);
+	return count;
+}
+
+/*
+ * nss_dynamic_interface_pool_stats_read()
+ *	Read the dynamic interface pool statistics
+ */
+static ssize_t nss_dynamic_interface_pool_stats_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_dynamic_interface_pool *pool;
+	size_t size_al = 2048;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	char *lbuf;
+	int type;
+
+	lbuf = kzalloc(size_al, GFP_KERNEL);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	size_wr = scnprintf(lbuf, size_al, "dynamic_if pool stats start:\n\n");
+
+	spin_lock_bh(&nss_dynamic_interface_pool_lock);
+	for (type = 0; type < NSS_DYNAMIC_INTERFACE_TYPE_MAX; type++) {
+		pool = &nss_dynamic_interface_pools[type];
+		if (!pool->target && !pool->hits && !pool->misses) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"type %d: ready = %u target = %u hits = %llu misses = %llu refilled = %llu refill_failed = %llu\n",
+				type, pool->count, pool->target, pool->hits, pool->misses,
+				pool->refilled, pool->refill_failed);
+	}
+	spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\ndynamic_if pool stats end\n");
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	kfree(lbuf);
+
+	return bytes_read;
+}
+
+static const struct file_operations nss_dynamic_interface_pool_stats_ops = {
+	.read = nss_dynamic_interface_pool_stats_read,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_dynamic_interface_placement_stats_read()
+ *	Read the per-core placement of dynamic interfaces
+ */
+static ssize_t nss_dynamic_interface_placement_stats_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_ctx_instance *nss_ctx;
+	size_t size_al = 2048;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	uint32_t inst_cnt_max = 0;
+	char *lbuf;
+	int i;
+
+	lbuf = kzalloc(size_al, GFP_KERNEL);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	size_wr = scnprintf(lbuf, size_al, "dynamic_if placement stats start:\n\nauto = %d\n\n",
+			nss_dynamic_interface_placement_auto);
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		if (nss_top_main.nss[i].inst_cnt_total > inst_cnt_max) {
+			inst_cnt_max = nss_top_main.nss[i].inst_cnt_total;
+		}
+	}
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		nss_ctx = &nss_top_main.nss[i];
+		if (nss_ctx->state != NSS_CORE_STATE_INITIALIZED) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"core %d: interfaces = %d placed = %llu inst_cnt = %u score = %u\n",
+				i, atomic_read(&nss_dynamic_interface_core_ifs[i]), nss_dynamic_interface_core_placed[i],
+				nss_ctx->inst_cnt_total, nss_dynamic_interface_core_score(nss_ctx, inst_cnt_max));
+	}
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+	for (i = 0; i < NSS_DYNAMIC_INTERFACE_TYPE_MAX; i++) {
+		if (!nss_top_main.dynamic_interface_cores[i]) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "type %d: cores = 0x%x override = %d\n",
+				i, nss_top_main.dynamic_interface_cores[i], nss_dynamic_interface_core_override[i]);
+	}
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\ndynamic_if placement stats end\n");
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	kfree(lbuf);
+
+	return bytes_read;
+}
+
+static const struct file_operations nss_dynamic_interface_placement_stats_ops = {
+	.read = nss_dynamic_interface_placement_stats_read,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_dynamic_interface_table
+ *	Placement controls, registered by nss_init.c as /proc/sys/dev/nss/dynamic_if
+ */
+struct ctl_table nss_dynamic_interface_table[] = {
+	{
+		.procname		= "placement_auto",
+		.data			= &nss_dynamic_interface_placement_auto,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec,
+	},
+	{
+		.procname		= "core_override",
+		.data			= nss_dynamic_interface_core_override,
+		.maxlen			= sizeof(nss_dynamic_interface_core_override),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec_minmax,
+		.extra1			= &nss_dynamic_interface_core_min,
+		.extra2			= &nss_dynamic_interface_core_max,
+	},
+	{ }
+};
+
+/*
+ * nss_dynamic_interface_init()
+ *	Initialize the node pools and placement; pools stay empty until a client reserves nodes
+ */
+void nss_dynamic_interface_init(void)
+{
+	INIT_WORK(&nss_dynamic_interface_pool_work, nss_dynamic_interface_pool_refill);
+
+	nss_dynamic_interface_placement_dentry = debugfs_create_file("dynamic_if_placement", 0400, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_dynamic_interface_placement_stats_ops);
+	if (unlikely(nss_dynamic_interface_placement_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/dynamic_if_placement file in debugfs");
+	}
+
+	nss_dynamic_interface_pool_dentry = debugfs_create_file("dynamic_if_pool", 0400, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_dynamic_interface_pool_stats_ops);
+	if (unlikely(nss_dynamic_interface_pool_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/dynamic_if_pool file in debugfs");
+	}
+}
+
+/*
+ * nss_dynamic_interface_exit()
+ *	Stop refilling and return the pooled nodes to the NSS
+ */
+void nss_dynamic_interface_exit(void)
+{
+	enum nss_dynamic_interface_type type;
+
+	debugfs_remove(nss_dynamic_interface_placement_dentry);
+	nss_dynamic_interface_placement_dentry = NULL;
+	debugfs_remove(nss_dynamic_interface_pool_dentry);
+	nss_dynamic_interface_pool_dentry = NULL;
+
+	spin_lock_bh(&nss_dynamic_interface_pool_lock);
+	nss_dynamic_interface_pool_stopping = true;
+	spin_unlock_bh(&nss_dynamic_interface_pool_lock);
+
+	cancel_work_sync(&nss_dynamic_interface_pool_work);
+
+	for (type = 0; type < NSS_DYNAMIC_INTERFACE_TYPE_MAX; type++) {
+		nss_dynamic_interface_pool_trim(type, 0);
+	}
+}
+
 /*
  * nss_dynamic_interface_register_handler()
  */
@@ -365,5 +974,9 @@ void nss_dynamic_interface_msg_init(struct nss_dynamic_interface_msg *ndm, uint1
 
 EXPORT_SYMBOL(nss_dynamic_interface_alloc_node);
 EXPORT_SYMBOL(nss_dynamic_interface_dealloc_node);
+EXPORT_SYMBOL(nss_dynamic_interface_dealloc_nodes);
+EXPORT_SYMBOL(nss_dynamic_interface_pool_reserve);
 EXPORT_SYMBOL(nss_is_dynamic_interface);
 EXPORT_SYMBOL(nss_dynamic_interface_get_type);
+EXPORT_SYMBOL(nss_dynamic_interface_get_core);
+EXPORT_SYMBOL(nss_dynamic_interface_get_nss_ctx);
@@ -0,0 +1,610 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_flow_stats.c
+ *	NSS per-flow statistics cache
+ *
+ * Optional host side table of accelerated connections built from the
+ * IPv4/IPv6 conn_sync messages. Flows are keyed on the 5-tuple including
+ * the translated addresses and ports, and accumulate the per-direction
+ * packet/byte counters reported by the firmware. The table is bounded;
+ * when full the least recently synced flow is recycled.
+ *
+ * Enabled with /proc/sys/dev/nss/flow_stats/enable, queried through
+ * qca-nss-drv/stats/flow_top. flow_stats/top_metric selects the ranking:
+ * 0 ranks by bytes, 1 by packets, both directions summed.
+ */
+#include <linux/sysctl.h>
+#include <linux/jhash.h>
+#include <linux/sort.h>
+#include <linux/in6.h>
+#include "nss_tx_rx_common.h"
+
+#define NSS_FLOW_STATS_HASH_BITS	10
+#define NSS_FLOW_STATS_HASH_SIZE	(1 << NSS_FLOW_STATS_HASH_BITS)
+#define NSS_FLOW_STATS_HASH_MASK	(NSS_FLOW_STATS_HASH_SIZE - 1)
+#define NSS_FLOW_STATS_MAX_FLOWS	8192
+#define NSS_FLOW_STATS_TOP_N		32
+#define NSS_FLOW_STATS_TOP_N_MAX	256
+
+/*
+ * Ranking metrics of the top-N query
+ */
+#define NSS_FLOW_STATS_METRIC_BYTES	0
+#define NSS_FLOW_STATS_METRIC_PACKETS	1
+
+/*
+ * nss_flow_stats_key
+ *	Flow lookup key; IPv4 addresses use the first word of each address.
+ */
+struct nss_flow_stats_key {
+	uint32_t flow_ip[4];		/* Flow IP address */
+	uint32_t flow_ip_xlate[4];	/* Translated flow IP address */
+	uint32_t return_ip[4];		/* Return IP address */
+	uint32_t return_ip_xlate[4];	/* Translated return IP address */
+	uint32_t flow_ident;		/* Flow ident (e.g. port) */
+	uint32_t flow_ident_xlate;	/* Translated flow ident */
+	uint32_t return_ident;		/* Return ident (e.g. port) */
+	uint32_t return_ident_xlate;	/* Translated return ident */
+	uint32_t version;		/* 4 or 6 */
+	uint32_t protocol;		/* IP protocol */
+};
+
+/*
+ * nss_flow_stats_entry
+ *	One flow in the cache
+ */
+struct nss_flow_stats_entry {
+	struct list_head hnode;		/* Hash bucket linkage */
+	struct list_head lru;		/* LRU linkage, most recently synced at the tail */
+	struct nss_flow_stats_key key;	/* Lookup key */
+	uint64_t flow_rx_packets;	/* Flow direction RX packets */
+	uint64_t flow_rx_bytes;		/* Flow direction RX bytes */
+	uint64_t flow_tx_packets;	/* Flow direction TX packets */
+	uint64_t flow_tx_bytes;		/* Flow direction TX bytes */
+	uint64_t return_rx_packets;	/* Return direction RX packets */
+	uint64_t return_rx_bytes;	/* Return direction RX bytes */
+	uint64_t return_tx_packets;	/* Return direction TX packets */
+	uint64_t return_tx_bytes;	/* Return direction TX bytes */
+	unsigned long first_seen;	/* Jiffies of the first sync */
+	unsigned long last_seen;	/* Jiffies of the latest sync */
+	uint32_t last_reason;		/* Reason of the latest sync */
+};
+
+/*
+ * nss_flow_stats_table
+ *	Flow cache
+ */
+struct nss_flow_stats_table {
+	spinlock_t lock;					/* Protects the table */
+	struct list_head hash[NSS_FLOW_STATS_HASH_SIZE];	/* Hash buckets */
+	struct list_head lru;					/* LRU list of all flows */
+	uint32_t count;						/* Number of flows */
+	uint64_t recycled;					/* Flows recycled because the table was full */
+	uint64_t alloc_fails;					/* Flow allocation failures */
+};
+
+static struct nss_flow_stats_table nss_flow_stats;
+
+int nss_flow_stats_enable __read_mostly = 0;
+static int nss_flow_stats_max_flows = NSS_FLOW_STATS_MAX_FLOWS;
+static int nss_flow_stats_top_n = NSS_FLOW_STATS_TOP_N;
+static int nss_flow_stats_top_metric = NSS_FLOW_STATS_METRIC_BYTES;
+
+static struct dentry *nss_flow_stats_dentry;
+
+/*
+ * nss_flow_stats_hash()
+ *	Hash a flow key
+ */
+static inline uint32_t nss_flow_stats_hash(struct nss_flow_stats_key *key)
+{
+	return jhash2((uint32_t *)key, sizeof(*key) / sizeof(uint32_t), 0) & NSS_FLOW_STATS_HASH_MASK;
+}
+
+/*
+ * nss_flow_stats_free_entry()
+ *	Unlink and free a flow. Called with the table lock held.
+ */
+static void nss_flow_stats_free_entry(struct nss_flow_stats_entry *e)
+{
+	list_del(&e->hnode);
+	list_del(&e->lru);
+	nss_flow_stats.count--;
+	kfree(e);
+}
+
+/*
+ * nss_flow_stats_trim()
+ *	Free the least recently synced flows until at most max remain, lock held
+ */
+static void nss_flow_stats_trim(uint32_t max)
+{
+	struct nss_flow_stats_entry *e;
+
+	while (nss_flow_stats.count > max) {
+		e = list_first_entry(&nss_flow_stats.lru, struct nss_flow_stats_entry, lru);
+		nss_flow_stats_free_entry(e);
+	}
+}
+
+/*
+ * nss_flow_stats_flush()
+ *	Remove all flows from the cache
+ */
+static void nss_flow_stats_flush(void)
+{
+	spin_lock_bh(&nss_flow_stats.lock);
+	nss_flow_stats_trim(0);
+	spin_unlock_bh(&nss_flow_stats.lock);
+}
+
+/*
+ * nss_flow_stats_update()
+ *	Accumulate a conn_sync into the flow cache.
+ */
+static void nss_flow_stats_update(struct nss_flow_stats_key *key, uint32_t reason,
+		uint32_t flow_rx_pkts, uint32_t flow_rx_bytes, uint32_t flow_tx_pkts, uint32_t flow_tx_bytes,
+		uint32_t return_rx_pkts, uint32_t return_rx_bytes, uint32_t return_tx_pkts, uint32_t return_tx_bytes)
+{
+	struct nss_flow_stats_entry *e;
+	uint32_t hash = nss_flow_stats_hash(key);
+
+	/*
+	 * The flag is checked again under the lock: disabling clears it before
+	 * flushing, so a sync racing with the flush cannot add a flow after it.
+	 */
+	spin_lock_bh(&nss_flow_stats.lock);
+	if (unlikely(!ACCESS_ONCE(nss_flow_stats_enable))) {
+		spin_unlock_bh(&nss_flow_stats.lock);
+		return;
+	}
+
+	list_for_each_entry(e, &nss_flow_stats.hash[hash], hnode) {
+		if (!memcmp(&e->key, key, sizeof(*key))) {
+			list_move_tail(&e->lru, &nss_flow_stats.lru);
+			goto found;
+		}
+	}
+
+	/*
+	 * New flow; recycle the least recently synced one if the table is full.
+	 */
+	if (nss_flow_stats.count >= (uint32_t)nss_flow_stats_max_flows) {
+		if (list_empty(&nss_flow_stats.lru)) {
+			spin_unlock_bh(&nss_flow_stats.lock);
+			return;
+		}
+
+		e = list_first_entry(&nss_flow_stats.lru, struct nss_flow_stats_entry, lru);
+		nss_flow_stats_free_entry(e);
+		nss_flow_stats.recycled++;
+	}
+
+	e = kzalloc(sizeof(*e), GFP_ATOMIC);
+	if (!e) {
+		nss_flow_stats.alloc_fails++;
+		spin_unlock_bh(&nss_flow_stats.lock);
+		return;
+	}
+
+	memcpy(&e->key, key, sizeof(*key));
+	e->first_seen = jiffies;
+	list_add(&e->hnode, &nss_flow_stats.hash[hash]);
+	list_add_tail(&e->lru, &nss_flow_stats.lru);
+	nss_flow_stats.count++;
+
+found:
+	e->flow_rx_packets += flow_rx_pkts;
+	e->flow_rx_bytes += flow_rx_bytes;
+	e->flow_tx_packets += flow_tx_pkts;
+	e->flow_tx_bytes += flow_tx_bytes;
+	e->return_rx_packets += return_rx_pkts;
+	e->return_rx_bytes += return_rx_bytes;
+	e->return_tx_packets += return_tx_pkts;
+	e->return_tx_bytes += return_tx_bytes;
+	e->last_seen = jiffies;
+	e->last_reason = reason;
+	spin_unlock_bh(&nss_flow_stats.lock);
+}
+
+/*
+ * nss_flow_stats_ipv4_sync()
+ *	Account an IPv4 connection sync
+ */
+void nss_flow_stats_ipv4_sync(struct nss_ipv4_conn_sync *nirs)
+{
+	struct nss_flow_stats_key key;
+
+	memset(&key, 0, sizeof(key));
+	key.version = 4;
+	key.protocol = nirs->protocol;
+	key.flow_ip[0] = nirs->flow_ip;
+	key.flow_ip_xlate[0] = nirs->flow_ip_xlate;
+	key.return_ip[0] = nirs->return_ip;
+	key.return_ip_xlate[0] = nirs->return_ip_xlate;
+	key.flow_ident = nirs->flow_ident;
+	key.flow_ident_xlate = nirs->flow_ident_xlate;
+	key.return_ident = nirs->return_ident;
+	key.return_ident_xlate = nirs->return_ident_xlate;
+
+	nss_flow_stats_update(&key, nirs->reason,
+		nirs->flow_rx_packet_count, nirs->flow_rx_byte_count, nirs->flow_tx_packet_count, nirs->flow_tx_byte_count,
+		nirs->return_rx_packet_count, nirs->return_rx_byte_count, nirs->return_tx_packet_count, nirs->return_tx_byte_count);
+}
+
+/*
+ * nss_flow_stats_ipv6_sync()
+ *	Account an IPv6 connection sync; IPv6 flows are not translated.
+ */
+void nss_flow_stats_ipv6_sync(struct nss_ipv6_conn_sync *nics)
+{
+	struct nss_flow_stats_key key;
+
+	memset(&key, 0, sizeof(key));
+	key.version = 6;
+	key.protocol = nics->protocol;
+	memcpy(key.flow_ip, nics->flow_ip, sizeof(key.flow_ip));
+	memcpy(key.flow_ip_xlate, nics->flow_ip, sizeof(key.flow_ip_xlate));
+	memcpy(key.return_ip, nics->return_ip, sizeof(key.return_ip));
+	memcpy(key.return_ip_xlate, nics->return_ip, sizeof(key.return_ip_xlate));
+	key.flow_ident = nics->flow_ident;
+	key.flow_ident_xlate = nics->flow_ident;
+	key.return_ident = nics->return_ident;
+	key.return_ident_xlate = nics->return_ident;
+
+	nss_flow_stats_update(&key, nics->reason,
+		nics->flow_rx_packet_count, nics->flow_rx_byte_count, nics->flow_tx_packet_count, nics->flow_tx_byte_count,
+		nics->return_rx_packet_count, nics->return_rx_byte_count, nics->return_tx_packet_count, nics->return_tx_byte_count);
+}
+
+/*
+ * nss_flow_stats_total_bytes()
+ *	Bytes of a flow, both directions
+ */
+static inline uint64_t nss_flow_stats_total_bytes(const struct nss_flow_stats_entry *e)
+{
+	return e->flow_rx_bytes + e->return_rx_bytes;
+}
+
+/*
+ * nss_flow_stats_total_packets()
+ *	Packets of a flow, both directions
+ */
+static inline uint64_t nss_flow_stats_total_packets(const struct nss_flow_stats_entry *e)
+{
+	return e->flow_rx_packets + e->return_rx_packets;
+}
+
+/*
+ * nss_flow_stats_cmp_bytes()
+ *	sort() comparator, descending byte count
+ */
+static int nss_flow_stats_cmp_bytes(const void *a, const void *b)
+{
+	uint64_t va = nss_flow_stats_total_bytes(a);
+	uint64_t vb = nss_flow_stats_total_bytes(b);
+
+	return (va < vb) ? 1 : ((va > vb) ? -1 : 0);
+}
+
+/*
+ * nss_flow_stats_cmp_packets()
+ *	sort() comparator, descending packet count
+ */
+static int nss_flow_stats_cmp_packets(const void *a, const void *b)
+{
+	uint64_t va = nss_flow_stats_total_packets(a);
+	uint64_t vb = nss_flow_stats_total_packets(b);
+
+	return (va < vb) ? 1 : ((va > vb) ? -1 : 0);
+}
+
+/*
+ * nss_flow_stats_metric()
+ *	Value of a flow for the given ranking metric
+ */
+static inline uint64_t nss_flow_stats_metric(const struct nss_flow_stats_entry *e, int metric)
+{
+	return (metric == NSS_FLOW_STATS_METRIC_PACKETS) ? nss_flow_stats_total_packets(e) : nss_flow_stats_total_bytes(e);
+}
+
+/*
+ * nss_flow_stats_heap_down()
+ *	Restore the min-heap order of heap[] from index i down
+ */
+static void nss_flow_stats_heap_down(struct nss_flow_stats_entry *heap, uint32_t count, uint32_t i, int metric)
+{
+	struct nss_flow_stats_entry tmp;
+	uint32_t child;
+
+	for (;;) {
+		child = (2 * i) + 1;
+		if (child >= count) {
+			return;
+		}
+
+		if ((child + 1 < count) && (nss_flow_stats_metric(&heap[child + 1], metric) < nss_flow_stats_metric(&heap[child], metric))) {
+			child++;
+		}
+
+		if (nss_flow_stats_metric(&heap[i], metric) <= nss_flow_stats_metric(&heap[child], metric)) {
+			return;
+		}
+
+		tmp = heap[i];
+		heap[i] = heap[child];
+		heap[child] = tmp;
+		i = child;
+	}
+}
+
+/*
+ * nss_flow_stats_top()
+ *	Copy the n highest ranked flows into top[] and return the number copied.
+ *
+ * top[] is kept as a min-heap of the best flows seen while the table is
+ * walked, so the cost is bounded by n whatever the table size. The result
+ * is unordered.
+ */
+static uint32_t nss_flow_stats_top(struct nss_flow_stats_entry *top, uint32_t n, int metric)
+{
+	struct nss_flow_stats_entry *e;
+	uint32_t found = 0;
+	uint32_t i;
+
+	spin_lock_bh(&nss_flow_stats.lock);
+	list_for_each_entry(e, &nss_flow_stats.lru, lru) {
+		if (found < n) {
+			top[found++] = *e;
+			if (found == n) {
+				for (i = n / 2; i-- > 0; ) {
+					nss_flow_stats_heap_down(top, n, i, metric);
+				}
+			}
+
+			continue;
+		}
+
+		if (nss_flow_stats_metric(e, metric) <= nss_flow_stats_metric(&top[0], metric)) {
+			continue;
+		}
+
+		top[0] = *e;
+		nss_flow_stats_heap_down(top, n, 0, metric);
+	}
+	spin_unlock_bh(&nss_flow_stats.lock);
+
+	return found;
+}
+
+/*
+ * nss_flow_stats_print_addr()
+ *	Print an address of the given IP version
+ */
+static size_t nss_flow_stats_print_addr(char *buf, size_t size, uint32_t version, uint32_t *ip, uint32_t ident)
+{
+	struct in6_addr addr;
+	int i;
+
+	if (version == 4) {
+		return scnprintf(buf, size, "%pI4h:%u", &ip[0], ident);
+	}
+
+	for (i = 0; i < 4; i++) {
+		addr.s6_addr32[i] = htonl(ip[i]);
+	}
+
+	return scnprintf(buf, size, "[%pI6c]:%u", &addr, ident);
+}
+
+/*
+ * nss_flow_stats_top_read()
+ *	Read the top-N flows by the configured metric
+ */
+static ssize_t nss_flow_stats_top_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_flow_stats_entry *top;
+	uint32_t n = nss_flow_stats_top_n;
+	int metric = nss_flow_stats_top_metric;
+	uint32_t found, i;
+	size_t size_al = 320 * (n + 3);
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	char *lbuf;
+
+	top = vmalloc(n * sizeof(*top));
+	if (unlikely(top == NULL)) {
+		nss_warning("Could not allocate memory for flow stats buffer");
+		return 0;
+	}
+
+	lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		vfree(top);
+		return 0;
+	}
+
+	found = nss_flow_stats_top(top, n, metric);
+	sort(top, found, sizeof(*top), (metric == NSS_FLOW_STATS_METRIC_PACKETS) ?
+			nss_flow_stats_cmp_packets : nss_flow_stats_cmp_bytes, NULL);
+
+	size_wr = scnprintf(lbuf, size_al, "flow stats: %s, flows = %u, recycled = %llu, alloc_fails = %llu, ranked by %s\n",
+				nss_flow_stats_enable ? "enabled" : "disabled", nss_flow_stats.count,
+				nss_flow_stats.recycled, nss_flow_stats.alloc_fails,
+				(metric == NSS_FLOW_STATS_METRIC_PACKETS) ? "packets" : "bytes");
+
+	for (i = 0; i < found; i++) {
+		struct nss_flow_stats_entry *e = &top[i];
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%u: ipv%u proto %u ", i, e->key.version, e->key.protocol);
+		size_wr += nss_flow_stats_print_addr(lbuf + size_wr, size_al - size_wr, e->key.version, e->key.flow_ip, e->key.flow_ident);
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, " -> ");
+		size_wr += nss_flow_stats_print_addr(lbuf + size_wr, size_al - size_wr, e->key.version, e->key.return_ip, e->key.return_ident);
+		if (e->key.version == 4 && (e->key.flow_ip[0] != e->key.flow_ip_xlate[0] || e->key.return_ip[0] != e->key.return_ip_xlate[0]
+				|| e->key.flow_ident != e->key.flow_ident_xlate || e->key.return_ident != e->key.return_ident_xlate)) {
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, " xlate ");
+			size_wr += nss_flow_stats_print_addr(lbuf + size_wr, size_al - size_wr, 4, e->key.flow_ip_xlate, e->key.flow_ident_xlate);
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, " -> ");
+			size_wr += nss_flow_stats_print_addr(lbuf + size_wr, size_al - size_wr, 4, e->key.return_ip_xlate, e->key.return_ident_xlate);
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"\n\tflow rx %llu/%llu tx %llu/%llu return rx %llu/%llu tx %llu/%llu (pkts/bytes)"
+				" age %ums idle %ums reason %u\n",
+				e->flow_rx_packets, e->flow_rx_bytes, e->flow_tx_packets, e->flow_tx_bytes,
+				e->return_rx_packets, e->return_rx_bytes, e->return_tx_packets, e->return_tx_bytes,
+				jiffies_to_msecs(jiffies - e->first_seen), jiffies_to_msecs(jiffies - e->last_seen),
+				e->last_reason);
+	}
+
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
+	vfree(top);
+
+	return bytes_read;
+}
+
+static const struct file_operations nss_flow_stats_top_ops = {
+	.read = nss_flow_stats_top_read,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_flow_stats_enable_handler()
+ *	Enable/disable the flow cache; disabling drops all cached flows.
+ */
+static int nss_flow_stats_enable_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	int ret;
+
+	ret = proc_dointvec(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		return ret;
+	}
+
+	if (!nss_flow_stats_enable) {
+		nss_flow_stats_flush();
+	}
+
+	return 0;
+}
+
+/*
+ * nss_flow_stats_max_flows_handler()
+ *	Set the table bound; flows over a lowered bound are dropped at once.
+ */
+static int nss_flow_stats_max_flows_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	int ret;
+
+	ret = proc_dointvec_minmax(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		return ret;
+	}
+
+	spin_lock_bh(&nss_flow_stats.lock);
+	nss_flow_stats_trim((uint32_t)nss_flow_stats_max_flows);
+	spin_unlock_bh(&nss_flow_stats.lock);
+
+	return 0;
+}
+
+static int nss_flow_stats_max_flows_min = 1;
+static int nss_flow_stats_max_flows_max = 65536;
+static int nss_flow_stats_top_n_min = 1;
+static int nss_flow_stats_top_n_max = NSS_FLOW_STATS_TOP_N_MAX;
+static int nss_flow_stats_top_metric_min = NSS_FLOW_STATS_METRIC_BYTES;
+static int nss_flow_stats_top_metric_max = NSS_FLOW_STATS_METRIC_PACKETS;
+
+/*
+ * nss_flow_stats_table
+ *	dev/nss/flow_stats, registered with the driver sysctl tree in nss_init.c
+ */
+struct ctl_table nss_flow_stats_table[] = {
+	{
+		.procname		= "enable",
+		.data			= &nss_flow_stats_enable,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &nss_flow_stats_enable_handler,
+	},
+	{
+		.procname		= "max_flows",
+		.data			= &nss_flow_stats_max_flows,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &nss_flow_stats_max_flows_handler,
+		.extra1			= &nss_flow_stats_max_flows_min,
+		.extra2			= &nss_flow_stats_max_flows_max,
+	},
+	{
+		.procname		= "top_n",
+		.data			= &nss_flow_stats_top_n,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec_minmax,
+		.extra1			= &nss_flow_stats_top_n_min,
+		.extra2			= &nss_flow_stats_top_n_max,
+	},
+	{
+		.procname		= "top_metric",
+		.data			= &nss_flow_stats_top_metric,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &proc_dointvec_minmax,
+		.extra1			= &nss_flow_stats_top_metric_min,
+		.extra2			= &nss_flow_stats_top_metric_max,
+	},
+	{ }
+};
+
+/*
+ * nss_flow_stats_init()
+ *	Initialize the flow cache and its debugfs entry
+ */
+void nss_flow_stats_init(void)
+{
+	int i;
+
+	spin_lock_init(&nss_flow_stats.lock);
+	INIT_LIST_HEAD(&nss_flow_stats.lru);
+	for (i = 0; i < NSS_FLOW_STATS_HASH_SIZE; i++) {
+		INIT_LIST_HEAD(&nss_flow_stats.hash[i]);
+	}
+
+	nss_flow_stats_dentry = debugfs_create_file("flow_top", 0400, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_flow_stats_top_ops);
+	if (unlikely(nss_flow_stats_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/flow_top file in debugfs");
+	}
+}
+
+/*
+ * nss_flow_stats_exit()
+ *	Release the flow cache
+ */
+void nss_flow_stats_exit(void)
+{
+	nss_flow_stats_enable = 0;
+
+	debugfs_remove(nss_flow_stats_dentry);
+	nss_flow_stats_dentry = NULL;
+
+	nss_flow_stats_flush();
+}
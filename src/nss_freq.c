@@ -19,6 +19,7 @@
  *	NSS frequency change APIs
  */
 
+#include <linux/sysctl.h>
 #include "nss_tx_rx_common.h"
 
 #define NSS_ACK_STARTED 0
@@ -30,6 +31,47 @@ extern struct nss_runtime_sampling nss_runtime_samples;
 extern struct workqueue_struct *nss_wq;
 extern nss_work_t *nss_work;
 
+#define NSS_FREQ_TRANSITION_HISTORY 32	/* Transitions kept for debugfs, power of two */
+
+/*
+ * nss_freq_transition
+ *	One frequency change
+ */
+struct nss_freq_transition {
+	uint64_t start_ns;		/* Time the change was queued */
+	uint64_t ack_ns;		/* Time the NSS acked the end of the change, 0 while pending */
+	uint32_t from;			/* Frequency before the change */
+	uint32_t to;			/* Requested frequency */
+	uint32_t average;		/* Busiest core average INST_CNT when queued */
+	const char *trigger;		/* What asked for the change */
+	uint64_t queue_full;		/* H2N queue full events between queue and ack */
+	uint64_t drops;			/* NSS N2H drops between queue and ack, as synced */
+};
+
+/*
+ * nss_freq_telemetry
+ *	Transition history and residency per frequency
+ */
+struct nss_freq_telemetry {
+	spinlock_t lock;						/* Protects the telemetry */
+	struct nss_freq_transition hist[NSS_FREQ_TRANSITION_HISTORY];	/* Transition ring */
+	uint32_t head;							/* Next ring slot */
+	uint64_t transitions;						/* Transitions queued */
+	uint64_t acked;							/* Transitions acked */
+	uint64_t ack_ns_total;						/* Sum of time to ack */
+	uint64_t ack_ns_max;						/* Worst time to ack */
+	uint64_t queue_full_start;					/* Queue full count when the pending change was queued */
+	uint64_t drops_start;						/* Drop count when the pending change was queued */
+	struct nss_freq_transition *pending;				/* Change waiting for its ack */
+	uint32_t current_freq;						/* Frequency residency is accounted to */
+	uint64_t since_ns;						/* Start of the current residency */
+	uint64_t residency_ns[NSS_FREQ_MAX_SCALE];			/* Time spent at each scale */
+	uint64_t residency_other_ns;					/* Time spent at frequencies outside the table */
+};
+
+static struct nss_freq_telemetry nss_freq_tm;
+static struct dentry *nss_freq_tm_dentry;
+
 /*
  * nss_freq_msg_init()
  *	Initialize the freq message
@@ -40,6 +82,113 @@ static void nss_freq_msg_init(struct nss_corefreq_msg *ncm, uint16_t if_num, uin
 	nss_cmn_msg_init(&ncm->cm, if_num, type, len, cb, app_data);
 }
 
+/*
+ * nss_freq_tm_counters()
+ *	Queue full events and N2H drops over all cores
+ */
+static void nss_freq_tm_counters(uint64_t *queue_full, uint64_t *drops)
+{
+	struct nss_ctx_instance *nss_ctx;
+	uint32_t core, i;
+
+	*queue_full = 0;
+	*drops = 0;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		nss_ctx = &nss_top_main.nss[core];
+		for (i = 0; i < NSS_H2N_DESC_RING_NUM; i++) {
+			*queue_full += nss_ctx->h2n_desc_rings[i].tx_q_full_cnt;
+		}
+
+		*drops += nss_ctx->stats_n2h[NSS_STATS_NODE_RX_DROPPED] + nss_ctx->stats_n2h[NSS_STATS_N2H_QUEUE_DROPPED];
+	}
+}
+
+/*
+ * nss_freq_tm_residency_update()
+ *	Close the current residency period, lock held
+ */
+static void nss_freq_tm_residency_update(uint64_t now)
+{
+	uint32_t i;
+
+	for (i = 0; i < NSS_FREQ_MAX_SCALE; i++) {
+		if (nss_runtime_samples.freq_scale[i].frequency == nss_freq_tm.current_freq) {
+			nss_freq_tm.residency_ns[i] += now - nss_freq_tm.since_ns;
+			nss_freq_tm.since_ns = now;
+			return;
+		}
+	}
+
+	nss_freq_tm.residency_other_ns += now - nss_freq_tm.since_ns;
+	nss_freq_tm.since_ns = now;
+}
+
+/*
+ * nss_freq_transition_start()
+ *	Record a frequency change being queued
+ */
+void nss_freq_transition_start(uint32_t to, const char *trigger)
+{
+	struct nss_freq_transition *t;
+	uint64_t now = ktime_to_ns(ktime_get());
+
+	spin_lock_bh(&nss_freq_tm.lock);
+	t = &nss_freq_tm.hist[nss_freq_tm.head];
+	nss_freq_tm.head = (nss_freq_tm.head + 1) & (NSS_FREQ_TRANSITION_HISTORY - 1);
+	nss_freq_tm.transitions++;
+
+	memset(t, 0, sizeof(*t));
+	t->start_ns = now;
+	t->from = nss_freq_tm.current_freq;
+	t->to = to;
+	t->average = nss_runtime_samples.average;
+	t->trigger = trigger;
+
+	nss_freq_tm_counters(&nss_freq_tm.queue_full_start, &nss_freq_tm.drops_start);
+	nss_freq_tm.pending = t;
+	spin_unlock_bh(&nss_freq_tm.lock);
+}
+
+/*
+ * nss_freq_transition_end()
+ *	Record the NSS acking the end of a frequency change
+ */
+static void nss_freq_transition_end(void)
+{
+	struct nss_freq_transition *t;
+	uint64_t now = ktime_to_ns(ktime_get());
+	uint64_t queue_full, drops, ack_ns;
+
+	spin_lock_bh(&nss_freq_tm.lock);
+	t = nss_freq_tm.pending;
+	if (!t) {
+		/*
+		 * Every core acks the change; only the first one counts
+		 */
+		spin_unlock_bh(&nss_freq_tm.lock);
+		return;
+	}
+
+	nss_freq_tm.pending = NULL;
+	t->ack_ns = now;
+	ack_ns = now - t->start_ns;
+
+	nss_freq_tm_counters(&queue_full, &drops);
+	t->queue_full = queue_full - nss_freq_tm.queue_full_start;
+	t->drops = drops - nss_freq_tm.drops_start;
+
+	nss_freq_tm.acked++;
+	nss_freq_tm.ack_ns_total += ack_ns;
+	if (ack_ns > nss_freq_tm.ack_ns_max) {
+		nss_freq_tm.ack_ns_max = ack_ns;
+	}
+
+	nss_freq_tm_residency_update(now);
+	nss_freq_tm.current_freq = t->to;
+	spin_unlock_bh(&nss_freq_tm.lock);
+}
+
 /*
  * nss_freq_handle_ack()
  *	Handle the nss ack of frequency change.
@@ -60,6 +209,7 @@ static void nss_freq_handle_ack(struct nss_ctx_instance *nss_ctx, struct nss_fre
 		 * NSS finished end notification - Done
 		 */
 		nss_info("%p: NSS ACK Received: %d - End Notification ACK - Running: %dmhz\n", nss_ctx, nfa->ack, nfa->freq_current);
+		nss_freq_transition_end();
 		nss_runtime_samples.freq_scale_ready = 1;
 		return;
 	}
@@ -116,7 +266,7 @@ nss_tx_status_t nss_freq_change(struct nss_ctx_instance *nss_ctx, uint32_t eng,
  * nss_freq_queue_work()
  *	Queue Work to the NSS Workqueue based on Current index.
  */
-static int nss_freq_queue_work(void)
+static int nss_freq_queue_work(const char *trigger)
 {
 	uint32_t index = nss_runtime_samples.freq_scale_index;
 	BUG_ON(!nss_wq);
@@ -134,26 +284,630 @@ static int nss_freq_queue_work(void)
 	 * Update proc node
 	 */
 	nss_cmd_buf.current_freq = nss_runtime_samples.freq_scale[index].frequency;
+	nss_freq_transition_start(nss_cmd_buf.current_freq, trigger);
 
 	INIT_WORK((struct work_struct *)nss_work, nss_wq_function);
 	nss_work->frequency = nss_runtime_samples.freq_scale[index].frequency;
 	nss_work->stats_enable =  1;
+	nss_work->fabric_level = nss_freq_perf_level_get(nss_work->frequency);
 
 	queue_work(nss_wq, (struct work_struct *)nss_work);
 	return 0;
 }
 
+/*
+ * nss_freq_gov_sample
+ *	Inputs handed to a frequency governor for every core stats sample
+ */
+struct nss_freq_gov_sample {
+	uint32_t sample;		/* INST_CNT of this sample */
+	uint32_t average;		/* Moving average of INST_CNT */
+	uint32_t index;			/* Current frequency scale index */
+	uint32_t ring_occ;		/* Worst H2N/N2H ring occupancy over all cores, per mille */
+	uint64_t queue_full;		/* H2N queue full events since the previous sample */
+	const char *trigger;		/* Set by the governor to the reason of a change */
+};
+
+/*
+ * nss_freq_governor
+ *	Frequency governor
+ *
+ * decide() returns 1 to scale up, -1 to scale down and 0 to stay. reset()
+ * is called when the governor is selected and when sampling restarts.
+ * transition(), if set, is called after every frequency transition.
+ */
+struct nss_freq_governor {
+	const char *name;
+	void (*reset)(void);
+	void (*transition)(void);
+	int (*decide)(struct nss_ctx_instance *nss_ctx, struct nss_freq_gov_sample *gs);
+};
+
+/*
+ * PID governor tunables, /proc/sys/dev/nss/clock/pid_*
+ *
+ * Gains are in 1/1000 units. Load is the EWMA of INST_CNT as per mille
+ * of the upscale threshold of the current frequency.
+ */
+int nss_freq_pid_kp = 1000;		/* Proportional gain */
+int nss_freq_pid_ki = 20;		/* Integral gain */
+int nss_freq_pid_kd = 500;		/* Derivative gain */
+int nss_freq_pid_ewma_shift = 2;	/* EWMA weight of a new sample is 1/2^shift */
+int nss_freq_pid_target = 800;		/* Load set point, per mille */
+int nss_freq_pid_ring_target = 250;	/* Ring occupancy that starts adding to the error, per mille */
+int nss_freq_pid_ring_gain = 2000;	/* Gain of ring occupancy above the target */
+int nss_freq_pid_up_threshold = 100;	/* Controller output that triggers an upscale */
+int nss_freq_pid_down_threshold = 200;	/* Negative controller output that allows a downscale */
+int nss_freq_pid_down_hold = 3000;	/* Consecutive samples below the down threshold before downscaling */
+
+#define NSS_FREQ_PID_INTEGRAL_MAX 100000	/* Anti-windup clamp of the integral term */
+
+/*
+ * nss_freq_pid_state
+ *	PID governor state
+ */
+struct nss_freq_pid_state {
+	int64_t integral;		/* Accumulated error */
+	int32_t prev_error;		/* Error of the previous sample */
+	uint32_t ewma;			/* Smoothed INST_CNT */
+	uint32_t down_count;		/* Consecutive samples asking for a downscale */
+};
+
+static struct nss_freq_pid_state nss_freq_pid;
+
+/*
+ * nss_freq_band_reset()
+ *	Reset the band governor
+ */
+static void nss_freq_band_reset(void)
+{
+	nss_runtime_samples.freq_scale_rate_limit_up = 0;
+	nss_runtime_samples.freq_scale_rate_limit_down = 0;
+}
+
+/*
+ * nss_freq_band_decide()
+ *	Band governor: compare the moving average against the min/max band of the current frequency
+ *
+ *	Algorithmn will limit how fast it will transition each scale, by the number of samples seen.
+ *	If any sample is out of scale during the idle count, the rate_limit will reset to 0.
+ */
+static int nss_freq_band_decide(struct nss_ctx_instance *nss_ctx, struct nss_freq_gov_sample *gs)
+{
+	uint32_t minimum;
+	uint32_t maximum;
+	int dir = 0;
+
+	if (nss_runtime_samples.freq_scale_rate_limit_up++ >= NSS_FREQUENCY_SCALE_RATE_LIMIT_UP) {
+		maximum = nss_runtime_samples.freq_scale[gs->index].maximum;
+		if (gs->average > maximum) {
+			nss_trace("frequency increase inst:%x > maximum:%x\n", gs->sample, maximum);
+			gs->trigger = "average_above_band";
+			dir = 1;
+
+			/*
+			 * Reset the down scale counter based on running average, so can idle properlly
+			 */
+			nss_runtime_samples.freq_scale_rate_limit_down = 0;
+		}
+
+		nss_runtime_samples.freq_scale_rate_limit_up = 0;
+		return dir;
+	}
+
+	if (nss_runtime_samples.freq_scale_rate_limit_down++ >= NSS_FREQUENCY_SCALE_RATE_LIMIT_DOWN) {
+		minimum = nss_runtime_samples.freq_scale[gs->index].minimum;
+		if (gs->average < minimum) {
+			nss_trace("frequency decrease inst:%x < minumum:%x\n", gs->average, minimum);
+			gs->trigger = "average_below_band";
+			dir = -1;
+		}
+
+		nss_runtime_samples.freq_scale_rate_limit_down = 0;
+	}
+
+	return dir;
+}
+
+/*
+ * nss_freq_pid_reset()
+ *	Reset the PID governor; the EWMA is kept as it does not depend on the frequency
+ */
+static void nss_freq_pid_reset(void)
+{
+	nss_freq_pid.integral = 0;
+	nss_freq_pid.prev_error = 0;
+	nss_freq_pid.down_count = 0;
+}
+
+/*
+ * nss_freq_pid_decide()
+ *	PID governor on the EWMA load, with ring occupancy and queue full events as leading indicators
+ */
+static int nss_freq_pid_decide(struct nss_ctx_instance *nss_ctx, struct nss_freq_gov_sample *gs)
+{
+	struct nss_freq_pid_state *ps = &nss_freq_pid;
+	uint32_t maximum = nss_runtime_samples.freq_scale[gs->index].maximum;
+	int shift = clamp(nss_freq_pid_ewma_shift, 0, 8);
+	int32_t load, error, output;
+
+	ps->ewma = (uint32_t)((int32_t)ps->ewma + (((int32_t)gs->sample - (int32_t)ps->ewma) >> shift));
+
+	/*
+	 * Any queue full event means packets are already backing up: scale up now
+	 */
+	if (gs->queue_full) {
+		nss_trace("%p: frequency increase, %llu queue full events\n", nss_ctx, gs->queue_full);
+		gs->trigger = "queue_full";
+		ps->down_count = 0;
+		return 1;
+	}
+
+	if (unlikely(!maximum)) {
+		return 0;
+	}
+
+	load = (int32_t)div_u64((uint64_t)ps->ewma * 1000, maximum);
+	error = load - nss_freq_pid_target;
+
+	/*
+	 * Rings filling up precede a rise of INST_CNT, push the error up with them
+	 */
+	if (gs->ring_occ > nss_freq_pid_ring_target) {
+		error += (int32_t)(gs->ring_occ - nss_freq_pid_ring_target) * nss_freq_pid_ring_gain / 1000;
+	}
+
+	ps->integral = clamp_t(int64_t, ps->integral + error, -NSS_FREQ_PID_INTEGRAL_MAX, NSS_FREQ_PID_INTEGRAL_MAX);
+	output = (int32_t)div_s64((int64_t)nss_freq_pid_kp * error + (int64_t)nss_freq_pid_ki * ps->integral
+				+ (int64_t)nss_freq_pid_kd * (error - ps->prev_error), 1000);
+	ps->prev_error = error;
+
+	if (output > nss_freq_pid_up_threshold) {
+		nss_trace("%p: frequency increase load:%d ring:%u output:%d\n", nss_ctx, load, gs->ring_occ, output);
+		gs->trigger = (gs->ring_occ > nss_freq_pid_ring_target) ? "pid_ring_occupancy" : "pid_load";
+		ps->down_count = 0;
+		return 1;
+	}
+
+	if (output >= -nss_freq_pid_down_threshold) {
+		ps->down_count = 0;
+		return 0;
+	}
+
+	if (++ps->down_count < nss_freq_pid_down_hold) {
+		return 0;
+	}
+
+	nss_trace("%p: frequency decrease load:%d ring:%u output:%d\n", nss_ctx, load, gs->ring_occ, output);
+	gs->trigger = "pid_idle";
+	ps->down_count = 0;
+	return -1;
+}
+
+static struct nss_freq_governor nss_freq_governors[] = {
+	{
+		.name = "band",
+		.reset = nss_freq_band_reset,
+		.decide = nss_freq_band_decide,
+	},
+	{
+		.name = "pid",
+		.reset = nss_freq_pid_reset,
+		.transition = nss_freq_pid_reset,
+		.decide = nss_freq_pid_decide,
+	},
+};
+
+static struct nss_freq_governor *nss_freq_gov = &nss_freq_governors[0];
+static struct nss_freq_governor *nss_freq_gov_next = &nss_freq_governors[0];
+char nss_freq_governor_name[NSS_FREQ_GOVERNOR_NAME_LEN] = "band";
+
+/*
+ * nss_freq_governor_handler()
+ *	Select the frequency governor by name
+ *
+ * The switch itself happens on the next core stats sample so that the
+ * governor state is only ever touched from the stats handler.
+ */
+int nss_freq_governor_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	char old[NSS_FREQ_GOVERNOR_NAME_LEN];
+	int ret, i;
+
+	strlcpy(old, nss_freq_governor_name, sizeof(old));
+
+	ret = proc_dostring(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		return ret;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(nss_freq_governors); i++) {
+		if (!strcmp(nss_freq_governor_name, nss_freq_governors[i].name)) {
+			nss_freq_gov_next = &nss_freq_governors[i];
+			nss_info("frequency governor set to %s\n", nss_freq_governors[i].name);
+			return 0;
+		}
+	}
+
+	nss_warning("unknown frequency governor %s\n", nss_freq_governor_name);
+	strlcpy(nss_freq_governor_name, old, sizeof(nss_freq_governor_name));
+	return -EINVAL;
+}
+
+/*
+ * nss_freq_gov_ring_sample()
+ *	Leading indicators: worst ring occupancy and new queue full events over all cores
+ */
+static void nss_freq_gov_ring_sample(struct nss_freq_gov_sample *gs)
+{
+	static uint64_t last_queue_full;
+	struct nss_ctx_instance *nss_ctx;
+	struct nss_if_mem_map *if_map;
+	uint64_t queue_full = 0;
+	uint32_t core, i, size, used, occ;
+
+	gs->ring_occ = 0;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		nss_ctx = &nss_top_main.nss[core];
+		if (nss_ctx->state != NSS_CORE_STATE_INITIALIZED) {
+			continue;
+		}
+
+		if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
+
+		for (i = 0; i < if_map->h2n_rings && i < NSS_H2N_DESC_RING_NUM; i++) {
+			size = nss_ctx->h2n_desc_rings[i].desc_ring.size;
+			if (!size) {
+				continue;
+			}
+
+			used = size - 1 - nss_core_h2n_ring_free(if_map->h2n_nss_index[i], nss_ctx->h2n_desc_rings[i].hlos_index, size);
+			occ = used * 1000 / size;
+			gs->ring_occ = max(gs->ring_occ, occ);
+			queue_full += nss_ctx->h2n_desc_rings[i].tx_q_full_cnt;
+		}
+
+		for (i = 0; i < if_map->n2h_rings && i < NSS_N2H_DESC_RING_NUM; i++) {
+			size = nss_ctx->n2h_desc_ring[i].desc_if.size;
+			if (!size) {
+				continue;
+			}
+
+			used = nss_core_n2h_ring_pending(if_map->n2h_nss_index[i], nss_ctx->n2h_desc_ring[i].hlos_index, size);
+			occ = used * 1000 / size;
+			gs->ring_occ = max(gs->ring_occ, occ);
+		}
+	}
+
+	gs->queue_full = queue_full - last_queue_full;
+	last_queue_full = queue_full;
+}
+
+/*
+ * nss_freq_busiest_core()
+ *	Core with the highest average INST_CNT among the cores with a full sample set
+ */
+static struct nss_ctx_instance *nss_freq_busiest_core(void)
+{
+	struct nss_ctx_instance *busiest = NULL;
+	struct nss_ctx_instance *nss_ctx;
+	uint32_t core;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		nss_ctx = &nss_top_main.nss[core];
+		if ((nss_ctx->state != NSS_CORE_STATE_INITIALIZED) || (nss_ctx->samples.sample_count < NSS_SAMPLE_BUFFER_SIZE)) {
+			continue;
+		}
+
+		if (!busiest || (nss_ctx->samples.average > busiest->samples.average)) {
+			busiest = nss_ctx;
+		}
+	}
+
+	return busiest;
+}
+
+/*
+ * Perf state policies
+ */
+enum nss_freq_perf_policy {
+	NSS_FREQ_PERF_POLICY_PERFORMANCE,	/* Highest frequency, turbo fabric and bus */
+	NSS_FREQ_PERF_POLICY_BALANCED,		/* Fabric and bus follow the core or the load, whichever is higher */
+	NSS_FREQ_PERF_POLICY_POWERSAVE,		/* Fabric and bus follow the load, core capped unless queues fill */
+	NSS_FREQ_PERF_POLICY_MAX,
+};
+
+static const char *nss_freq_perf_policy_names[NSS_FREQ_PERF_POLICY_MAX] = {
+	"performance",
+	"balanced",
+	"powersave",
+};
+
+static const char *nss_freq_perf_level_names[NSS_FREQ_PERF_LEVEL_MAX] = {
+	"idle",
+	"nominal",
+	"turbo",
+};
+
+#define NSS_FREQ_PERF_POWERSAVE_MAX_INDEX 1	/* Highest scale index powersave moves to without queue full */
+
+/*
+ * nss_freq_perf_state
+ *	Measured load and the fabric and bus level picked from it
+ */
+struct nss_freq_perf_state {
+	uint32_t policy;		/* Active policy */
+	uint32_t level;			/* Fabric and bus level last handed to the workqueue */
+	uint32_t load_level;		/* Level the measured load asks for, after hysteresis */
+	uint32_t down_count;		/* Consecutive samples asking for a lower load level */
+	uint64_t last_ns;		/* Time of the previous load sample, 0 if none */
+	uint64_t last_bytes;		/* NSS ingress bytes at the previous load sample */
+	uint64_t last_pkts;		/* NSS ingress packets at the previous load sample */
+	uint32_t mbps;			/* Measured ingress rate in Mbit/s */
+	uint32_t kpps;			/* Measured ingress rate in kpps */
+	uint64_t changes;		/* Fabric only level changes queued */
+};
+
+static DEFINE_SPINLOCK(nss_freq_perf_lock);
+static struct nss_freq_perf_state nss_freq_perf = {
+	.policy = NSS_FREQ_PERF_POLICY_BALANCED,
+	.level = NSS_FREQ_PERF_LEVEL_MAX,
+};
+
+char nss_freq_perf_policy_name[NSS_FREQ_GOVERNOR_NAME_LEN] = "balanced";
+int nss_freq_perf_nominal_mbps = 300;	/* Ingress rate that needs nominal fabric and bus */
+int nss_freq_perf_turbo_mbps = 1200;	/* Ingress rate that needs turbo fabric and bus */
+int nss_freq_perf_nominal_kpps = 100;	/* Ingress packet rate that needs nominal fabric and bus */
+int nss_freq_perf_turbo_kpps = 600;	/* Ingress packet rate that needs turbo fabric and bus */
+int nss_freq_perf_down_hold = 4;	/* Samples the load must stay lower before the load level drops */
+
+/*
+ * nss_freq_perf_core_level()
+ *	Fabric and bus level the core frequency alone needs
+ */
+static uint32_t nss_freq_perf_core_level(uint32_t frequency)
+{
+	if (frequency >= NSS_FREQ_733) {
+		return NSS_FREQ_PERF_LEVEL_TURBO;
+	}
+
+	if (frequency > NSS_FREQ_110) {
+		return NSS_FREQ_PERF_LEVEL_NOMINAL;
+	}
+
+	return NSS_FREQ_PERF_LEVEL_IDLE;
+}
+
+/*
+ * nss_freq_perf_level_get()
+ *	Fabric and bus level for a core frequency under the active policy
+ *
+ * The result is recorded as the level in effect: callers hand it to
+ * nss_wq_function() together with the frequency.
+ */
+uint32_t nss_freq_perf_level_get(uint32_t frequency)
+{
+	uint32_t level;
+
+	spin_lock_bh(&nss_freq_perf_lock);
+	switch (nss_freq_perf.policy) {
+	case NSS_FREQ_PERF_POLICY_PERFORMANCE:
+		level = NSS_FREQ_PERF_LEVEL_TURBO;
+		break;
+
+	case NSS_FREQ_PERF_POLICY_POWERSAVE:
+		level = nss_freq_perf.load_level;
+		break;
+
+	default:
+		level = max(nss_freq_perf_core_level(frequency), nss_freq_perf.load_level);
+		break;
+	}
+
+	nss_freq_perf.level = level;
+	spin_unlock_bh(&nss_freq_perf_lock);
+
+	return level;
+}
+
+/*
+ * nss_freq_perf_reset()
+ *	Forget the measured load, e.g. when the samples stop with auto scaling off
+ */
+void nss_freq_perf_reset(void)
+{
+	spin_lock_bh(&nss_freq_perf_lock);
+	nss_freq_perf.load_level = NSS_FREQ_PERF_LEVEL_IDLE;
+	nss_freq_perf.down_count = 0;
+	nss_freq_perf.last_ns = 0;
+	nss_freq_perf.mbps = 0;
+	nss_freq_perf.kpps = 0;
+	spin_unlock_bh(&nss_freq_perf_lock);
+}
+
+/*
+ * nss_freq_perf_sample()
+ *	Measure the NSS ingress load and update the load level
+ *
+ * Every byte received by the NSS is written to and read back from DDR at
+ * least once, more for crypto, so the ethernet ingress byte rate tracks the
+ * fabric bandwidth the firmware needs. The packet rate covers descriptor
+ * traffic of small packets.
+ */
+static void nss_freq_perf_sample(void)
+{
+	uint64_t bytes, pkts, now, delta_ns;
+	uint32_t raw = NSS_FREQ_PERF_LEVEL_IDLE;
+
+	spin_lock_bh(&nss_top_main.stats_lock);
+	bytes = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_ETH_RX_INTERFACE)][NSS_STATS_NODE_RX_BYTES];
+	pkts = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_ETH_RX_INTERFACE)][NSS_STATS_NODE_RX_PKTS];
+	spin_unlock_bh(&nss_top_main.stats_lock);
+
+	now = ktime_to_ns(ktime_get());
+
+	spin_lock_bh(&nss_freq_perf_lock);
+	if (!nss_freq_perf.last_ns || (now <= nss_freq_perf.last_ns)
+			|| (bytes < nss_freq_perf.last_bytes) || (pkts < nss_freq_perf.last_pkts)) {
+		goto done;
+	}
+
+	delta_ns = now - nss_freq_perf.last_ns;
+	nss_freq_perf.mbps = (uint32_t)div64_u64((bytes - nss_freq_perf.last_bytes) * 8 * 1000, delta_ns);
+	nss_freq_perf.kpps = (uint32_t)div64_u64((pkts - nss_freq_perf.last_pkts) * NSEC_PER_MSEC, delta_ns);
+
+	if ((nss_freq_perf.mbps >= nss_freq_perf_turbo_mbps) || (nss_freq_perf.kpps >= nss_freq_perf_turbo_kpps)) {
+		raw = NSS_FREQ_PERF_LEVEL_TURBO;
+	} else if ((nss_freq_perf.mbps >= nss_freq_perf_nominal_mbps) || (nss_freq_perf.kpps >= nss_freq_perf_nominal_kpps)) {
+		raw = NSS_FREQ_PERF_LEVEL_NOMINAL;
+	}
+
+	/*
+	 * Go up at once, come down only after the load stayed lower for a while
+	 */
+	if (raw >= nss_freq_perf.load_level) {
+		nss_freq_perf.load_level = raw;
+		nss_freq_perf.down_count = 0;
+	} else if (++nss_freq_perf.down_count >= nss_freq_perf_down_hold) {
+		nss_freq_perf.load_level = raw;
+		nss_freq_perf.down_count = 0;
+	}
+
+done:
+	nss_freq_perf.last_ns = now;
+	nss_freq_perf.last_bytes = bytes;
+	nss_freq_perf.last_pkts = pkts;
+	spin_unlock_bh(&nss_freq_perf_lock);
+}
+
+/*
+ * nss_freq_perf_adjust()
+ *	Apply the policy to the direction the governor picked
+ */
+static int nss_freq_perf_adjust(struct nss_freq_gov_sample *gs, int dir)
+{
+	switch (nss_freq_perf.policy) {
+	case NSS_FREQ_PERF_POLICY_PERFORMANCE:
+		if (gs->index < (NSS_FREQ_MAX_SCALE - 1)) {
+			gs->trigger = "policy_performance";
+			return 1;
+		}
+
+		return 0;
+
+	case NSS_FREQ_PERF_POLICY_POWERSAVE:
+		if ((dir > 0) && (gs->index >= NSS_FREQ_PERF_POWERSAVE_MAX_INDEX) && !gs->queue_full) {
+			return 0;
+		}
+
+		return dir;
+
+	default:
+		return dir;
+	}
+}
+
+/*
+ * nss_freq_perf_queue_work()
+ *	Queue a fabric only change when the level for the current frequency moved
+ */
+static void nss_freq_perf_queue_work(void)
+{
+	uint32_t frequency = nss_runtime_samples.freq_scale[nss_runtime_samples.freq_scale_index].frequency;
+	uint32_t old, level;
+
+	spin_lock_bh(&nss_freq_perf_lock);
+	old = nss_freq_perf.level;
+	spin_unlock_bh(&nss_freq_perf_lock);
+
+	level = nss_freq_perf_level_get(frequency);
+	if (level == old) {
+		return;
+	}
+
+	nss_work = (nss_work_t *)kmalloc(sizeof(nss_work_t), GFP_ATOMIC);
+	if (!nss_work) {
+		nss_info("NSS FREQ WQ kmalloc fail");
+
+		/*
+		 * The change was not applied; restore the level so the next sample retries it
+		 */
+		spin_lock_bh(&nss_freq_perf_lock);
+		nss_freq_perf.level = old;
+		spin_unlock_bh(&nss_freq_perf_lock);
+		return;
+	}
+
+	nss_info("fabric level %s -> %s policy:%s ingress:%uMbps %ukpps\n",
+			old < NSS_FREQ_PERF_LEVEL_MAX ? nss_freq_perf_level_names[old] : "unknown",
+			nss_freq_perf_level_names[level], nss_freq_perf_policy_names[nss_freq_perf.policy],
+			nss_freq_perf.mbps, nss_freq_perf.kpps);
+
+	INIT_WORK((struct work_struct *)nss_work, nss_wq_function);
+	nss_work->frequency = 0;
+	nss_work->stats_enable = 1;
+	nss_work->fabric_level = level;
+	nss_freq_perf.changes++;
+
+	queue_work(nss_wq, (struct work_struct *)nss_work);
+}
+
+/*
+ * nss_freq_perf_policy_handler()
+ *	Select the perf state policy by name
+ */
+int nss_freq_perf_policy_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	char old[NSS_FREQ_GOVERNOR_NAME_LEN];
+	int ret, i;
+
+	strlcpy(old, nss_freq_perf_policy_name, sizeof(old));
+
+	ret = proc_dostring(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		return ret;
+	}
+
+	for (i = 0; i < NSS_FREQ_PERF_POLICY_MAX; i++) {
+		if (!strcmp(nss_freq_perf_policy_name, nss_freq_perf_policy_names[i])) {
+			nss_freq_perf.policy = i;
+			nss_info("perf policy set to %s\n", nss_freq_perf_policy_names[i]);
+
+			/*
+			 * The fabric follows right away, the core frequency on
+			 * the next sample when auto scaling is on
+			 */
+			if (nss_wq) {
+				nss_freq_perf_queue_work();
+			}
+
+			return 0;
+		}
+	}
+
+	nss_warning("unknown perf policy %s\n", nss_freq_perf_policy_name);
+	strlcpy(nss_freq_perf_policy_name, old, sizeof(nss_freq_perf_policy_name));
+	return -EINVAL;
+}
+
 /*
  *  nss_freq_handle_core_stats()
  *	Handle the core stats
  */
 static void nss_freq_handle_core_stats(struct nss_ctx_instance *nss_ctx, struct nss_core_stats *core_stats)
 {
+	struct nss_core_sampling *cs = &nss_ctx->samples;
+	struct nss_freq_gov_sample gs;
 	uint32_t b_index;
-	uint32_t minimum;
-	uint32_t maximum;
 	uint32_t sample = core_stats->inst_cnt_total;
 	uint32_t index = nss_runtime_samples.freq_scale_index;
+	int dir;
+
+	/*
+	 * Dynamic interface placement weighs cores by this, scaling or not
+	 */
+	nss_ctx->inst_cnt_total = sample;
 
 	/*
 	 * We do not accept any statistics if auto scaling is off,
@@ -164,39 +918,65 @@ static void nss_freq_handle_core_stats(struct nss_ctx_instance *nss_ctx, struct
 		return;
 	}
 
+	/*
+	 * Pick up a governor change requested through sysctl
+	 */
+	if (unlikely(nss_freq_gov != nss_freq_gov_next)) {
+		nss_freq_gov = nss_freq_gov_next;
+		nss_freq_gov->reset();
+	}
+
 	/*
 	 * Delete Current Index Value, Add New Value, Recalculate new Sum, Shift Index
 	 */
-	b_index = nss_runtime_samples.buffer_index;
+	b_index = cs->buffer_index;
 
-	nss_runtime_samples.sum = nss_runtime_samples.sum - nss_runtime_samples.buffer[b_index];
-	nss_runtime_samples.buffer[b_index] = sample;
-	nss_runtime_samples.sum = nss_runtime_samples.sum + nss_runtime_samples.buffer[b_index];
-	nss_runtime_samples.buffer_index = (b_index + 1) & NSS_SAMPLE_BUFFER_MASK;
+	cs->sum = cs->sum - cs->buffer[b_index];
+	cs->buffer[b_index] = sample;
+	cs->sum = cs->sum + cs->buffer[b_index];
+	cs->buffer_index = (b_index + 1) & NSS_SAMPLE_BUFFER_MASK;
+	cs->last = sample;
 
-	if (nss_runtime_samples.sample_count < NSS_SAMPLE_BUFFER_SIZE) {
-		nss_runtime_samples.sample_count++;
+	if (cs->sample_count < NSS_SAMPLE_BUFFER_SIZE) {
+		cs->sample_count++;
 
 		/*
 		 * Samples Are All Ready, Start Auto Scale
 		 */
-		if (nss_runtime_samples.sample_count == NSS_SAMPLE_BUFFER_SIZE ) {
+		if (cs->sample_count == NSS_SAMPLE_BUFFER_SIZE ) {
 			nss_cmd_buf.auto_scale = 1;
 			nss_runtime_samples.freq_scale_ready = 1;
 			nss_runtime_samples.initialized = 1;
+			nss_freq_gov->reset();
+
+			/*
+			 * Prime the queue full baseline so that old events do not count
+			 */
+			nss_freq_gov_ring_sample(&gs);
 		}
 
 		return;
 	}
 
-	nss_runtime_samples.average = nss_runtime_samples.sum / nss_runtime_samples.sample_count;
+	cs->average = cs->sum / cs->sample_count;
+
+	/*
+	 * The cores share one clock: only samples of the busiest core drive it,
+	 * so that an idle core cannot average away a saturated one.
+	 */
+	if (nss_freq_busiest_core() != nss_ctx) {
+		return;
+	}
+
+	nss_runtime_samples.average = cs->average;
+	nss_freq_perf_sample();
 
 	/*
 	 * Print out statistics every 10 samples
 	 */
 	if (nss_runtime_samples.message_rate_limit++ >= NSS_MESSAGE_RATE_LIMIT) {
-		nss_trace("%p: Running AVG:%x Sample:%x Divider:%d\n", nss_ctx, nss_runtime_samples.average, core_stats->inst_cnt_total, nss_runtime_samples.sample_count);
-		nss_trace("%p: Current Frequency Index:%d\n", nss_ctx, index);
+		nss_trace("%p: Running AVG:%x Sample:%x Divider:%d\n", nss_ctx, cs->average, core_stats->inst_cnt_total, cs->sample_count);
+		nss_trace("%p: Current Frequency Index:%d Governor:%s\n", nss_ctx, index, nss_freq_gov->name);
 		nss_trace("%p: Auto Scale:%d Auto Scale Ready:%d\n", nss_ctx, nss_runtime_samples.freq_scale_ready, nss_cmd_buf.auto_scale);
 		nss_trace("%p: Current Rate:%x\n", nss_ctx, nss_runtime_samples.average);
 
@@ -210,56 +990,180 @@ static void nss_freq_handle_core_stats(struct nss_ctx_instance *nss_ctx, struct
 		return;
 	}
 
-	/*
-	 * Scale Algorithmn
-	 *	Algorithmn will limit how fast it will transition each scale, by the number of samples seen.
-	 *	If any sample is out of scale during the idle count, the rate_limit will reset to 0.
-	 *	Scales are limited to the max number of cpu scales we support.
-	 */
-	if (nss_runtime_samples.freq_scale_rate_limit_up++ >= NSS_FREQUENCY_SCALE_RATE_LIMIT_UP) {
-		maximum = nss_runtime_samples.freq_scale[index].maximum;
-		if ((nss_runtime_samples.average > maximum) && (index < (NSS_FREQ_MAX_SCALE - 1))) {
-			nss_runtime_samples.freq_scale_index++;
-			nss_runtime_samples.freq_scale_ready = 0;
+	gs.sample = sample;
+	gs.average = cs->average;
+	gs.trigger = nss_freq_gov->name;
+	gs.index = index;
+	nss_freq_gov_ring_sample(&gs);
 
-			/*
-			 * If fail to increase frequency, decrease index
-			 */
-			nss_trace("frequency increase to %d inst:%x > maximum:%x\n", nss_runtime_samples.freq_scale[nss_runtime_samples.freq_scale_index].frequency, sample, maximum);
-			if (nss_freq_queue_work()) {
-				nss_runtime_samples.freq_scale_index--;
-			}
-		}
+	dir = nss_freq_gov->decide(nss_ctx, &gs);
+	dir = nss_freq_perf_adjust(&gs, dir);
+	if ((dir > 0) && (index < (NSS_FREQ_MAX_SCALE - 1))) {
+		nss_runtime_samples.freq_scale_index++;
+		nss_runtime_samples.freq_scale_ready = 0;
 
 		/*
-		 * Reset the down scale counter based on running average, so can idle properlly
+		 * If fail to increase frequency, decrease index
 		 */
-		if (nss_runtime_samples.average > maximum) {
-			nss_trace("down scale timeout reset running average:%x\n", nss_runtime_samples.average);
-			nss_runtime_samples.freq_scale_rate_limit_down = 0;
+		if (nss_freq_queue_work(gs.trigger)) {
+			nss_runtime_samples.freq_scale_index--;
+		}
+
+		if (nss_freq_gov->transition) {
+			nss_freq_gov->transition();
 		}
 
-		nss_runtime_samples.freq_scale_rate_limit_up = 0;
 		return;
 	}
 
-	if (nss_runtime_samples.freq_scale_rate_limit_down++ >= NSS_FREQUENCY_SCALE_RATE_LIMIT_DOWN) {
-		minimum = nss_runtime_samples.freq_scale[index].minimum;
-		if ((nss_runtime_samples.average < minimum) && (index > 0)) {
-			nss_runtime_samples.freq_scale_index--;
-			nss_runtime_samples.freq_scale_ready = 0;
+	if ((dir < 0) && (index > 0)) {
+		nss_runtime_samples.freq_scale_index--;
+		nss_runtime_samples.freq_scale_ready = 0;
 
-			/*
-			 * If fail to decrease frequency, increase index
-			 */
-			nss_trace("frequency decrease to %d inst:%x < minumum:%x\n", nss_runtime_samples.freq_scale[nss_runtime_samples.freq_scale_index].frequency, nss_runtime_samples.average, minimum);
-			if (nss_freq_queue_work()) {
-				nss_runtime_samples.freq_scale_index++;
-			}
+		/*
+		 * If fail to decrease frequency, increase index
+		 */
+		if (nss_freq_queue_work(gs.trigger)) {
+			nss_runtime_samples.freq_scale_index++;
 		}
-		nss_runtime_samples.freq_scale_rate_limit_down = 0;
+
+		if (nss_freq_gov->transition) {
+			nss_freq_gov->transition();
+		}
+
 		return;
 	}
+
+	/*
+	 * The core frequency stays, the fabric may still need to follow the load
+	 */
+	nss_freq_perf_queue_work();
+}
+
+/*
+ * nss_freq_tm_read()
+ *	Print frequency residency and the recent transitions
+ */
+static ssize_t nss_freq_tm_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_freq_transition *hist;
+	struct nss_freq_perf_state perf;
+	uint64_t residency[NSS_FREQ_MAX_SCALE], residency_other;
+	uint64_t transitions, acked, ack_ns_total, ack_ns_max, now;
+	uint32_t head, current_freq, i, n;
+	size_t size_al = (NSS_FREQ_TRANSITION_HISTORY + NSS_FREQ_MAX_SCALE + 8) * 200;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	char *lbuf;
+
+	hist = kzalloc(sizeof(nss_freq_tm.hist), GFP_KERNEL);
+	if (unlikely(hist == NULL)) {
+		nss_warning("Could not allocate memory for frequency transitions");
+		return 0;
+	}
+
+	lbuf = kzalloc(size_al, GFP_KERNEL);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		kfree(hist);
+		return 0;
+	}
+
+	spin_lock_bh(&nss_freq_tm.lock);
+	now = ktime_to_ns(ktime_get());
+	nss_freq_tm_residency_update(now);
+	memcpy(hist, nss_freq_tm.hist, sizeof(nss_freq_tm.hist));
+	memcpy(residency, nss_freq_tm.residency_ns, sizeof(residency));
+	residency_other = nss_freq_tm.residency_other_ns;
+	head = nss_freq_tm.head;
+	transitions = nss_freq_tm.transitions;
+	acked = nss_freq_tm.acked;
+	ack_ns_total = nss_freq_tm.ack_ns_total;
+	ack_ns_max = nss_freq_tm.ack_ns_max;
+	current_freq = nss_freq_tm.current_freq;
+	spin_unlock_bh(&nss_freq_tm.lock);
+
+	spin_lock_bh(&nss_freq_perf_lock);
+	perf = nss_freq_perf;
+	spin_unlock_bh(&nss_freq_perf_lock);
+
+	size_wr = scnprintf(lbuf, size_al, "current = %u transitions = %llu acked = %llu avg_ack_us = %llu max_ack_us = %llu\n",
+				current_freq, transitions, acked,
+				acked ? div64_u64(ack_ns_total, acked * NSEC_PER_USEC) : 0, div_u64(ack_ns_max, NSEC_PER_USEC));
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"policy = %s fabric = %s load = %s ingress_mbps = %u ingress_kpps = %u fabric_changes = %llu\n",
+				nss_freq_perf_policy_names[perf.policy],
+				perf.level < NSS_FREQ_PERF_LEVEL_MAX ? nss_freq_perf_level_names[perf.level] : "unknown",
+				nss_freq_perf_level_names[perf.load_level], perf.mbps, perf.kpps, perf.changes);
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\nresidency:\n");
+	for (i = 0; i < NSS_FREQ_MAX_SCALE; i++) {
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\t%u: %llu ms\n",
+					nss_runtime_samples.freq_scale[i].frequency, div_u64(residency[i], NSEC_PER_MSEC));
+	}
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\tother: %llu ms\n", div_u64(residency_other, NSEC_PER_MSEC));
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\ntransitions, oldest first:\n");
+	for (n = 0; n < NSS_FREQ_TRANSITION_HISTORY; n++) {
+		struct nss_freq_transition *t = &hist[(head + n) & (NSS_FREQ_TRANSITION_HISTORY - 1)];
+
+		if (!t->start_ns) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"\t-%llums %u -> %u trigger = %s average = %x ",
+				div_u64(now - t->start_ns, NSEC_PER_MSEC), t->from, t->to,
+				t->trigger ? t->trigger : "unknown", t->average);
+
+		if (!t->ack_ns) {
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "pending\n");
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "ack_us = %llu queue_full = %llu drops = %llu\n",
+				div_u64(t->ack_ns - t->start_ns, NSEC_PER_USEC), t->queue_full, t->drops);
+	}
+
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	kfree(lbuf);
+	kfree(hist);
+
+	return bytes_read;
+}
+
+static const struct file_operations nss_freq_tm_ops = {
+	.read = nss_freq_tm_read,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_freq_stats_init()
+ *	Start residency accounting and create the debugfs entry
+ */
+void nss_freq_stats_init(void)
+{
+	spin_lock_init(&nss_freq_tm.lock);
+	nss_freq_tm.current_freq = nss_cmd_buf.current_freq;
+	nss_freq_tm.since_ns = ktime_to_ns(ktime_get());
+
+	nss_freq_tm_dentry = debugfs_create_file("freq", 0400, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_freq_tm_ops);
+	if (unlikely(nss_freq_tm_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/freq file in debugfs");
+	}
+}
+
+/*
+ * nss_freq_stats_exit()
+ *	Remove the debugfs entry
+ */
+void nss_freq_stats_exit(void)
+{
+	debugfs_remove(nss_freq_tm_dentry);
+	nss_freq_tm_dentry = NULL;
 }
 
 /*
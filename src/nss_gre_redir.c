@@ -87,7 +87,7 @@ static void nss_gre_redir_msg_handler(struct nss_ctx_instance *nss_ctx, struct n
 	 * to the same callback/app_data.
 	 */
 	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
-		ncm->cb = (uint32_t)nss_ctx->nss_top->if_rx_msg_callback[ncm->interface];
+		ncm->cb = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].if_rx_msg_cb;
 	}
 
 	/*
@@ -286,7 +286,7 @@ struct nss_ctx_instance *nss_gre_redir_register_if(uint32_t if_num, struct net_d
 	nss_top_main.subsys_dp_register[if_num].app_data = NULL;
 	nss_top_main.subsys_dp_register[if_num].features = features;
 
-        nss_top_main.if_rx_msg_callback[if_num] = cb_func_msg;
+        nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = cb_func_msg;
 
 	spin_lock_bh(&nss_gre_redir_stats_lock);
 	for (i = 0; i < NSS_GRE_REDIR_MAX_INTERFACES; i++) {
@@ -322,7 +322,7 @@ void nss_gre_redir_unregister_if(uint32_t if_num)
 	nss_top_main.subsys_dp_register[if_num].app_data = NULL;
 	nss_top_main.subsys_dp_register[if_num].features = 0;
 
-	nss_top_main.if_rx_msg_callback[if_num] = NULL;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = NULL;
 
 	spin_lock_bh(&nss_gre_redir_stats_lock);
 	for (i = 0; i < NSS_GRE_REDIR_MAX_INTERFACES; i++) {
@@ -473,6 +473,7 @@ int nss_hal_probe(struct platform_device *nss_dev)
 		}
 
 		nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_802_3_REDIR] = nss_dev->id;
+		nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_802_3_REDIR] |= (1 << nss_dev->id);
 	}
 
 	if (npd->ipv4_reasm_enabled == NSS_FEATURE_ENABLED) {
@@ -498,7 +499,8 @@ int nss_hal_probe(struct platform_device *nss_dev)
 
 	if (npd->ipsec_enabled == NSS_FEATURE_ENABLED) {
 		nss_top->ipsec_handler_id = nss_dev->id;
-		nss_ipsec_register_handler();
+		nss_top->ipsec_cores |= (1 << nss_dev->id);
+		nss_ipsec_register_handler(nss_dev->id);
 	}
 
 	if (npd->wlanredirect_enabled == NSS_FEATURE_ENABLED) {
@@ -656,6 +658,13 @@ int nss_hal_remove(struct platform_device *nss_dev)
 		free_netdev(nss_ctx->int_ctx[1].ndev);
 	}
 
+	/*
+	 * Remove the PTP clock before its timestamp source goes away
+	 */
+	if ((nss_top->tstamp_handler_id == nss_dev->id) && nss_top->subsys_dp_register[NSS_TSTAMP_INTERFACE].ndev) {
+		nss_tstamp_unregister_clock();
+	}
+
 	/*
 	 * nss-drv is exiting, remove from nss-gmac
 	 */
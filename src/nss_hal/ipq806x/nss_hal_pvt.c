@@ -1409,11 +1409,13 @@ clk_complete:
 		}
 
 		nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_802_3_REDIR] = nss_dev->id;
+		nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_802_3_REDIR] |= (1 << nss_dev->id);
 	}
 
 	if (npd->capwap_enabled == NSS_FEATURE_ENABLED) {
 		nss_top->capwap_handler_id = nss_dev->id;
 		nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_CAPWAP] = nss_dev->id;
+		nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_CAPWAP] |= (1 << nss_dev->id);
 	}
 
 	if (npd->ipv4_reasm_enabled == NSS_FEATURE_ENABLED) {
@@ -1439,7 +1441,8 @@ clk_complete:
 
 	if (npd->ipsec_enabled == NSS_FEATURE_ENABLED) {
 		nss_top->ipsec_handler_id = nss_dev->id;
-		nss_ipsec_register_handler();
+		nss_top->ipsec_cores |= (1 << nss_dev->id);
+		nss_ipsec_register_handler(nss_dev->id);
 	}
 
 	if (npd->wlanredirect_enabled == NSS_FEATURE_ENABLED) {
@@ -1463,6 +1466,7 @@ clk_complete:
 	if (npd->dtls_enabled == NSS_FEATURE_ENABLED) {
 		nss_top->dtls_handler_id = nss_dev->id;
 		nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_DTLS] = nss_dev->id;
+		nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_DTLS] |= (1 << nss_dev->id);
 		nss_dtls_register_handler();
 	}
 
@@ -1481,6 +1485,7 @@ clk_complete:
 	if (npd->gre_redir_enabled == NSS_FEATURE_ENABLED) {
 		nss_top->gre_redir_handler_id = nss_dev->id;
 		nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_GRE_REDIR] =  nss_dev->id;
+		nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_GRE_REDIR] |= (1 << nss_dev->id);
 		nss_gre_redir_register_handler();
 		nss_sjack_register_handler();
 	}
@@ -1488,14 +1493,18 @@ clk_complete:
 	if (npd->portid_enabled == NSS_FEATURE_ENABLED) {
 		nss_top->portid_handler_id = nss_dev->id;
 		nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_PORTID] = nss_dev->id;
+		nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_PORTID] |= (1 << nss_dev->id);
 		nss_portid_register_handler();
 	}
 
         if (npd->wifioffload_enabled == NSS_FEATURE_ENABLED) {
                 nss_top->wifi_handler_id = nss_dev->id;
                 nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_RADIO_0] =  nss_dev->id;
+                nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_RADIO_0] |= (1 << nss_dev->id);
                 nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_RADIO_1] =  nss_dev->id;
+                nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_RADIO_1] |= (1 << nss_dev->id);
                 nss_top->dynamic_interface_table[NSS_DYNAMIC_INTERFACE_TYPE_RADIO_2] =  nss_dev->id;
+                nss_top->dynamic_interface_cores[NSS_DYNAMIC_INTERFACE_TYPE_RADIO_2] |= (1 << nss_dev->id);
                 nss_wifi_register_handler();
         }
 
@@ -138,69 +138,50 @@ struct platform_driver nss_driver = {
  */
 static void nss_reset_frequency_stats_samples (void)
 {
-	nss_runtime_samples.buffer_index = 0;
-	nss_runtime_samples.sum = 0;
+	int i;
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		memset(&nss_top_main.nss[i].samples, 0, sizeof(nss_top_main.nss[i].samples));
+	}
+
 	nss_runtime_samples.average = 0;
-	nss_runtime_samples.sample_count = 0;
 	nss_runtime_samples.message_rate_limit = 0;
 	nss_runtime_samples.freq_scale_rate_limit_down = 0;
+	nss_freq_perf_reset();
 }
 
 /*
- ***************************************************************************************************
- * nss_wq_function() is used to queue up requests to change NSS frequencies.
- * The function will take care of NSS notices and also control clock.
- * The auto rate algorithmn will queue up requests or the procfs may also queue up these requests.
- ***************************************************************************************************
- */
-
-/*
- * nss_wq_function()
- *	Added to Handle BH requests to kernel
+ * nss_fabric_scale()
+ *	Move the fabric clocks and the bus vote to a perf level
+ *
+ * If we are running NSS_PM_SUPPORT, we are on banana and the level goes
+ * to the msm bus driver. Otherwise, we check if we are are on new kernel
+ * by checking if the fabric lookups are not NULL (success in init()).
  */
-void nss_wq_function (struct work_struct *work)
+static void nss_fabric_scale(uint32_t level)
 {
-	nss_work_t *my_work = (nss_work_t *)work;
-
-	nss_freq_change(&nss_top_main.nss[NSS_CORE_0], my_work->frequency, my_work->stats_enable, 0);
-	if (nss_top_main.nss[NSS_CORE_1].state == NSS_CORE_STATE_INITIALIZED) {
-		nss_freq_change(&nss_top_main.nss[NSS_CORE_1], my_work->frequency, my_work->stats_enable, 0);
-	}
-	clk_set_rate(nss_core0_clk, my_work->frequency);
-	nss_freq_change(&nss_top_main.nss[NSS_CORE_0], my_work->frequency, my_work->stats_enable, 1);
-	if (nss_top_main.nss[NSS_CORE_1].state == NSS_CORE_STATE_INITIALIZED) {
-		nss_freq_change(&nss_top_main.nss[NSS_CORE_1], my_work->frequency, my_work->stats_enable, 1);
-	}
-
-/*
- * If we are running NSS_PM_SUPPORT, we are on banana
- * otherwise, we check if we are are on new kernel by checking if the
- * fabric lookups are not NULL (success in init()))
- */
 #if (NSS_PM_SUPPORT == 1)
 	if (!pm_client) {
-		goto out;
+		return;
 	}
 
-	if (my_work->frequency >= NSS_FREQ_733) {
+	if (level == NSS_FREQ_PERF_LEVEL_TURBO) {
 		nss_pm_set_perf_level(pm_client, NSS_PM_PERF_LEVEL_TURBO);
-	} else if (my_work->frequency > NSS_FREQ_110) {
+	} else if (level == NSS_FREQ_PERF_LEVEL_NOMINAL) {
 		nss_pm_set_perf_level(pm_client, NSS_PM_PERF_LEVEL_NOMINAL);
 	} else {
 		nss_pm_set_perf_level(pm_client, NSS_PM_PERF_LEVEL_IDLE);
 	}
-
-out:
 #else
 #if (NSS_DT_SUPPORT == 1)
 #if (NSS_FABRIC_SCALING_SUPPORT == 1)
 	scale_fabrics();
 #endif
-	if ((nss_fab0_clk != NULL) && (nss_fab0_clk != NULL)) {
-		if (my_work->frequency >= NSS_FREQ_733) {
+	if ((nss_fab0_clk != NULL) && (nss_fab1_clk != NULL)) {
+		if (level == NSS_FREQ_PERF_LEVEL_TURBO) {
 			clk_set_rate(nss_fab0_clk, NSS_FABRIC0_TURBO);
 			clk_set_rate(nss_fab1_clk, NSS_FABRIC1_TURBO);
-		} else if (my_work->frequency > NSS_FREQ_110) {
+		} else if (level == NSS_FREQ_PERF_LEVEL_NOMINAL) {
 			clk_set_rate(nss_fab0_clk, NSS_FABRIC0_NOMINAL);
 			clk_set_rate(nss_fab1_clk, NSS_FABRIC1_NOMINAL);
 		} else {
@@ -210,6 +191,42 @@ out:
 	}
 #endif
 #endif
+}
+
+/*
+ ***************************************************************************************************
+ * nss_wq_function() is used to queue up requests to change NSS frequencies.
+ * The function will take care of NSS notices and also control clock.
+ * The auto rate algorithmn will queue up requests or the procfs may also queue up these requests.
+ * Fabric and bus levels are picked by the perf state manager in nss_freq.c and
+ * may change on their own, with a frequency of 0.
+ ***************************************************************************************************
+ */
+
+/*
+ * nss_wq_function()
+ *	Added to Handle BH requests to kernel
+ */
+void nss_wq_function (struct work_struct *work)
+{
+	nss_work_t *my_work = (nss_work_t *)work;
+
+	if (!my_work->frequency) {
+		goto fabric;
+	}
+
+	nss_freq_change(&nss_top_main.nss[NSS_CORE_0], my_work->frequency, my_work->stats_enable, 0);
+	if (nss_top_main.nss[NSS_CORE_1].state == NSS_CORE_STATE_INITIALIZED) {
+		nss_freq_change(&nss_top_main.nss[NSS_CORE_1], my_work->frequency, my_work->stats_enable, 0);
+	}
+	clk_set_rate(nss_core0_clk, my_work->frequency);
+	nss_freq_change(&nss_top_main.nss[NSS_CORE_0], my_work->frequency, my_work->stats_enable, 1);
+	if (nss_top_main.nss[NSS_CORE_1].state == NSS_CORE_STATE_INITIALIZED) {
+		nss_freq_change(&nss_top_main.nss[NSS_CORE_1], my_work->frequency, my_work->stats_enable, 1);
+	}
+
+fabric:
+	nss_fabric_scale(my_work->fabric_level);
 	kfree((void *)work);
 }
 
@@ -258,9 +275,11 @@ static int nss_current_freq_handler(struct ctl_table *ctl, int write, void __use
 	INIT_WORK((struct work_struct *)nss_work, nss_wq_function);
 	nss_work->frequency = nss_cmd_buf.current_freq;
 	nss_work->stats_enable = 0;
+	nss_freq_transition_start(nss_cmd_buf.current_freq, "manual");
 
 	/* Ensure we start with a fresh set of samples later */
 	nss_reset_frequency_stats_samples();
+	nss_work->fabric_level = nss_freq_perf_level_get(nss_work->frequency);
 
 	queue_work(nss_wq, (struct work_struct *)nss_work);
 
@@ -296,6 +315,8 @@ static int nss_auto_scale_handler(struct ctl_table *ctl, int write, void __user
 			INIT_WORK((struct work_struct *)nss_work, nss_wq_function);
 			nss_work->frequency = nss_cmd_buf.current_freq;
 			nss_work->stats_enable = 0;
+			nss_work->fabric_level = nss_freq_perf_level_get(nss_work->frequency);
+			nss_freq_transition_start(nss_cmd_buf.current_freq, "auto_scale_off");
 			queue_work(nss_wq, (struct work_struct *)nss_work);
 			nss_runtime_samples.freq_scale_ready = 0;
 
@@ -329,6 +350,8 @@ static int nss_auto_scale_handler(struct ctl_table *ctl, int write, void __user
 	INIT_WORK((struct work_struct *)nss_work, nss_wq_function);
 	nss_work->frequency = nss_cmd_buf.current_freq;
 	nss_work->stats_enable = 1;
+	nss_work->fabric_level = nss_freq_perf_level_get(nss_work->frequency);
+	nss_freq_transition_start(nss_cmd_buf.current_freq, "auto_scale_on");
 	queue_work(nss_wq, (struct work_struct *)nss_work);
 
 	nss_cmd_buf.auto_scale = 0;
@@ -370,7 +393,7 @@ static int nss_get_freq_table_handler(struct ctl_table *ctl, int write, void __u
  */
 static int nss_get_average_inst_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
 {
-	int ret;
+	int ret, i;
 
 	ret = proc_dointvec(ctl, write, buffer, lenp, ppos);
 
@@ -379,6 +402,9 @@ static int nss_get_average_inst_handler(struct ctl_table *ctl, int write, void _
 	}
 
 	printk("Current Inst Per Ms %x\n", nss_runtime_samples.average);
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		nss_trace("Core %d Inst Per Ms %x\n", i, nss_top_main.nss[i].samples.average);
+	}
 
 	*lenp = 0;
 	return ret;
@@ -501,6 +527,125 @@ static struct ctl_table nss_freq_table[] = {
 		.mode			= 0644,
 		.proc_handler	= &nss_get_average_inst_handler,
 	},
+	{
+		.procname		= "governor",
+		.data			= nss_freq_governor_name,
+		.maxlen			= NSS_FREQ_GOVERNOR_NAME_LEN,
+		.mode			= 0644,
+		.proc_handler	= &nss_freq_governor_handler,
+	},
+	{
+		.procname		= "pid_kp",
+		.data			= &nss_freq_pid_kp,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_ki",
+		.data			= &nss_freq_pid_ki,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_kd",
+		.data			= &nss_freq_pid_kd,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_ewma_shift",
+		.data			= &nss_freq_pid_ewma_shift,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_target",
+		.data			= &nss_freq_pid_target,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_ring_target",
+		.data			= &nss_freq_pid_ring_target,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_ring_gain",
+		.data			= &nss_freq_pid_ring_gain,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_up_threshold",
+		.data			= &nss_freq_pid_up_threshold,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_down_threshold",
+		.data			= &nss_freq_pid_down_threshold,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "pid_down_hold",
+		.data			= &nss_freq_pid_down_hold,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "perf_policy",
+		.data			= nss_freq_perf_policy_name,
+		.maxlen			= NSS_FREQ_GOVERNOR_NAME_LEN,
+		.mode			= 0644,
+		.proc_handler	= &nss_freq_perf_policy_handler,
+	},
+	{
+		.procname		= "perf_nominal_mbps",
+		.data			= &nss_freq_perf_nominal_mbps,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "perf_turbo_mbps",
+		.data			= &nss_freq_perf_turbo_mbps,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "perf_nominal_kpps",
+		.data			= &nss_freq_perf_nominal_kpps,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "perf_turbo_kpps",
+		.data			= &nss_freq_perf_turbo_kpps,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
+	{
+		.procname		= "perf_down_hold",
+		.data			= &nss_freq_perf_down_hold,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler	= &proc_dointvec,
+	},
 	{ }
 };
 #endif
@@ -550,6 +695,41 @@ static struct ctl_table nss_general_table[] = {
 		.mode                   = 0644,
 		.proc_handler           = &nss_paged_mode_handler,
 	},
+	{
+		.procname               = "virt_if_egress_limit",
+		.data                   = &nss_core_virt_if_egress_limit,
+		.maxlen                 = sizeof(int),
+		.mode                   = 0644,
+		.proc_handler           = proc_dointvec,
+	},
+	{
+		.procname               = "virt_if_egress_max_age_ms",
+		.data                   = &nss_core_virt_if_egress_max_age_ms,
+		.maxlen                 = sizeof(int),
+		.mode                   = 0644,
+		.proc_handler           = proc_dointvec,
+	},
+	{
+		.procname               = "napi_stats",
+		.data                   = &nss_core_napi_stats_enable,
+		.maxlen                 = sizeof(int),
+		.mode                   = 0644,
+		.proc_handler           = proc_dointvec,
+	},
+	{
+		.procname               = "stats_rate_interval_ms",
+		.data                   = &nss_stats_rate_interval_ms,
+		.maxlen                 = sizeof(int),
+		.mode                   = 0644,
+		.proc_handler           = &nss_stats_rate_interval_handler,
+	},
+	{
+		.procname               = "msg_latency",
+		.data                   = &nss_msg_lat_enable,
+		.maxlen                 = sizeof(int),
+		.mode                   = 0644,
+		.proc_handler           = &nss_msg_lat_enable_handler,
+	},
 	{ }
 };
 
@@ -566,6 +746,26 @@ static struct ctl_table nss_clock_dir[] = {
 		.mode                   = 0555,
 		.child                  = nss_general_table,
 	},
+	{
+		.procname               = "conn_sync",
+		.mode                   = 0555,
+		.child                  = nss_conn_sync_table,
+	},
+	{
+		.procname               = "flow_stats",
+		.mode                   = 0555,
+		.child                  = nss_flow_stats_table,
+	},
+	{
+		.procname               = "dynamic_if",
+		.mode                   = 0555,
+		.child                  = nss_dynamic_interface_table,
+	},
+	{
+		.procname               = "pkt_lat",
+		.mode                   = 0555,
+		.child                  = nss_pkt_lat_table,
+	},
 	{ }
 };
 
@@ -660,6 +860,36 @@ static int __init nss_init(void)
 	 */
 	nss_stats_init();
 
+	/*
+	 * Register the statistics generic netlink family
+	 */
+	nss_stats_genl_init();
+
+	/*
+	 * Initialize the per-flow statistics cache
+	 */
+	nss_flow_stats_init();
+
+	/*
+	 * Initialize the connection stats pull engine
+	 */
+	nss_conn_sync_init();
+
+	/*
+	 * Initialize control message latency tracking
+	 */
+	nss_msg_lat_init();
+
+	/*
+	 * Initialize the optional data path latency telemetry
+	 */
+	nss_pkt_lat_init();
+
+	/*
+	 * Initialize the dynamic interface node pools and placement
+	 */
+	nss_dynamic_interface_init();
+
 	/*
 	 * Register sysctl table.
 	 */
@@ -682,15 +912,19 @@ static int __init nss_init(void)
 	nss_runtime_samples.freq_scale_index = 1;
 	nss_runtime_samples.freq_scale_ready = 0;
 	nss_runtime_samples.freq_scale_rate_limit_down = 0;
-	nss_runtime_samples.buffer_index = 0;
-	nss_runtime_samples.sum = 0;
-	nss_runtime_samples.sample_count = 0;
 	nss_runtime_samples.average = 0;
 	nss_runtime_samples.message_rate_limit = 0;
 	nss_runtime_samples.initialized = 0;
 
 	nss_cmd_buf.current_freq = nss_runtime_samples.freq_scale[nss_runtime_samples.freq_scale_index].frequency;
 
+#if (NSS_FREQ_SCALE_SUPPORT == 1)
+	/*
+	 * Frequency transition telemetry
+	 */
+	nss_freq_stats_init();
+#endif
+
 	/*
 	 * Initial Workqueue
 	 */
@@ -754,9 +988,23 @@ static void __exit nss_cleanup(void)
 
 	nss_info("Exit NSS driver");
 
+	/*
+	 * Unregister sysctl first; its handlers reach into the modules torn down below
+	 */
 	if (nss_dev_header)
 		unregister_sysctl_table(nss_dev_header);
 
+	nss_stats_genl_exit();
+	nss_flow_stats_exit();
+	nss_conn_sync_exit();
+	nss_dynamic_interface_exit();
+	nss_session_stats_exit();
+	nss_pkt_lat_exit();
+	nss_msg_lat_exit();
+#if (NSS_FREQ_SCALE_SUPPORT == 1)
+	nss_freq_stats_exit();
+#endif
+
 	/*
 	 * Unregister n2h specific sysctl
 	 */
@@ -778,6 +1026,8 @@ static void __exit nss_cleanup(void)
 	nss_data_plane_destroy_delay_work();
 
 	platform_driver_unregister(&nss_driver);
+
+	nss_core_if_registry_exit();
 }
 
 module_init(nss_init);
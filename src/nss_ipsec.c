@@ -34,7 +34,7 @@
 
 /*
  * nss_ipsec_set_msg_callback()
- * 	this sets the message callback handler and its associated context
+ * 	this sets the message callback handler and its associated context for the core of nss_ctx
  */
 static inline nss_tx_status_t nss_ipsec_set_msg_callback(struct nss_ctx_instance *nss_ctx, uint32_t if_num,
 							nss_ipsec_msg_callback_t cb, void *ipsec_ctx)
@@ -45,13 +45,13 @@ static inline nss_tx_status_t nss_ipsec_set_msg_callback(struct nss_ctx_instance
 
 	switch (if_num) {
 	case NSS_IPSEC_ENCAP_IF_NUMBER:
-		nss_top->ipsec_encap_ctx = ipsec_ctx;
-		nss_top->ipsec_encap_callback = cb;
+		nss_top->ipsec_encap_ctx[nss_ctx->id] = ipsec_ctx;
+		nss_top->ipsec_encap_callback[nss_ctx->id] = cb;
 		break;
 
 	case NSS_IPSEC_DECAP_IF_NUMBER:
-		nss_top->ipsec_decap_ctx = ipsec_ctx;
-		nss_top->ipsec_decap_callback = cb;
+		nss_top->ipsec_decap_ctx[nss_ctx->id] = ipsec_ctx;
+		nss_top->ipsec_decap_callback[nss_ctx->id] = cb;
 		break;
 
 	default:
@@ -64,7 +64,7 @@ static inline nss_tx_status_t nss_ipsec_set_msg_callback(struct nss_ctx_instance
 
 /*
  * nss_ipsec_get_msg_callback()
- * 	this gets the message callback handler and its associated context
+ * 	this gets the message callback handler and its associated context for the core of nss_ctx
  */
 static inline nss_ipsec_msg_callback_t nss_ipsec_get_msg_callback(struct nss_ctx_instance *nss_ctx, uint32_t if_num, void **ipsec_ctx)
 {
@@ -74,12 +74,12 @@ static inline nss_ipsec_msg_callback_t nss_ipsec_get_msg_callback(struct nss_ctx
 
 	switch (if_num) {
 	case NSS_IPSEC_ENCAP_IF_NUMBER:
-		*ipsec_ctx = nss_top->ipsec_encap_ctx;
-		return nss_top->ipsec_encap_callback;
+		*ipsec_ctx = nss_top->ipsec_encap_ctx[nss_ctx->id];
+		return nss_top->ipsec_encap_callback[nss_ctx->id];
 
 	case NSS_IPSEC_DECAP_IF_NUMBER:
-		*ipsec_ctx = nss_top->ipsec_decap_ctx;
-		return nss_top->ipsec_decap_callback;
+		*ipsec_ctx = nss_top->ipsec_decap_ctx[nss_ctx->id];
+		return nss_top->ipsec_decap_callback[nss_ctx->id];
 
 	default:
 		*ipsec_ctx = NULL;
@@ -136,9 +136,9 @@ static void nss_ipsec_msg_handler(struct nss_ctx_instance *nss_ctx, struct nss_c
 	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
 		ncm->cb = (uint32_t)nss_ipsec_get_msg_callback(nss_ctx, if_num, &ipsec_ctx);
 		ncm->app_data = (uint32_t)ipsec_ctx;
+		NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->stats_ipsec[NSS_STATS_IPSEC_RX_NOTIFY]);
 	}
 
-
 	nss_core_log_msg_failures(nss_ctx, ncm);
 
 	/*
@@ -222,35 +222,43 @@ nss_tx_status_t nss_ipsec_tx_msg(struct nss_ctx_instance *nss_ctx, struct nss_ip
 	nss_hal_send_interrupt(nss_ctx->nmap, nss_ctx->h2n_desc_rings[NSS_IF_CMD_QUEUE].desc_ring.int_bit,
 									NSS_REGS_H2N_INTR_STATUS_DATA_COMMAND_QUEUE);
 
+	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->stats_ipsec[NSS_STATS_IPSEC_TX_MSG]);
 	return NSS_TX_SUCCESS;
 }
 EXPORT_SYMBOL(nss_ipsec_tx_msg);
 
 /*
- * nss_ipsec_tx_buf
- * 	Send data packet for ipsec processing
+ * nss_ipsec_tx_buf_ctx
+ * 	Send data packet for ipsec processing on the core of nss_ctx
  */
-nss_tx_status_t nss_ipsec_tx_buf(struct sk_buff *skb, uint32_t if_num)
+nss_tx_status_t nss_ipsec_tx_buf_ctx(struct nss_ctx_instance *nss_ctx, struct sk_buff *skb, uint32_t if_num)
 {
 	int32_t status;
-	struct nss_ctx_instance *nss_ctx = &nss_top_main.nss[nss_top_main.ipsec_handler_id];
-	uint16_t int_bit = nss_ctx->h2n_desc_rings[NSS_IF_DATA_QUEUE_0].desc_ring.int_bit;
+	uint16_t int_bit;
 
 	nss_trace("%p: IPsec If Tx packet, id:%d, data=%p", nss_ctx, if_num, skb->data);
 
+	if ((nss_ctx->id >= NSS_MAX_CORES) || !(nss_top_main.ipsec_cores & (1 << nss_ctx->id))) {
+		nss_ipsec_warning("%p: tx received for core %d not running IPsec", nss_ctx, nss_ctx->id);
+		return NSS_TX_FAILURE;
+	}
+
 	NSS_VERIFY_CTX_MAGIC(nss_ctx);
 	if (unlikely(nss_ctx->state != NSS_CORE_STATE_INITIALIZED)) {
 		nss_warning("%p: 'IPsec If Tx' packet dropped as core not ready", nss_ctx);
 		return NSS_TX_FAILURE_NOT_READY;
 	}
 
+	int_bit = nss_ctx->h2n_desc_rings[NSS_IF_DATA_QUEUE_0].desc_ring.int_bit;
 	status = nss_core_send_buffer(nss_ctx, if_num, skb, NSS_IF_DATA_QUEUE_0, H2N_BUFFER_PACKET, 0);
 	if (unlikely(status != NSS_CORE_STATUS_SUCCESS)) {
 		nss_warning("%p: Unable to enqueue 'IPsec If Tx' packet\n", nss_ctx);
 		if (status == NSS_CORE_STATUS_FAILURE_QUEUE) {
+			NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->stats_ipsec[NSS_STATS_IPSEC_TX_QUEUE_FULL]);
 			return NSS_TX_FAILURE_QUEUE;
 		}
 
+		NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->stats_ipsec[NSS_STATS_IPSEC_TX_FAILED]);
 		return NSS_TX_FAILURE;
 	}
 
@@ -259,8 +267,20 @@ nss_tx_status_t nss_ipsec_tx_buf(struct sk_buff *skb, uint32_t if_num)
 	 */
 	nss_hal_send_interrupt(nss_ctx->nmap, int_bit, NSS_REGS_H2N_INTR_STATUS_DATA_COMMAND_QUEUE);
 	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->nss_top->stats_drv[NSS_STATS_DRV_TX_PACKET]);
+	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->stats_ipsec[(if_num == NSS_IPSEC_DECAP_IF_NUMBER) ?
+				NSS_STATS_IPSEC_DECAP_TX_PACKETS : NSS_STATS_IPSEC_ENCAP_TX_PACKETS]);
 	return NSS_TX_SUCCESS;
 }
+EXPORT_SYMBOL(nss_ipsec_tx_buf_ctx);
+
+/*
+ * nss_ipsec_tx_buf
+ * 	Send data packet for ipsec processing on the default IPsec core
+ */
+nss_tx_status_t nss_ipsec_tx_buf(struct sk_buff *skb, uint32_t if_num)
+{
+	return nss_ipsec_tx_buf_ctx(&nss_top_main.nss[nss_top_main.ipsec_handler_id], skb, if_num);
+}
 EXPORT_SYMBOL(nss_ipsec_tx_buf);
 
 /*
@@ -270,14 +290,19 @@ EXPORT_SYMBOL(nss_ipsec_tx_buf);
  */
 
 /*
- * nss_ipsec_notify_register()
- * 	register message notifier for the given interface (if_num)
+ * nss_ipsec_notify_register_core()
+ * 	register message notifier for the given interface (if_num) of an IPsec core
  */
-struct nss_ctx_instance *nss_ipsec_notify_register(uint32_t if_num, nss_ipsec_msg_callback_t cb, void *app_data)
+struct nss_ctx_instance *nss_ipsec_notify_register_core(uint8_t core_id, uint32_t if_num, nss_ipsec_msg_callback_t cb, void *app_data)
 {
 	struct nss_ctx_instance *nss_ctx;
 
-	nss_ctx = &nss_top_main.nss[nss_top_main.ipsec_handler_id];
+	if ((core_id >= NSS_MAX_CORES) || !(nss_top_main.ipsec_cores & (1 << core_id))) {
+		nss_ipsec_warning("notify register received for core %d not running IPsec", core_id);
+		return NULL;
+	}
+
+	nss_ctx = &nss_top_main.nss[core_id];
 
 	if (if_num >= NSS_MAX_NET_INTERFACES) {
 		nss_ipsec_warning("%p: notfiy register received for invalid interface %d", nss_ctx, if_num);
@@ -287,7 +312,7 @@ struct nss_ctx_instance *nss_ipsec_notify_register(uint32_t if_num, nss_ipsec_ms
 	/*
 	 * avoid multiple registeration for multiple tunnels
 	 */
-	if (nss_ctx->nss_top->ipsec_encap_callback && nss_ctx->nss_top->ipsec_decap_callback) {
+	if (nss_ctx->nss_top->ipsec_encap_callback[core_id] && nss_ctx->nss_top->ipsec_decap_callback[core_id]) {
 		return nss_ctx;
 	}
 
@@ -298,6 +323,16 @@ struct nss_ctx_instance *nss_ipsec_notify_register(uint32_t if_num, nss_ipsec_ms
 
 	return nss_ctx;
 }
+EXPORT_SYMBOL(nss_ipsec_notify_register_core);
+
+/*
+ * nss_ipsec_notify_register()
+ * 	register message notifier for the given interface (if_num) of the default IPsec core
+ */
+struct nss_ctx_instance *nss_ipsec_notify_register(uint32_t if_num, nss_ipsec_msg_callback_t cb, void *app_data)
+{
+	return nss_ipsec_notify_register_core(nss_top_main.ipsec_handler_id, if_num, cb, app_data);
+}
 EXPORT_SYMBOL(nss_ipsec_notify_register);
 
 /*
@@ -321,6 +356,9 @@ EXPORT_SYMBOL(nss_ipsec_notify_unregister);
 /*
  * nss_ipsec_data_register()
  * 	register a data callback routine
+ *
+ * The data callbacks are kept per interface, not per core, so one
+ * registration serves the packets of every IPsec core.
  */
 struct nss_ctx_instance *nss_ipsec_data_register(uint32_t if_num, nss_ipsec_buf_callback_t cb, struct net_device *netdev, uint32_t features)
 {
@@ -398,17 +436,57 @@ struct nss_ctx_instance *nss_ipsec_get_context(void)
 }
 EXPORT_SYMBOL(nss_ipsec_get_context);
 
+/*
+ * nss_ipsec_get_context_by_sa()
+ * 	get NSS context instance of the IPsec core an SA is placed on
+ *
+ * The same sa_hash always selects the same core, so the rules and packets
+ * of an SA stay on one core while different SAs spread over all IPsec cores.
+ */
+struct nss_ctx_instance *nss_ipsec_get_context_by_sa(uint32_t sa_hash)
+{
+	uint32_t cores = nss_top_main.ipsec_cores;
+	uint32_t pick;
+	uint8_t core;
+
+	if (hweight32(cores) <= 1) {
+		return &nss_top_main.nss[nss_top_main.ipsec_handler_id];
+	}
+
+	pick = sa_hash % hweight32(cores);
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		if (!(cores & (1 << core))) {
+			continue;
+		}
+
+		if (!pick--) {
+			break;
+		}
+	}
+
+	return &nss_top_main.nss[core];
+}
+EXPORT_SYMBOL(nss_ipsec_get_context_by_sa);
+
 /*
  * nss_ipsec_register_handler()
+ * 	set up IPsec message handling for a core running IPsec
  */
-void nss_ipsec_register_handler()
+void nss_ipsec_register_handler(uint8_t core_id)
 {
-	struct nss_ctx_instance *nss_ctx = &nss_top_main.nss[nss_top_main.ipsec_handler_id];
+	struct nss_ctx_instance *nss_ctx = &nss_top_main.nss[core_id];
 
 	nss_ipsec_set_msg_callback(nss_ctx, NSS_IPSEC_ENCAP_IF_NUMBER, NULL, NULL);
-	nss_core_register_handler(NSS_IPSEC_ENCAP_IF_NUMBER, nss_ipsec_msg_handler, NULL);
-
 	nss_ipsec_set_msg_callback(nss_ctx, NSS_IPSEC_DECAP_IF_NUMBER, NULL, NULL);
+
+	/*
+	 * The interface handlers are shared by all IPsec cores; register them once
+	 */
+	if (nss_top_main.ipsec_cores != (1 << core_id)) {
+		return;
+	}
+
+	nss_core_register_handler(NSS_IPSEC_ENCAP_IF_NUMBER, nss_ipsec_msg_handler, NULL);
 	nss_core_register_handler(NSS_IPSEC_DECAP_IF_NUMBER, nss_ipsec_msg_handler, NULL);
 }
 
@@ -50,6 +50,20 @@ static void nss_ipv6_driver_conn_sync_update(struct nss_ctx_instance *nss_ctx, s
 	nss_top->stats_ipv6[NSS_STATS_IPV6_ACCELERATED_TX_PKTS] += nics->flow_tx_packet_count + nics->return_tx_packet_count;
 	nss_top->stats_ipv6[NSS_STATS_IPV6_ACCELERATED_TX_BYTES] += nics->flow_tx_byte_count + nics->return_tx_byte_count;
 	spin_unlock_bh(&nss_top->stats_lock);
+
+	/*
+	 * Per-flow accounting, if enabled
+	 */
+	if (unlikely(nss_flow_stats_enable)) {
+		nss_flow_stats_ipv6_sync(nics);
+	}
+
+	/*
+	 * Per-connection sync lag, if the pull engine is running
+	 */
+	if (unlikely(nss_conn_sync_enable)) {
+		nss_conn_sync_ipv6_record(nics);
+	}
 }
 
 /*
@@ -71,6 +85,9 @@ static void nss_ipv6_driver_conn_sync_many_update(struct nss_ctx_instance *nss_c
 	for (i = 0; i < nicsm->count; i++) {
 		nss_ipv6_driver_conn_sync_update(nss_ctx, &nicsm->conn_sync[i]);
 	}
+
+	nss_stats_genl_conn_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_IPV6, nicsm->conn_sync,
+					sizeof(struct nss_ipv6_conn_sync), nicsm->count);
 }
 
 /*
@@ -86,11 +103,11 @@ static void nss_ipv6_driver_node_sync_update(struct nss_ctx_instance *nss_ctx, s
 	 * Update statistics maintained by NSS driver
 	 */
 	spin_lock_bh(&nss_top->stats_lock);
-	nss_top->stats_node[NSS_IPV6_RX_INTERFACE][NSS_STATS_NODE_RX_PKTS] += nins->node_stats.rx_packets;
-	nss_top->stats_node[NSS_IPV6_RX_INTERFACE][NSS_STATS_NODE_RX_BYTES] += nins->node_stats.rx_bytes;
-	nss_top->stats_node[NSS_IPV6_RX_INTERFACE][NSS_STATS_NODE_RX_DROPPED] += nins->node_stats.rx_dropped;
-	nss_top->stats_node[NSS_IPV6_RX_INTERFACE][NSS_STATS_NODE_TX_PKTS] += nins->node_stats.tx_packets;
-	nss_top->stats_node[NSS_IPV6_RX_INTERFACE][NSS_STATS_NODE_TX_BYTES] += nins->node_stats.tx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_RX_INTERFACE)][NSS_STATS_NODE_RX_PKTS] += nins->node_stats.rx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_RX_INTERFACE)][NSS_STATS_NODE_RX_BYTES] += nins->node_stats.rx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_RX_INTERFACE)][NSS_STATS_NODE_RX_DROPPED] += nins->node_stats.rx_dropped;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_RX_INTERFACE)][NSS_STATS_NODE_TX_PKTS] += nins->node_stats.tx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_RX_INTERFACE)][NSS_STATS_NODE_TX_BYTES] += nins->node_stats.tx_bytes;
 
 	nss_top->stats_ipv6[NSS_STATS_IPV6_CONNECTION_CREATE_REQUESTS] += nins->ipv6_connection_create_requests;
 	nss_top->stats_ipv6[NSS_STATS_IPV6_CONNECTION_CREATE_COLLISIONS] += nins->ipv6_connection_create_collisions;
@@ -154,6 +171,8 @@ static void nss_ipv6_rx_msg_handler(struct nss_ctx_instance *nss_ctx, struct nss
 		* Update driver statistics on node sync.
 		*/
 		nss_ipv6_driver_node_sync_update(nss_ctx, &nim->msg.node_stats);
+		nss_stats_genl_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_NODE, NSS_IPV6_RX_INTERFACE);
+		nss_stats_genl_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_IPV6, 0);
 		break;
 
 	case NSS_IPV6_RX_CONN_STATS_SYNC_MSG:
@@ -161,6 +180,8 @@ static void nss_ipv6_rx_msg_handler(struct nss_ctx_instance *nss_ctx, struct nss
 		 * Update driver statistics on connection sync.
 		 */
 		nss_ipv6_driver_conn_sync_update(nss_ctx, &nim->msg.conn_stats);
+		nss_stats_genl_conn_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_IPV6, &nim->msg.conn_stats,
+						sizeof(struct nss_ipv6_conn_sync), 1);
 		break;
 
 	case NSS_IPV6_TX_CONN_STATS_SYNC_MANY_MSG:
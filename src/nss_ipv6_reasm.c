@@ -33,11 +33,11 @@ static void nss_ipv6_reasm_stats_sync(struct nss_ctx_instance *nss_ctx, struct n
 	/*
 	 * Common node stats
 	 */
-	nss_top->stats_node[NSS_IPV6_REASM_INTERFACE][NSS_STATS_NODE_RX_PKTS] += nirs->node_stats.rx_packets;
-	nss_top->stats_node[NSS_IPV6_REASM_INTERFACE][NSS_STATS_NODE_RX_BYTES] += nirs->node_stats.rx_bytes;
-	nss_top->stats_node[NSS_IPV6_REASM_INTERFACE][NSS_STATS_NODE_RX_DROPPED] += nirs->node_stats.rx_dropped;
-	nss_top->stats_node[NSS_IPV6_REASM_INTERFACE][NSS_STATS_NODE_TX_PKTS] += nirs->node_stats.tx_packets;
-	nss_top->stats_node[NSS_IPV6_REASM_INTERFACE][NSS_STATS_NODE_TX_BYTES] += nirs->node_stats.tx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_REASM_INTERFACE)][NSS_STATS_NODE_RX_PKTS] += nirs->node_stats.rx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_REASM_INTERFACE)][NSS_STATS_NODE_RX_BYTES] += nirs->node_stats.rx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_REASM_INTERFACE)][NSS_STATS_NODE_RX_DROPPED] += nirs->node_stats.rx_dropped;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_REASM_INTERFACE)][NSS_STATS_NODE_TX_PKTS] += nirs->node_stats.tx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_REASM_INTERFACE)][NSS_STATS_NODE_TX_BYTES] += nirs->node_stats.tx_bytes;
 
 	/*
 	 * IPv6 reasm node stats
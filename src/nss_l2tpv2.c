@@ -18,30 +18,24 @@
 #include <net/sock.h>
 #include "nss_tx_rx_common.h"
 
-/*
- * Data structures to store l2tpv2 nss debug stats
- */
-static DEFINE_SPINLOCK(nss_l2tpv2_session_debug_stats_lock);
-static struct nss_stats_l2tpv2_session_debug  nss_l2tpv2_session_debug_stats[NSS_MAX_L2TPV2_DYNAMIC_INTERFACES];
-
 /*
  * nss_l2tpv2_session_debug_stats_sync
  *	Per session debug stats for l2tpv2
  */
 void nss_l2tpv2_session_debug_stats_sync(struct nss_ctx_instance *nss_ctx, struct nss_l2tpv2_sync_session_stats_msg *stats_msg, uint16_t if_num)
 {
-	int i;
-	spin_lock_bh(&nss_l2tpv2_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_L2TPV2_DYNAMIC_INTERFACES; i++) {
-		if (nss_l2tpv2_session_debug_stats[i].if_num == if_num) {
-			nss_l2tpv2_session_debug_stats[i].stats[NSS_STATS_L2TPV2_SESSION_RX_PPP_LCP_PKTS] += stats_msg->debug_stats.rx_ppp_lcp_pkts;
-			nss_l2tpv2_session_debug_stats[i].stats[NSS_STATS_L2TPV2_SESSION_RX_EXP_DATA_PKTS] += stats_msg->debug_stats.rx_exception_data_pkts;
-			nss_l2tpv2_session_debug_stats[i].stats[NSS_STATS_L2TPV2_SESSION_ENCAP_PBUF_ALLOC_FAIL_PKTS] += stats_msg->debug_stats.encap_pbuf_alloc_fail;
-			nss_l2tpv2_session_debug_stats[i].stats[NSS_STATS_L2TPV2_SESSION_DECAP_PBUF_ALLOC_FAIL_PKTS] += stats_msg->debug_stats.decap_pbuf_alloc_fail;
-			break;
-		}
+	uint64_t *stats;
+
+	stats = nss_session_stats_update_begin(NSS_SESSION_STATS_TYPE_L2TPV2, if_num);
+	if (!stats) {
+		return;
 	}
-	spin_unlock_bh(&nss_l2tpv2_session_debug_stats_lock);
+
+	stats[NSS_STATS_L2TPV2_SESSION_RX_PPP_LCP_PKTS] += stats_msg->debug_stats.rx_ppp_lcp_pkts;
+	stats[NSS_STATS_L2TPV2_SESSION_RX_EXP_DATA_PKTS] += stats_msg->debug_stats.rx_exception_data_pkts;
+	stats[NSS_STATS_L2TPV2_SESSION_ENCAP_PBUF_ALLOC_FAIL_PKTS] += stats_msg->debug_stats.encap_pbuf_alloc_fail;
+	stats[NSS_STATS_L2TPV2_SESSION_DECAP_PBUF_ALLOC_FAIL_PKTS] += stats_msg->debug_stats.decap_pbuf_alloc_fail;
+	nss_session_stats_update_end(stats);
 }
 
 /*
@@ -51,21 +45,21 @@ void nss_l2tpv2_session_debug_stats_sync(struct nss_ctx_instance *nss_ctx, struc
 void nss_l2tpv2_session_debug_stats_get(void *stats_mem)
 {
 	struct nss_stats_l2tpv2_session_debug *stats = (struct nss_stats_l2tpv2_session_debug *)stats_mem;
-	int i;
+	int i, n = 0;
 
 	if (!stats) {
 		nss_warning("No memory to copy l2tpv2 session stats");
 		return;
 	}
 
-	spin_lock_bh(&nss_l2tpv2_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_L2TPV2_DYNAMIC_INTERFACES; i++) {
-		if (nss_l2tpv2_session_debug_stats[i].valid) {
-			memcpy(stats, &nss_l2tpv2_session_debug_stats[i], sizeof(struct nss_stats_l2tpv2_session_debug));
+	for (i = 0; (i < NSS_MAX_DYNAMIC_INTERFACES) && (n < NSS_MAX_L2TPV2_DYNAMIC_INTERFACES); i++) {
+		if (nss_session_stats_read(NSS_SESSION_STATS_TYPE_L2TPV2, NSS_DYNAMIC_IF_START + i, &stats->if_index, stats->stats)) {
+			stats->if_num = NSS_DYNAMIC_IF_START + i;
+			stats->valid = true;
 			stats++;
+			n++;
 		}
 	}
-	spin_unlock_bh(&nss_l2tpv2_session_debug_stats_lock);
 }
 
 /*
@@ -219,8 +213,6 @@ nss_tx_status_t nss_l2tpv2_tx(struct nss_ctx_instance *nss_ctx, struct nss_l2tpv
 struct nss_ctx_instance *nss_register_l2tpv2_if(uint32_t if_num, nss_l2tpv2_callback_t l2tpv2_callback,
 			nss_l2tpv2_msg_callback_t event_callback, struct net_device *netdev, uint32_t features)
 {
-
-	int i = 0;
 	nss_assert(nss_is_dynamic_interface(if_num));
 
 	nss_top_main.subsys_dp_register[if_num].ndev = netdev;
@@ -232,16 +224,7 @@ struct nss_ctx_instance *nss_register_l2tpv2_if(uint32_t if_num, nss_l2tpv2_call
 
 	nss_core_register_handler(if_num, nss_l2tpv2_handler, NULL);
 
-	spin_lock_bh(&nss_l2tpv2_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_L2TPV2_DYNAMIC_INTERFACES; i++) {
-		if (!nss_l2tpv2_session_debug_stats[i].valid) {
-			nss_l2tpv2_session_debug_stats[i].valid = true;
-			nss_l2tpv2_session_debug_stats[i].if_num = if_num;
-			nss_l2tpv2_session_debug_stats[i].if_index = netdev->ifindex;
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_l2tpv2_session_debug_stats_lock);
+	nss_session_stats_add(NSS_SESSION_STATS_TYPE_L2TPV2, if_num, netdev->ifindex);
 
 	return (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.l2tpv2_handler_id];
 }
@@ -251,7 +234,6 @@ struct nss_ctx_instance *nss_register_l2tpv2_if(uint32_t if_num, nss_l2tpv2_call
  */
 void nss_unregister_l2tpv2_if(uint32_t if_num)
 {
-	int i;
 	nss_assert(nss_is_dynamic_interface(if_num));
 
 	nss_top_main.subsys_dp_register[if_num].ndev = NULL;
@@ -263,14 +245,7 @@ void nss_unregister_l2tpv2_if(uint32_t if_num)
 
 	nss_core_unregister_handler(if_num);
 
-	spin_lock_bh(&nss_l2tpv2_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_L2TPV2_DYNAMIC_INTERFACES; i++) {
-		if (nss_l2tpv2_session_debug_stats[i].if_num == if_num) {
-			memset(&nss_l2tpv2_session_debug_stats[i], 0, sizeof(struct nss_stats_l2tpv2_session_debug));
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_l2tpv2_session_debug_stats_lock);
+	nss_session_stats_del(NSS_SESSION_STATS_TYPE_L2TPV2, if_num);
 }
 
 /*
@@ -31,10 +31,30 @@
 #include <linux/time.h>
 #include <linux/platform_device.h>
 #include <linux/device.h>
+#include <linux/poll.h>
+#include <linux/workqueue.h>
 #include <nss_hal.h>
 #include "nss_core.h"
 #include "nss_log.h"
 
+/*
+ * Debugfs files of the raw entries carry this flag next to the core id
+ */
+#define NSS_LOG_RAW_FLAG	0x100
+#define NSS_LOG_ID_MASK		0xff
+
+/*
+ * Interval of the current_entry check while someone polls
+ */
+#define NSS_LOG_POLL_INTERVAL	(HZ / 10)
+
+/*
+ * Size of the ring buffer memory; whole pages so that it can be mapped to userspace.
+ * The memory is DMA coherent, so the host and the NSS never need a sync.
+ */
+#define NSS_LOG_BUFFER_SIZE(nentries) \
+	PAGE_ALIGN(sizeof(struct nss_log_descriptor) + (sizeof(struct nss_log_entry) * (nentries)))
+
 /*
  * Private data for each device file open instance
  */
@@ -44,6 +64,7 @@ struct nss_log_data {
 	uint32_t last_entry;	/* Last known sampled entry (or index) */
 	uint32_t nentries;	/* Caches the total number of entries of log buffer */
 	int nss_id;		/* NSS Core id being used */
+	bool raw;		/* Read returns struct nss_log_entry records instead of text */
 };
 
 /*
@@ -67,6 +88,10 @@ static wait_queue_head_t msg_wq;
 enum nss_cmn_response msg_response;
 static bool msg_event;
 
+static wait_queue_head_t nss_log_poll_wq[NSS_MAX_CORES];
+static uint32_t nss_log_poll_entry[NSS_MAX_CORES];
+static struct delayed_work nss_log_poll_work;
+
 /*
  * nss_log_llseek()
  *	Seek operation.
@@ -105,7 +130,7 @@ static int nss_log_open(struct inode *inode, struct file *filp)
 	/*
 	 * i_private is passed to us by debug_fs_create()
 	 */
-	nss_id = (int)inode->i_private;
+	nss_id = (int)inode->i_private & NSS_LOG_ID_MASK;
 	if (nss_id < 0 || nss_id >= NSS_MAX_CORES) {
 		nss_warning("nss_id is not valid :%d\n", nss_id);
 		return -ENODEV;
@@ -142,12 +167,28 @@ static int nss_log_open(struct inode *inode, struct file *filp)
 	 */
 	nss_rbe[nss_id].refcnt++;
 	data->nss_id = nss_id;
+	data->raw = !!((int)inode->i_private & NSS_LOG_RAW_FLAG);
 	filp->private_data = data;
 	mutex_unlock(&nss_log_mutex);
 
 	return 0;
 }
 
+/*
+ * nss_log_put()
+ *	Drops a reference of the ring buffer of a core
+ */
+static void nss_log_put(int nss_id)
+{
+	mutex_lock(&nss_log_mutex);
+	nss_rbe[nss_id].refcnt--;
+	BUG_ON(nss_rbe[nss_id].refcnt < 0);
+	if (nss_rbe[nss_id].refcnt == 0) {
+		wake_up(&nss_log_wq);
+	}
+	mutex_unlock(&nss_log_mutex);
+}
+
 /*
  * nss_log_release()
  *	release gets called when close() is called on the file
@@ -161,13 +202,7 @@ static int nss_log_release(struct inode *inode, struct file *filp)
 		return -EINVAL;
 	}
 
-	mutex_lock(&nss_log_mutex);
-	nss_rbe[data->nss_id].refcnt--;
-	BUG_ON(nss_rbe[data->nss_id].refcnt < 0);
-	if (nss_rbe[data->nss_id].refcnt == 0) {
-		wake_up(&nss_log_wq);
-	}
-	mutex_unlock(&nss_log_mutex);
+	nss_log_put(data->nss_id);
 	kfree(data);
 	return 0;
 }
@@ -175,11 +210,132 @@ static int nss_log_release(struct inode *inode, struct file *filp)
 /*
  * nss_log_current_entry()
  *	Reads current entry index from NSS log descriptor.
+ *
+ * The read barrier after the load keeps the entries read next from being
+ * older than the index.
  */
 static uint32_t nss_log_current_entry(struct nss_log_descriptor *desc)
 {
+	uint32_t entry = ACCESS_ONCE(desc->current_entry);
+
 	rmb();
-	return desc->current_entry;
+	return entry;
+}
+
+/*
+ * nss_log_entry_get()
+ *	Returns the current entry index of the ring of this file.
+ */
+static uint32_t nss_log_entry_get(struct nss_log_data *data)
+{
+	return nss_log_current_entry(data->load_mem);
+}
+
+/*
+ * nss_log_catch_up()
+ *	Moves last_entry forward to the oldest entry still in the ring.
+ */
+static void nss_log_catch_up(struct nss_log_data *data, uint32_t entry, loff_t pos)
+{
+	/*
+	 * If this is the first read (after open) on our device file.
+	 */
+	if (unlikely(pos == 0)) {
+		/*
+		 * If log buffer has rolled over. Almost all the time
+		 * it will be true.
+		 */
+		if (likely(entry > data->nentries)) {
+			/*
+			 * Determine how much we can stuff in one
+			 * buffer passed to us and accordingly
+			 * reduce our index.
+			 */
+			data->last_entry = entry - data->nentries;
+		} else {
+			data->last_entry = 0;
+		}
+	} else if (unlikely(entry > data->nentries && ((entry - data->nentries) > data->last_entry))) {
+		/*
+		 * If FW is producing debug buffer at a pace faster than
+		 * we can consume, then we restrict our iteration.
+		 */
+		data->last_entry = entry - data->nentries;
+	}
+}
+
+/*
+ * nss_log_ring_entry()
+ *	Returns one ring entry.
+ */
+static struct nss_log_entry *nss_log_ring_entry(struct nss_log_data *data, uint32_t index)
+{
+	struct nss_log_descriptor *desc = data->load_mem;
+
+	return &desc->log_ring_buffer[index];
+}
+
+/*
+ * nss_log_read_raw()
+ *	Binary read: copies whole struct nss_log_entry records to userspace.
+ *
+ * Blocks until the NSS logs something new unless the file is non-blocking.
+ */
+static ssize_t nss_log_read_raw(struct file *filp, char __user *buf, size_t size, loff_t *ppos)
+{
+	struct nss_log_data *data = filp->private_data;
+	struct nss_log_entry *rb;
+	ssize_t bytes = 0;
+	uint32_t entry;
+	DEFINE_WAIT(wait);
+
+	if (size < sizeof(struct nss_log_entry)) {
+		return -EINVAL;
+	}
+
+	entry = nss_log_entry_get(data);
+	if (data->last_entry == entry) {
+		if (filp->f_flags & O_NONBLOCK) {
+			return -EAGAIN;
+		}
+
+		/*
+		 * Join the wait queue before kicking the poll work, so that the
+		 * work cannot find the queue empty and stop before we sleep.
+		 */
+		for (;;) {
+			prepare_to_wait(&nss_log_poll_wq[data->nss_id], &wait, TASK_INTERRUPTIBLE);
+			entry = nss_log_entry_get(data);
+			if (entry != data->last_entry) {
+				break;
+			}
+
+			if (signal_pending(current)) {
+				finish_wait(&nss_log_poll_wq[data->nss_id], &wait);
+				return -ERESTARTSYS;
+			}
+
+			schedule_delayed_work(&nss_log_poll_work, NSS_LOG_POLL_INTERVAL);
+			schedule();
+		}
+
+		finish_wait(&nss_log_poll_wq[data->nss_id], &wait);
+	}
+
+	nss_log_catch_up(data, entry, *ppos);
+
+	while ((entry > data->last_entry) && ((bytes + sizeof(struct nss_log_entry)) <= size)) {
+		rb = nss_log_ring_entry(data, data->last_entry % data->nentries);
+		if (copy_to_user(buf + bytes, rb, sizeof(struct nss_log_entry))) {
+			return bytes ? bytes : -EFAULT;
+		}
+
+		data->last_entry++;
+		bytes += sizeof(struct nss_log_entry);
+	}
+
+	*ppos += bytes;
+	return bytes;
 }
 
 /*
@@ -189,24 +345,25 @@ static uint32_t nss_log_current_entry(struct nss_log_descriptor *desc)
 static ssize_t nss_log_read(struct file *filp, char __user *buf, size_t size, loff_t *ppos)
 {
 	struct nss_log_data *data = filp->private_data;
-	struct nss_log_descriptor *desc;
 	size_t bytes = 0;
 	size_t b;
 	struct nss_log_entry *rb;
 	uint32_t entry;
-	uint32_t offset, index;
 	char msg[NSS_LOG_OUTPUT_LINE_SIZE];
 
 	if (!data) {
 		return -EINVAL;
 	}
 
-	desc = data->load_mem;
-	if (!desc) {
+	if (!data->load_mem) {
 		nss_warning("%p: load_mem is NULL", data);
 		return -EINVAL;
 	}
 
+	if (data->raw) {
+		return nss_log_read_raw(filp, buf, size, ppos);
+	}
+
 	/*
 	 * If buffer is too small to fit even one entry.
 	 */
@@ -217,8 +374,7 @@ static ssize_t nss_log_read(struct file *filp, char __user *buf, size_t size, lo
 	/*
 	 * Get the current index
 	 */
-	dma_sync_single_for_cpu(NULL, data->dma_addr, sizeof (struct nss_log_descriptor), DMA_FROM_DEVICE);
-	entry = nss_log_current_entry(desc);
+	entry = nss_log_entry_get(data);
 
 	/*
 	 * If the current and last sampled indexes are same then bail out.
@@ -227,43 +383,13 @@ static ssize_t nss_log_read(struct file *filp, char __user *buf, size_t size, lo
 		return 0;
 	}
 
-	/*
-	 * If this is the first read (after open) on our device file.
-	 */
-	if (unlikely(*ppos == 0)) {
-		/*
-		 * If log buffer has rolled over. Almost all the time
-		 * it will be true.
-		 */
-		if (likely(entry > data->nentries)) {
-			/*
-			 * Determine how much we can stuff in one
-			 * buffer passed to us and accordingly
-			 * reduce our index.
-			 */
-			data->last_entry = entry - data->nentries;
-		} else {
-			data->last_entry = 0;
-		}
-	} else if (unlikely(entry > data->nentries && ((entry - data->nentries) > data->last_entry))) {
-		/*
-		 * If FW is producing debug buffer at a pace faster than
-		 * we can consume, then we restrict our iteration.
-		 */
-		data->last_entry = entry - data->nentries;
-	}
+	nss_log_catch_up(data, entry, *ppos);
 
 	/*
 	 * Iterate over indexes.
 	 */
 	while (entry > data->last_entry) {
-		index = offset = (data->last_entry % data->nentries);
-		offset = (offset * sizeof (struct nss_log_entry))
-			 + offsetof(struct nss_log_descriptor, log_ring_buffer);
-
-		dma_sync_single_for_cpu(NULL, data->dma_addr + offset,
-			sizeof(struct nss_log_entry), DMA_FROM_DEVICE);
-		rb = &desc->log_ring_buffer[index];
+		rb = nss_log_ring_entry(data, data->last_entry % data->nentries);
 
 		b = snprintf(msg, sizeof(msg), NSS_LOG_LINE_FORMAT,
 			rb->thread_num, rb->timestamp, rb->message);
@@ -294,12 +420,146 @@ static ssize_t nss_log_read(struct file *filp, char __user *buf, size_t size, lo
 	return bytes;
 }
 
+/*
+ * nss_log_poll_work_fn()
+ *	Periodic check of current_entry on behalf of the pollers
+ *
+ * The NSS does not interrupt the host when it logs, so the descriptors are
+ * sampled every NSS_LOG_POLL_INTERVAL and the waiters of a core woken when
+ * it logged. The wakeup does not depend on waitqueue_active(): a reader
+ * joining the queue right now must see it. The work stops rescheduling
+ * itself once nobody waits; waiters join the queue before they schedule
+ * the work, which the barrier below pairs with.
+ */
+static void nss_log_poll_work_fn(struct work_struct *work)
+{
+	bool waiting = false;
+	uint32_t entry;
+	int i;
+
+	mutex_lock(&nss_log_mutex);
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		if (!nss_rbe[i].addr) {
+			continue;
+		}
+
+		entry = nss_log_current_entry(nss_rbe[i].addr);
+		if (entry != nss_log_poll_entry[i]) {
+			nss_log_poll_entry[i] = entry;
+			wake_up_interruptible(&nss_log_poll_wq[i]);
+		}
+	}
+	mutex_unlock(&nss_log_mutex);
+
+	smp_mb();
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		if (waitqueue_active(&nss_log_poll_wq[i])) {
+			waiting = true;
+		}
+	}
+
+	if (waiting) {
+		schedule_delayed_work(&nss_log_poll_work, NSS_LOG_POLL_INTERVAL);
+	}
+}
+
+/*
+ * nss_log_poll()
+ *	Readable once the NSS logged past what this file has read.
+ */
+static unsigned int nss_log_poll(struct file *filp, poll_table *wait)
+{
+	struct nss_log_data *data = filp->private_data;
+
+	if (!data || !data->load_mem) {
+		return POLLERR;
+	}
+
+	poll_wait(filp, &nss_log_poll_wq[data->nss_id], wait);
+
+	if (nss_log_entry_get(data) != data->last_entry) {
+		return POLLIN | POLLRDNORM;
+	}
+
+	schedule_delayed_work(&nss_log_poll_work, NSS_LOG_POLL_INTERVAL);
+	return 0;
+}
+
+/*
+ * nss_log_vma_open()
+ *	A copy of a mapping holds its own reference of the ring buffer
+ */
+static void nss_log_vma_open(struct vm_area_struct *vma)
+{
+	int nss_id = (int)vma->vm_private_data;
+
+	mutex_lock(&nss_log_mutex);
+	nss_rbe[nss_id].refcnt++;
+	mutex_unlock(&nss_log_mutex);
+}
+
+/*
+ * nss_log_vma_close()
+ *	Drops the reference of the ring buffer held by a mapping
+ */
+static void nss_log_vma_close(struct vm_area_struct *vma)
+{
+	nss_log_put((int)vma->vm_private_data);
+}
+
+static const struct vm_operations_struct nss_log_vm_ops = {
+	.open = nss_log_vma_open,
+	.close = nss_log_vma_close,
+};
+
+/*
+ * nss_log_mmap()
+ *	Maps the nss_log_descriptor and its ring read-only into userspace.
+ *
+ * The ring is DMA coherent memory and is mapped with the same attributes,
+ * so userspace reads current_entry and the entries as the NSS wrote them.
+ * Every mapping holds a reference of the ring buffer: it outlives the file,
+ * and nss_debug_log_buffer_alloc() does not replace the ring while mapped.
+ */
+static int nss_log_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct nss_log_data *data = filp->private_data;
+	unsigned long len = vma->vm_end - vma->vm_start;
+	int ret;
+
+	if (!data || !data->load_mem) {
+		return -EINVAL;
+	}
+
+	if (vma->vm_flags & VM_WRITE) {
+		return -EPERM;
+	}
+
+	if (vma->vm_pgoff || (len > NSS_LOG_BUFFER_SIZE(data->nentries))) {
+		return -EINVAL;
+	}
+
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	ret = dma_mmap_coherent(NULL, vma, data->load_mem, data->dma_addr, len);
+	if (ret) {
+		return ret;
+	}
+
+	vma->vm_ops = &nss_log_vm_ops;
+	vma->vm_private_data = (void *)data->nss_id;
+	nss_log_vma_open(vma);
+	return 0;
+}
+
 struct file_operations nss_logs_core_ops = {
 	.owner = THIS_MODULE,
 	.open = nss_log_open,
 	.read = nss_log_read,
 	.release = nss_log_release,
 	.llseek = nss_log_llseek,
+	.poll = nss_log_poll,
+	.mmap = nss_log_mmap,
 };
 
 /*
@@ -464,23 +724,19 @@ bool nss_debug_log_buffer_alloc(uint8_t nss_id, uint32_t nentry)
 
 	memset(&msg, 0, sizeof(struct nss_debug_interface_msg));
 
-	size = sizeof (struct nss_log_descriptor) + (sizeof (struct nss_log_entry) * nentry);
-	addr = kmalloc(size, GFP_ATOMIC);
+	size = NSS_LOG_BUFFER_SIZE(nentry);
+	addr = dma_alloc_coherent(NULL, size, &dma_addr, GFP_KERNEL);
 	if (!addr) {
 		nss_warning("%p: Failed to allocate memory for logging (size:%d)\n", nss_ctx, size);
 		return false;
 	}
 
 	memset(addr, 0, size);
-	dma_addr = (uint32_t)dma_map_single(NULL, addr, size, DMA_FROM_DEVICE);
-	if (unlikely(dma_mapping_error(NULL, dma_addr))) {
-		nss_warning("%p: Failed to map address in DMA", nss_ctx);
-		goto fail2;
-	}
 
 	/*
 	 * If we already have ring buffer associated with nss_id, then
-	 * we must wait before we attach a new ring buffer.
+	 * we must wait before we attach a new ring buffer. Open files
+	 * and userspace mappings of the old ring hold references.
 	 */
 	mutex_lock(&nss_log_mutex);
 	if (nss_rbe[nss_id].addr) {
@@ -551,15 +807,10 @@ bool nss_debug_log_buffer_alloc(uint8_t nss_id, uint32_t nentry)
 	 */
 	if (old_state == true) {
 		/*
-		 * If we didn't fail, then we must unmap and free previous dma buffer
+		 * If we didn't fail, then we must free previous dma buffer
 		 */
 		if (err == false) {
-			uint32_t old_size;
-
-			old_size = sizeof (struct nss_log_descriptor) +
-				(sizeof (struct nss_log_entry) * old_rbe.nentries);
-			dma_unmap_single(NULL, old_rbe.dma_addr, old_size, DMA_FROM_DEVICE);
-			kfree(old_rbe.addr);
+			dma_free_coherent(NULL, NSS_LOG_BUFFER_SIZE(old_rbe.nentries), old_rbe.addr, old_rbe.dma_addr);
 		} else {
 			/*
 			 * Restore the original dma buffer since we failed somewhere.
@@ -598,11 +849,7 @@ bool nss_debug_log_buffer_alloc(uint8_t nss_id, uint32_t nentry)
 	}
 
 fail1:
-	if (addr) {
-		dma_unmap_single(NULL, dma_addr, size, DMA_FROM_DEVICE);
-	}
-fail2:
-	kfree(addr);
+	dma_free_coherent(NULL, size, addr, dma_addr);
 	wake_up(&nss_log_wq);
 	return false;
 }
@@ -652,6 +899,10 @@ void nss_log_init(void)
 	memset(nss_rbe, 0, sizeof(nss_rbe));
 	init_waitqueue_head(&nss_log_wq);
 	init_waitqueue_head(&msg_wq);
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		init_waitqueue_head(&nss_log_poll_wq[i]);
+	}
+	INIT_DELAYED_WORK(&nss_log_poll_work, nss_log_poll_work_fn);
 
 	/*
 	 * Create directory for obtaining NSS FW logs from each core
@@ -673,6 +924,16 @@ void nss_log_init(void)
 			nss_warning("Failed to create qca-nss-drv/logs/%s file in debugfs", file);
 			return;
 		}
+
+		/*
+		 * Same ring, read as raw struct nss_log_entry records
+		 */
+		snprintf(file, sizeof(file), "core%d.bin", i);
+		if (unlikely(!debugfs_create_file(file, 0400, nss_top_main.logs_dentry,
+						(void *)(i | NSS_LOG_RAW_FLAG), &nss_logs_core_ops))) {
+			nss_warning("Failed to create qca-nss-drv/logs/%s file in debugfs", file);
+			return;
+		}
 	}
 
 	nss_debug_interface_set_callback(nss_debug_interface_event, NULL);
@@ -681,3 +942,12 @@ void nss_log_init(void)
 		nss_warning("NSS logbuffer init failed with register handler:%d\n", core_status);
 	}
 }
+
+/*
+ * nss_log_exit()
+ *	Stops the poll work; the debugfs files go with the stats tree
+ */
+void nss_log_exit(void)
+{
+	cancel_delayed_work_sync(&nss_log_poll_work);
+}
@@ -34,11 +34,11 @@ static void nss_rx_lso_rx_stats_sync(struct nss_ctx_instance *nss_ctx, struct ns
 	/*
 	 * common node stats
 	 */
-	nss_top->stats_node[NSS_LSO_RX_INTERFACE][NSS_STATS_NODE_RX_PKTS] += nlrss->node_stats.rx_packets;
-	nss_top->stats_node[NSS_LSO_RX_INTERFACE][NSS_STATS_NODE_RX_BYTES] += nlrss->node_stats.rx_bytes;
-	nss_top->stats_node[NSS_LSO_RX_INTERFACE][NSS_STATS_NODE_RX_DROPPED] += nlrss->node_stats.rx_dropped;
-	nss_top->stats_node[NSS_LSO_RX_INTERFACE][NSS_STATS_NODE_TX_PKTS] += nlrss->node_stats.tx_packets;
-	nss_top->stats_node[NSS_LSO_RX_INTERFACE][NSS_STATS_NODE_TX_BYTES] += nlrss->node_stats.tx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_LSO_RX_INTERFACE)][NSS_STATS_NODE_RX_PKTS] += nlrss->node_stats.rx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_LSO_RX_INTERFACE)][NSS_STATS_NODE_RX_BYTES] += nlrss->node_stats.rx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_LSO_RX_INTERFACE)][NSS_STATS_NODE_RX_DROPPED] += nlrss->node_stats.rx_dropped;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_LSO_RX_INTERFACE)][NSS_STATS_NODE_TX_PKTS] += nlrss->node_stats.tx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_LSO_RX_INTERFACE)][NSS_STATS_NODE_TX_BYTES] += nlrss->node_stats.tx_bytes;
 
 	/*
 	 * General LSO_RX stats
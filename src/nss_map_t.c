@@ -29,12 +29,6 @@ static struct {
 	void *app_data;
 } nss_map_t_pvt;
 
-/*
- * Data structures to store map_t nss debug stats
- */
-static DEFINE_SPINLOCK(nss_map_t_debug_stats_lock);
-static struct nss_stats_map_t_instance_debug nss_map_t_debug_stats[NSS_MAX_MAP_T_DYNAMIC_INTERFACES];
-
 /*
  * nss_map_t_verify_if_num()
  *	Verify if_num passed to us.
@@ -59,28 +53,28 @@ static bool nss_map_t_verify_if_num(uint32_t if_num)
  */
 void nss_map_t_instance_debug_stats_sync(struct nss_ctx_instance *nss_ctx, struct nss_map_t_sync_stats_msg *stats_msg, uint16_t if_num)
 {
-	int i;
-	spin_lock_bh(&nss_map_t_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_MAP_T_DYNAMIC_INTERFACES; i++) {
-		if (nss_map_t_debug_stats[i].if_num == if_num) {
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_PBUF_EXCEPTION] += stats_msg->debug_stats.v4_to_v6.exception_pkts;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_PBUF_NO_MATCHING_RULE] += stats_msg->debug_stats.v4_to_v6.no_matching_rule;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_PBUF_NOT_TCP_OR_UDP] += stats_msg->debug_stats.v4_to_v6.not_tcp_or_udp;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_LOCAL_PSID_MISMATCH] += stats_msg->debug_stats.v4_to_v6.rule_err_local_psid_mismatch;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_LOCAL_IPV6] += stats_msg->debug_stats.v4_to_v6.rule_err_local_ipv6;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_REMOTE_PSID] += stats_msg->debug_stats.v4_to_v6.rule_err_remote_psid;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_REMOTE_EA_BITS] += stats_msg->debug_stats.v4_to_v6.rule_err_remote_ea_bits;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_REMOTE_IPV6] += stats_msg->debug_stats.v4_to_v6.rule_err_remote_ipv6;
-
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V6_TO_V4_PBUF_EXCEPTION] += stats_msg->debug_stats.v6_to_v4.exception_pkts;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V6_TO_V4_PBUF_NO_MATCHING_RULE] += stats_msg->debug_stats.v6_to_v4.no_matching_rule;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V6_TO_V4_PBUF_NOT_TCP_OR_UDP] += stats_msg->debug_stats.v6_to_v4.not_tcp_or_udp;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V6_TO_V4_RULE_ERR_LOCAL_IPV4] += stats_msg->debug_stats.v6_to_v4.rule_err_local_ipv4;
-			nss_map_t_debug_stats[i].stats[NSS_STATS_MAP_T_V6_TO_V4_RULE_ERR_REMOTE_IPV4] += stats_msg->debug_stats.v6_to_v4.rule_err_remote_ipv4;
-			break;
-		}
+	uint64_t *stats;
+
+	stats = nss_session_stats_update_begin(NSS_SESSION_STATS_TYPE_MAP_T, if_num);
+	if (!stats) {
+		return;
 	}
-	spin_unlock_bh(&nss_map_t_debug_stats_lock);
+
+	stats[NSS_STATS_MAP_T_V4_TO_V6_PBUF_EXCEPTION] += stats_msg->debug_stats.v4_to_v6.exception_pkts;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_PBUF_NO_MATCHING_RULE] += stats_msg->debug_stats.v4_to_v6.no_matching_rule;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_PBUF_NOT_TCP_OR_UDP] += stats_msg->debug_stats.v4_to_v6.not_tcp_or_udp;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_LOCAL_PSID_MISMATCH] += stats_msg->debug_stats.v4_to_v6.rule_err_local_psid_mismatch;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_LOCAL_IPV6] += stats_msg->debug_stats.v4_to_v6.rule_err_local_ipv6;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_REMOTE_PSID] += stats_msg->debug_stats.v4_to_v6.rule_err_remote_psid;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_REMOTE_EA_BITS] += stats_msg->debug_stats.v4_to_v6.rule_err_remote_ea_bits;
+	stats[NSS_STATS_MAP_T_V4_TO_V6_RULE_ERR_REMOTE_IPV6] += stats_msg->debug_stats.v4_to_v6.rule_err_remote_ipv6;
+
+	stats[NSS_STATS_MAP_T_V6_TO_V4_PBUF_EXCEPTION] += stats_msg->debug_stats.v6_to_v4.exception_pkts;
+	stats[NSS_STATS_MAP_T_V6_TO_V4_PBUF_NO_MATCHING_RULE] += stats_msg->debug_stats.v6_to_v4.no_matching_rule;
+	stats[NSS_STATS_MAP_T_V6_TO_V4_PBUF_NOT_TCP_OR_UDP] += stats_msg->debug_stats.v6_to_v4.not_tcp_or_udp;
+	stats[NSS_STATS_MAP_T_V6_TO_V4_RULE_ERR_LOCAL_IPV4] += stats_msg->debug_stats.v6_to_v4.rule_err_local_ipv4;
+	stats[NSS_STATS_MAP_T_V6_TO_V4_RULE_ERR_REMOTE_IPV4] += stats_msg->debug_stats.v6_to_v4.rule_err_remote_ipv4;
+	nss_session_stats_update_end(stats);
 }
 
 /*
@@ -90,21 +84,21 @@ void nss_map_t_instance_debug_stats_sync(struct nss_ctx_instance *nss_ctx, struc
 void nss_map_t_instance_debug_stats_get(void *stats_mem)
 {
 	struct nss_stats_map_t_instance_debug *stats = (struct nss_stats_map_t_instance_debug *)stats_mem;
-	int i;
+	int i, n = 0;
 
 	if (!stats) {
 		nss_warning("No memory to copy map_t stats");
 		return;
 	}
 
-	spin_lock_bh(&nss_map_t_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_MAP_T_DYNAMIC_INTERFACES; i++) {
-		if (nss_map_t_debug_stats[i].valid) {
-			memcpy(stats, &nss_map_t_debug_stats[i], sizeof(struct nss_stats_map_t_instance_debug));
+	for (i = 0; (i < NSS_MAX_DYNAMIC_INTERFACES) && (n < NSS_MAX_MAP_T_DYNAMIC_INTERFACES); i++) {
+		if (nss_session_stats_read(NSS_SESSION_STATS_TYPE_MAP_T, NSS_DYNAMIC_IF_START + i, &stats->if_index, stats->stats)) {
+			stats->if_num = NSS_DYNAMIC_IF_START + i;
+			stats->valid = true;
 			stats++;
+			n++;
 		}
 	}
-	spin_unlock_bh(&nss_map_t_debug_stats_lock);
 }
 
 /*
@@ -314,7 +308,6 @@ EXPORT_SYMBOL(nss_map_t_tx_sync);
 struct nss_ctx_instance *nss_map_t_register_if(uint32_t if_num, nss_map_t_callback_t map_t_callback,
 			nss_map_t_msg_callback_t event_callback, struct net_device *netdev, uint32_t features)
 {
-	int i = 0;
 	nss_assert(nss_is_dynamic_interface(if_num));
 
 	nss_top_main.subsys_dp_register[if_num].ndev = netdev;
@@ -326,16 +319,7 @@ struct nss_ctx_instance *nss_map_t_register_if(uint32_t if_num, nss_map_t_callba
 
 	nss_core_register_handler(if_num, nss_map_t_handler, NULL);
 
-	spin_lock_bh(&nss_map_t_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_MAP_T_DYNAMIC_INTERFACES; i++) {
-		if (!nss_map_t_debug_stats[i].valid) {
-			nss_map_t_debug_stats[i].valid = true;
-			nss_map_t_debug_stats[i].if_num = if_num;
-			nss_map_t_debug_stats[i].if_index = netdev->ifindex;
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_map_t_debug_stats_lock);
+	nss_session_stats_add(NSS_SESSION_STATS_TYPE_MAP_T, if_num, netdev->ifindex);
 
 	return (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.map_t_handler_id];
 }
@@ -346,7 +330,6 @@ EXPORT_SYMBOL(nss_map_t_register_if);
  */
 void nss_map_t_unregister_if(uint32_t if_num)
 {
-	int i;
 	nss_assert(nss_is_dynamic_interface(if_num));
 
 	nss_top_main.subsys_dp_register[if_num].ndev = NULL;
@@ -358,14 +341,7 @@ void nss_map_t_unregister_if(uint32_t if_num)
 
 	nss_core_unregister_handler(if_num);
 
-	spin_lock_bh(&nss_map_t_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_MAP_T_DYNAMIC_INTERFACES; i++) {
-		if (nss_map_t_debug_stats[i].if_num == if_num) {
-			memset(&nss_map_t_debug_stats[i], 0, sizeof(struct nss_stats_map_t_instance_debug));
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_map_t_debug_stats_lock);
+	nss_session_stats_del(NSS_SESSION_STATS_TYPE_MAP_T, if_num);
 }
 EXPORT_SYMBOL(nss_map_t_unregister_if);
 
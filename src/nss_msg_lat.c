@@ -0,0 +1,377 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_msg_lat.c
+ *	NSS control message round trip latency
+ *
+ * Every control message queued to the NSS is timestamped in a small
+ * pending table keyed on (core, interface, type, cb, app_data). The
+ * firmware echoes these fields in its response, which is matched in
+ * nss_core_handle_nss_status_pkt() to the oldest pending request. The
+ * round trip is accounted in a per (interface, message type) record
+ * holding a log2 microsecond histogram and the worst case.
+ *
+ * Off by default; enabled with /proc/sys/dev/nss/general/msg_latency.
+ * Read through qca-nss-drv/stats/msg_latency; any write clears it.
+ */
+#include <linux/sysctl.h>
+#include <linux/jhash.h>
+#include "nss_tx_rx_common.h"
+
+#define NSS_MSG_LAT_PENDING_SIZE	256	/* Outstanding requests tracked */
+#define NSS_MSG_LAT_PENDING_MASK	(NSS_MSG_LAT_PENDING_SIZE - 1)
+#define NSS_MSG_LAT_RECORDS		256	/* (interface, type) pairs tracked */
+#define NSS_MSG_LAT_RECORDS_MASK	(NSS_MSG_LAT_RECORDS - 1)
+#define NSS_MSG_LAT_PROBE		8	/* Linear probe length of both tables */
+#define NSS_MSG_LAT_BUCKETS		24	/* Bucket n counts latencies below 2^n us */
+
+/*
+ * nss_msg_lat_pending
+ *	A request waiting for its response
+ */
+struct nss_msg_lat_pending {
+	uint64_t sent_ns;		/* Time the request was queued */
+	uint32_t type;			/* Message type */
+	uint32_t cb;			/* Callback echoed by the firmware */
+	uint32_t app_data;		/* App data echoed by the firmware */
+	uint16_t interface;		/* NSS interface number */
+	uint8_t core;			/* NSS core the request went to */
+	uint8_t valid;			/* Slot in use */
+};
+
+/*
+ * nss_msg_lat_record
+ *	Latency of one message type on one interface
+ */
+struct nss_msg_lat_record {
+	uint32_t type;				/* Message type */
+	uint16_t interface;			/* NSS interface number */
+	uint16_t valid;				/* Slot in use */
+	uint64_t count;				/* Responses matched */
+	uint64_t nacks;				/* Responses other than ACK */
+	uint64_t sum_us;			/* Sum of round trips */
+	uint32_t max_us;			/* Worst round trip */
+	uint32_t hist[NSS_MSG_LAT_BUCKETS];	/* log2(us) histogram */
+};
+
+/*
+ * nss_msg_lat_table
+ *	Pending requests and latency records
+ */
+struct nss_msg_lat_table {
+	spinlock_t lock;						/* Protects the table */
+	struct nss_msg_lat_pending pending[NSS_MSG_LAT_PENDING_SIZE];	/* Outstanding requests */
+	struct nss_msg_lat_record records[NSS_MSG_LAT_RECORDS];	/* Latency records */
+	uint64_t evicted;						/* Requests dropped before their response */
+	uint64_t unmatched;						/* Responses with no pending request */
+	uint64_t no_record;						/* Responses dropped because records were full */
+};
+
+static struct nss_msg_lat_table nss_msg_lat;
+static struct dentry *nss_msg_lat_dentry;
+
+int nss_msg_lat_enable __read_mostly = 0;
+
+/*
+ * nss_msg_lat_hash()
+ *	Hash of the fields the firmware echoes in a response
+ */
+static inline uint32_t nss_msg_lat_hash(uint32_t core, struct nss_cmn_msg *ncm)
+{
+	return jhash_3words(ncm->interface | (core << 16), ncm->type, ncm->cb ^ ncm->app_data, 0);
+}
+
+/*
+ * nss_msg_lat_tx()
+ *	Timestamp a control message queued to the NSS
+ */
+void nss_msg_lat_tx(struct nss_ctx_instance *nss_ctx, struct nss_cmn_msg *ncm)
+{
+	struct nss_msg_lat_pending *p, *victim = NULL;
+	uint32_t hash = nss_msg_lat_hash(nss_ctx->id, ncm);
+	uint64_t now = ktime_to_ns(ktime_get());
+	int i;
+
+	spin_lock_bh(&nss_msg_lat.lock);
+	for (i = 0; i < NSS_MSG_LAT_PROBE; i++) {
+		p = &nss_msg_lat.pending[(hash + i) & NSS_MSG_LAT_PENDING_MASK];
+		if (!p->valid) {
+			victim = p;
+			break;
+		}
+
+		if (!victim || p->sent_ns < victim->sent_ns) {
+			victim = p;
+		}
+	}
+
+	/*
+	 * No free slot; the oldest request most likely never got a response.
+	 */
+	if (victim->valid) {
+		nss_msg_lat.evicted++;
+	}
+
+	victim->sent_ns = now;
+	victim->type = ncm->type;
+	victim->cb = ncm->cb;
+	victim->app_data = ncm->app_data;
+	victim->interface = ncm->interface;
+	victim->core = nss_ctx->id;
+	victim->valid = 1;
+	spin_unlock_bh(&nss_msg_lat.lock);
+}
+
+/*
+ * nss_msg_lat_record_get()
+ *	Find or allocate the record of an (interface, type) pair, lock held
+ */
+static struct nss_msg_lat_record *nss_msg_lat_record_get(uint16_t interface, uint32_t type)
+{
+	struct nss_msg_lat_record *r;
+	uint32_t hash = jhash_2words(interface, type, 0);
+	int i;
+
+	for (i = 0; i < NSS_MSG_LAT_PROBE; i++) {
+		r = &nss_msg_lat.records[(hash + i) & NSS_MSG_LAT_RECORDS_MASK];
+		if (!r->valid) {
+			r->interface = interface;
+			r->type = type;
+			r->valid = 1;
+			return r;
+		}
+
+		if (r->interface == interface && r->type == type) {
+			return r;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * nss_msg_lat_rx()
+ *	Match a response from the NSS to its request
+ */
+void nss_msg_lat_rx(struct nss_ctx_instance *nss_ctx, struct nss_cmn_msg *ncm)
+{
+	struct nss_msg_lat_pending *p, *match = NULL;
+	struct nss_msg_lat_record *r;
+	uint32_t hash, lat_us;
+	uint64_t now;
+	int i, bucket;
+
+	/*
+	 * Notifications are not responses to a request
+	 */
+	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
+		return;
+	}
+
+	hash = nss_msg_lat_hash(nss_ctx->id, ncm);
+	now = ktime_to_ns(ktime_get());
+
+	spin_lock_bh(&nss_msg_lat.lock);
+	for (i = 0; i < NSS_MSG_LAT_PROBE; i++) {
+		p = &nss_msg_lat.pending[(hash + i) & NSS_MSG_LAT_PENDING_MASK];
+		if (!p->valid || p->core != nss_ctx->id || p->interface != ncm->interface
+				|| p->type != ncm->type || p->cb != ncm->cb || p->app_data != ncm->app_data) {
+			continue;
+		}
+
+		if (!match || p->sent_ns < match->sent_ns) {
+			match = p;
+		}
+	}
+
+	if (!match) {
+		nss_msg_lat.unmatched++;
+		spin_unlock_bh(&nss_msg_lat.lock);
+		return;
+	}
+
+	match->valid = 0;
+	lat_us = (uint32_t)div_u64(now - match->sent_ns, NSEC_PER_USEC);
+
+	r = nss_msg_lat_record_get(ncm->interface, ncm->type);
+	if (!r) {
+		nss_msg_lat.no_record++;
+		spin_unlock_bh(&nss_msg_lat.lock);
+		return;
+	}
+
+	bucket = fls(lat_us);
+	if (bucket >= NSS_MSG_LAT_BUCKETS) {
+		bucket = NSS_MSG_LAT_BUCKETS - 1;
+	}
+
+	r->count++;
+	r->sum_us += lat_us;
+	r->hist[bucket]++;
+	if (lat_us > r->max_us) {
+		r->max_us = lat_us;
+	}
+
+	if (ncm->response != NSS_CMN_RESPONSE_ACK) {
+		r->nacks++;
+	}
+	spin_unlock_bh(&nss_msg_lat.lock);
+}
+
+/*
+ * nss_msg_lat_read()
+ *	Print the latency records
+ */
+static ssize_t nss_msg_lat_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_msg_lat_record *records;
+	uint64_t evicted, unmatched, no_record;
+	uint32_t pending = 0;
+	size_t size_al = NSS_MSG_LAT_RECORDS * (160 + NSS_MSG_LAT_BUCKETS * 24) + 256;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	char *lbuf;
+	int i, j;
+
+	records = vzalloc(sizeof(nss_msg_lat.records));
+	if (unlikely(records == NULL)) {
+		nss_warning("Could not allocate memory for message latency records");
+		return 0;
+	}
+
+	lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		vfree(records);
+		return 0;
+	}
+
+	spin_lock_bh(&nss_msg_lat.lock);
+	memcpy(records, nss_msg_lat.records, sizeof(nss_msg_lat.records));
+	for (i = 0; i < NSS_MSG_LAT_PENDING_SIZE; i++) {
+		pending += nss_msg_lat.pending[i].valid;
+	}
+
+	evicted = nss_msg_lat.evicted;
+	unmatched = nss_msg_lat.unmatched;
+	no_record = nss_msg_lat.no_record;
+	spin_unlock_bh(&nss_msg_lat.lock);
+
+	size_wr = scnprintf(lbuf, size_al, "msg latency: %s, pending = %u, evicted = %llu, unmatched = %llu, no_record = %llu\n",
+				nss_msg_lat_enable ? "enabled" : "disabled", pending, evicted, unmatched, no_record);
+
+	for (i = 0; i < NSS_MSG_LAT_RECORDS; i++) {
+		struct nss_msg_lat_record *r = &records[i];
+
+		if (!r->valid || !r->count) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"if %u type %u: count = %llu, nacks = %llu, avg_us = %llu, max_us = %u\n\t",
+				r->interface, r->type, r->count, r->nacks, div64_u64(r->sum_us, r->count), r->max_us);
+
+		for (j = 0; j < NSS_MSG_LAT_BUCKETS; j++) {
+			if (!r->hist[j]) {
+				continue;
+			}
+
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "<%uus:%u ", 1U << j, r->hist[j]);
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+	}
+
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
+	vfree(records);
+
+	return bytes_read;
+}
+
+/*
+ * nss_msg_lat_enable_handler()
+ *	Enable/disable the tracking
+ *
+ * Requests queued while disabled were never timestamped, so pending slots
+ * left from an earlier enabled period are dropped when it is enabled again.
+ */
+int nss_msg_lat_enable_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	int enable = nss_msg_lat_enable;
+	int ret;
+
+	ret = proc_dointvec(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		return ret;
+	}
+
+	if (nss_msg_lat_enable && !enable) {
+		spin_lock_bh(&nss_msg_lat.lock);
+		memset(nss_msg_lat.pending, 0, sizeof(nss_msg_lat.pending));
+		spin_unlock_bh(&nss_msg_lat.lock);
+	}
+
+	return 0;
+}
+
+/*
+ * nss_msg_lat_write()
+ *	Clear the latency records; outstanding requests are kept
+ */
+static ssize_t nss_msg_lat_write(struct file *fp, const char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	spin_lock_bh(&nss_msg_lat.lock);
+	memset(nss_msg_lat.records, 0, sizeof(nss_msg_lat.records));
+	nss_msg_lat.evicted = 0;
+	nss_msg_lat.unmatched = 0;
+	nss_msg_lat.no_record = 0;
+	spin_unlock_bh(&nss_msg_lat.lock);
+
+	return sz;
+}
+
+static const struct file_operations nss_msg_lat_ops = {
+	.read = nss_msg_lat_read,
+	.write = nss_msg_lat_write,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_msg_lat_init()
+ *	Initialize the latency tables and debugfs entry
+ */
+void nss_msg_lat_init(void)
+{
+	spin_lock_init(&nss_msg_lat.lock);
+
+	nss_msg_lat_dentry = debugfs_create_file("msg_latency", 0600, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_msg_lat_ops);
+	if (unlikely(nss_msg_lat_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/msg_latency file in debugfs");
+	}
+}
+
+/*
+ * nss_msg_lat_exit()
+ *	Remove the debugfs entry
+ */
+void nss_msg_lat_exit(void)
+{
+	debugfs_remove(nss_msg_lat_dentry);
+	nss_msg_lat_dentry = NULL;
+}
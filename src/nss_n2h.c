@@ -157,6 +157,7 @@ static void nss_n2h_interface_handler(struct nss_ctx_instance *nss_ctx,
 
 	case NSS_RX_METADATA_TYPE_N2H_STATS_SYNC:
 		nss_n2h_stats_sync(nss_ctx, &nnm->msg.stats_sync);
+		nss_stats_genl_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_N2H, nss_ctx->id);
 		break;
 
 	default:
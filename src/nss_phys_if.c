@@ -182,6 +182,7 @@ static void nss_phys_if_msg_handler(struct nss_ctx_instance *nss_ctx, struct nss
 		 * To create the old API gmac statistics, we use the new extended GMAC stats.
 		 */
 		nss_phys_if_update_driver_stats(nss_ctx, ncm->interface, &nim->msg.stats);
+		nss_stats_genl_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_GMAC, ncm->interface);
 		nss_phys_if_gmac_stats_sync(nss_ctx, &nim->msg.stats, ncm->interface);
 		break;
 	}
@@ -0,0 +1,622 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_pkt_lat.c
+ *	NSS data path latency telemetry
+ *
+ * Optional per-interface log2 nanosecond histograms of where a packet
+ * spends its time:
+ *
+ * h2n: queued on an H2N ring by nss_core_send_buffer() until the NSS
+ *	consumed the descriptor. Consumption is seen when the ring is next
+ *	used, so under light load this is an upper bound.
+ * nss: sent for a shaper bounce until the NSS queued it back on an N2H
+ *	ring (firmware timestamp). Includes the H2N ring wait.
+ * n2h: queued on an N2H ring by the NSS (firmware timestamp) until
+ *	nss_core_rx_pbuf() picked it up; bounced, virtual and exception
+ *	packets.
+ *
+ * The NSS clock is not synchronised with the host. Each core's offset is
+ * taken as the smallest (host - firmware) difference seen, so the nss and
+ * n2h figures are relative to the fastest N2H transfer observed. Clearing
+ * the statistics also restarts the offset estimate.
+ *
+ * Samples are recorded per NSS core, each core under its own lock, and
+ * merged per interface when read. The histograms are only allocated while
+ * the telemetry is enabled.
+ *
+ * Enabled with /proc/sys/dev/nss/pkt_lat/enable, read through
+ * qca-nss-drv/stats/pkt_latency; any write clears it.
+ */
+#include <linux/sysctl.h>
+#include "nss_tx_rx_common.h"
+
+#define NSS_PKT_LAT_BUCKETS	28	/* Bucket n counts latencies below 2^n ns */
+
+/*
+ * Send time of a bounced packet, in the last bytes of skb->cb while the
+ * packet is in the NSS. Send times older than NSS_PKT_LAT_HOST_TS_MAX_NS
+ * are taken as left over from a bounce sent with the telemetry off.
+ */
+#define NSS_PKT_LAT_CB(skb)		((uint64_t *)&(skb)->cb[sizeof((skb)->cb) - sizeof(uint64_t)])
+#define NSS_PKT_LAT_HOST_TS_MAX_NS	(10ULL * NSEC_PER_SEC)
+
+/*
+ * nss_pkt_lat_dir
+ *	Latency components
+ */
+enum nss_pkt_lat_dir {
+	NSS_PKT_LAT_DIR_H2N,		/* Waiting on the H2N ring */
+	NSS_PKT_LAT_DIR_NSS,		/* Host send to NSS return of a bounced packet */
+	NSS_PKT_LAT_DIR_N2H,		/* Waiting on the N2H ring */
+	NSS_PKT_LAT_DIR_MAX
+};
+
+static const char *nss_pkt_lat_dir_str[NSS_PKT_LAT_DIR_MAX] = {
+	"h2n",
+	"nss",
+	"n2h",
+};
+
+/*
+ * nss_pkt_lat_slot
+ *	Send time of the packet in one H2N descriptor
+ */
+struct nss_pkt_lat_slot {
+	uint64_t sent_ns;		/* Time the descriptor was queued, 0 if none */
+	uint32_t if_num;		/* Interface the packet was sent to */
+};
+
+/*
+ * nss_pkt_lat_hist
+ *	Latency distribution of one component
+ */
+struct nss_pkt_lat_hist {
+	uint64_t count;				/* Samples */
+	uint64_t sum_ns;			/* Sum of the samples */
+	uint64_t max_ns;			/* Worst sample */
+	uint32_t hist[NSS_PKT_LAT_BUCKETS];	/* log2(ns) histogram */
+};
+
+#define NSS_PKT_LAT_RECORDS_SIZE	(NSS_MAX_NET_INTERFACES * NSS_PKT_LAT_DIR_MAX * sizeof(struct nss_pkt_lat_hist))
+
+/*
+ * nss_pkt_lat_core
+ *	Per-interface histograms and clock offset of one NSS core
+ *
+ * The histograms are only allocated while the telemetry is enabled. The
+ * pointer is set and cleared under the core lock, which every sample is
+ * accounted under, so a sample either sees the histograms or none.
+ */
+struct nss_pkt_lat_core {
+	spinlock_t lock;							/* Protects this core's records */
+	struct nss_pkt_lat_hist (*records)[NSS_PKT_LAT_DIR_MAX];		/* Histograms per interface, NULL while disabled */
+	int64_t offset_ns;							/* Smallest host - firmware time seen */
+	bool offset_valid;							/* offset_ns holds a sample */
+	uint64_t no_fw_ts;							/* Return packets without firmware timestamp */
+	uint64_t no_host_ts;							/* Bounced packets without send time */
+};
+
+int nss_pkt_lat_enable __read_mostly = 0;
+
+static struct nss_pkt_lat_core nss_pkt_lat[NSS_MAX_CORES];
+static struct dentry *nss_pkt_lat_dentry;
+static DEFINE_MUTEX(nss_pkt_lat_ctl_lock);	/* Serializes enable and disable */
+
+/*
+ * nss_pkt_lat_record()
+ *	Account one sample, core lock held
+ */
+static inline void nss_pkt_lat_record(struct nss_pkt_lat_core *npc, uint32_t if_num, enum nss_pkt_lat_dir dir, uint64_t lat_ns)
+{
+	struct nss_pkt_lat_hist *h;
+	int bucket;
+
+	if (unlikely(!npc->records || (if_num >= NSS_MAX_NET_INTERFACES))) {
+		return;
+	}
+
+	h = &npc->records[if_num][dir];
+	bucket = fls64(lat_ns);
+	if (bucket >= NSS_PKT_LAT_BUCKETS) {
+		bucket = NSS_PKT_LAT_BUCKETS - 1;
+	}
+
+	h->count++;
+	h->sum_ns += lat_ns;
+	h->hist[bucket]++;
+	if (lat_ns > h->max_ns) {
+		h->max_ns = lat_ns;
+	}
+}
+
+/*
+ * nss_pkt_lat_h2n_queued()
+ *	Timestamp a packet placed on an H2N ring, ring lock held
+ *
+ * index is the first descriptor of the packet.
+ */
+void nss_pkt_lat_h2n_queued(struct hlos_h2n_desc_rings *h2n_desc_ring, uint32_t if_num, uint32_t index,
+				struct sk_buff *nbuf, bool is_bounce)
+{
+	uint64_t now = ktime_to_ns(ktime_get());
+
+	if (likely(h2n_desc_ring->lat_slots)) {
+		h2n_desc_ring->lat_slots[index].sent_ns = now;
+		h2n_desc_ring->lat_slots[index].if_num = if_num;
+	}
+
+	/*
+	 * Bounced packets come back to us; carry the send time in the skb
+	 */
+	if (is_bounce) {
+		*NSS_PKT_LAT_CB(nbuf) = now;
+	}
+}
+
+/*
+ * nss_pkt_lat_h2n_retire()
+ *	Account the descriptors the NSS consumed since the last call, ring lock held
+ */
+void nss_pkt_lat_h2n_retire(struct nss_ctx_instance *nss_ctx, struct hlos_h2n_desc_rings *h2n_desc_ring, uint32_t nss_index)
+{
+	struct nss_pkt_lat_core *npc = &nss_pkt_lat[nss_ctx->id];
+	struct nss_pkt_lat_slot *slots = h2n_desc_ring->lat_slots;
+	uint32_t mask = h2n_desc_ring->desc_ring.size - 1;
+	uint32_t i = h2n_desc_ring->lat_nss_index;
+	uint64_t now;
+
+	if (unlikely(!slots) || (i == nss_index)) {
+		return;
+	}
+
+	now = ktime_to_ns(ktime_get());
+
+	spin_lock(&npc->lock);
+	for (; i != nss_index; i = (i + 1) & mask) {
+		if (!slots[i].sent_ns) {
+			continue;
+		}
+
+		nss_pkt_lat_record(npc, slots[i].if_num, NSS_PKT_LAT_DIR_H2N, now - slots[i].sent_ns);
+		slots[i].sent_ns = 0;
+	}
+	spin_unlock(&npc->lock);
+
+	h2n_desc_ring->lat_nss_index = nss_index;
+}
+
+/*
+ * nss_pkt_lat_rx()
+ *	Account a packet returned by the NSS
+ */
+void nss_pkt_lat_rx(struct nss_ctx_instance *nss_ctx, struct n2h_descriptor *desc, uint8_t buffer_type, struct sk_buff *nbuf)
+{
+	struct nss_pkt_lat_core *npc = &nss_pkt_lat[nss_ctx->id];
+	uint32_t if_num = desc->interface_num;
+	uint64_t now, fw_ns, host_tx_ns = 0;
+	int64_t delta;
+	bool is_bounce;
+
+	switch (buffer_type) {
+	case N2H_BUFFER_SHAPER_BOUNCED_INTERFACE:
+	case N2H_BUFFER_SHAPER_BOUNCED_BRIDGE:
+		is_bounce = true;
+		host_tx_ns = *NSS_PKT_LAT_CB(nbuf);
+		*NSS_PKT_LAT_CB(nbuf) = 0;
+		break;
+
+	case N2H_BUFFER_PACKET_VIRTUAL:
+	case N2H_BUFFER_PACKET:
+	case N2H_BUFFER_PACKET_EXT:
+		is_bounce = false;
+		break;
+
+	default:
+		return;
+	}
+
+	now = ktime_to_ns(ktime_get());
+	fw_ns = ((uint64_t)desc->timestamp_hi * NSEC_PER_SEC) + desc->timestamp_lo;
+
+	spin_lock_bh(&npc->lock);
+	if (unlikely(!fw_ns)) {
+		npc->no_fw_ts++;
+		spin_unlock_bh(&npc->lock);
+		return;
+	}
+
+	/*
+	 * The smallest difference is the fastest transfer; use it as the clock offset
+	 */
+	delta = (int64_t)(now - fw_ns);
+	if (!npc->offset_valid || (delta < npc->offset_ns)) {
+		npc->offset_ns = delta;
+		npc->offset_valid = true;
+	}
+
+	nss_pkt_lat_record(npc, if_num, NSS_PKT_LAT_DIR_N2H, delta - npc->offset_ns);
+
+	if (is_bounce) {
+		if (unlikely(!host_tx_ns || (host_tx_ns > now) || ((now - host_tx_ns) > NSS_PKT_LAT_HOST_TS_MAX_NS))) {
+			npc->no_host_ts++;
+		} else {
+			delta = (int64_t)(fw_ns + npc->offset_ns - host_tx_ns);
+			nss_pkt_lat_record(npc, if_num, NSS_PKT_LAT_DIR_NSS, delta > 0 ? delta : 0);
+		}
+	}
+	spin_unlock_bh(&npc->lock);
+}
+
+/*
+ * nss_pkt_lat_slots_alloc()
+ *	Give every initialized H2N ring clear send time slots
+ *
+ * Called on every enable. Slots kept from an earlier enable hold send
+ * times of descriptors that were consumed while the telemetry was off, and
+ * lat_nss_index stopped moving then; both are reset.
+ */
+static void nss_pkt_lat_slots_alloc(void)
+{
+	struct nss_ctx_instance *nss_ctx;
+	struct hlos_h2n_desc_rings *h2n_desc_ring;
+	struct nss_if_mem_map *if_map;
+	struct nss_pkt_lat_slot *slots;
+	int i, qid;
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		nss_ctx = &nss_top_main.nss[i];
+		if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
+		if (!if_map) {
+			continue;
+		}
+
+		for (qid = 0; qid < NSS_H2N_DESC_RING_NUM; qid++) {
+			h2n_desc_ring = &nss_ctx->h2n_desc_rings[qid];
+			if (!h2n_desc_ring->desc_ring.size) {
+				continue;
+			}
+
+			if (h2n_desc_ring->lat_slots) {
+				spin_lock_bh(&h2n_desc_ring->lock);
+				memset(h2n_desc_ring->lat_slots, 0, h2n_desc_ring->desc_ring.size * sizeof(*slots));
+				h2n_desc_ring->lat_nss_index = if_map->h2n_nss_index[qid];
+				spin_unlock_bh(&h2n_desc_ring->lock);
+				continue;
+			}
+
+			slots = kcalloc(h2n_desc_ring->desc_ring.size, sizeof(*slots), GFP_KERNEL);
+			if (!slots) {
+				nss_warning("%p: Failed to allocate latency slots for H2N ring %d", nss_ctx, qid);
+				continue;
+			}
+
+			spin_lock_bh(&h2n_desc_ring->lock);
+			h2n_desc_ring->lat_nss_index = if_map->h2n_nss_index[qid];
+			h2n_desc_ring->lat_slots = slots;
+			spin_unlock_bh(&h2n_desc_ring->lock);
+		}
+	}
+}
+
+/*
+ * nss_pkt_lat_slots_free()
+ *	Take the send time slots back from the H2N rings
+ */
+static void nss_pkt_lat_slots_free(void)
+{
+	struct hlos_h2n_desc_rings *h2n_desc_ring;
+	struct nss_pkt_lat_slot *slots;
+	int i, qid;
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		for (qid = 0; qid < NSS_H2N_DESC_RING_NUM; qid++) {
+			h2n_desc_ring = &nss_top_main.nss[i].h2n_desc_rings[qid];
+			if (!h2n_desc_ring->lat_slots) {
+				continue;
+			}
+
+			spin_lock_bh(&h2n_desc_ring->lock);
+			slots = h2n_desc_ring->lat_slots;
+			h2n_desc_ring->lat_slots = NULL;
+			spin_unlock_bh(&h2n_desc_ring->lock);
+
+			kfree(slots);
+		}
+	}
+}
+
+/*
+ * nss_pkt_lat_records_alloc()
+ *	Give every core its histograms, returns false if any could not be allocated
+ */
+static bool nss_pkt_lat_records_alloc(void)
+{
+	struct nss_pkt_lat_core *npc;
+	struct nss_pkt_lat_hist (*records)[NSS_PKT_LAT_DIR_MAX];
+	int core;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		npc = &nss_pkt_lat[core];
+		if (npc->records) {
+			continue;
+		}
+
+		records = vzalloc(NSS_PKT_LAT_RECORDS_SIZE);
+		if (!records) {
+			nss_warning("Could not allocate memory for packet latency records of core %d", core);
+			return false;
+		}
+
+		spin_lock_bh(&npc->lock);
+		npc->records = records;
+		spin_unlock_bh(&npc->lock);
+	}
+
+	return true;
+}
+
+/*
+ * nss_pkt_lat_records_free()
+ *	Take the histograms back from every core
+ */
+static void nss_pkt_lat_records_free(void)
+{
+	struct nss_pkt_lat_core *npc;
+	struct nss_pkt_lat_hist (*records)[NSS_PKT_LAT_DIR_MAX];
+	int core;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		npc = &nss_pkt_lat[core];
+		spin_lock_bh(&npc->lock);
+		records = npc->records;
+		npc->records = NULL;
+		spin_unlock_bh(&npc->lock);
+
+		vfree(records);
+	}
+}
+
+/*
+ * nss_pkt_lat_read()
+ *	Print the latency histograms
+ */
+static ssize_t nss_pkt_lat_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_pkt_lat_hist (*records)[NSS_PKT_LAT_DIR_MAX];
+	struct nss_pkt_lat_core *npc;
+	int64_t offset_ns[NSS_MAX_CORES];
+	bool offset_valid[NSS_MAX_CORES];
+	uint64_t no_fw_ts = 0, no_host_ts = 0;
+	size_t size_al = NSS_MAX_NET_INTERFACES * NSS_PKT_LAT_DIR_MAX * (96 + NSS_PKT_LAT_BUCKETS * 24) + 512;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	char *lbuf;
+	int i, dir, j, core;
+
+	records = vzalloc(NSS_PKT_LAT_RECORDS_SIZE);
+	if (unlikely(records == NULL)) {
+		nss_warning("Could not allocate memory for packet latency records");
+		return 0;
+	}
+
+	lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		vfree(records);
+		return 0;
+	}
+
+	/*
+	 * Merge the cores; an interface lives on one core, so this mostly adds zeros
+	 */
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		npc = &nss_pkt_lat[core];
+		spin_lock_bh(&npc->lock);
+		for (i = 0; npc->records && (i < NSS_MAX_NET_INTERFACES); i++) {
+			for (dir = 0; dir < NSS_PKT_LAT_DIR_MAX; dir++) {
+				struct nss_pkt_lat_hist *src = &npc->records[i][dir];
+				struct nss_pkt_lat_hist *dst = &records[i][dir];
+
+				if (!src->count) {
+					continue;
+				}
+
+				dst->count += src->count;
+				dst->sum_ns += src->sum_ns;
+				if (src->max_ns > dst->max_ns) {
+					dst->max_ns = src->max_ns;
+				}
+
+				for (j = 0; j < NSS_PKT_LAT_BUCKETS; j++) {
+					dst->hist[j] += src->hist[j];
+				}
+			}
+		}
+
+		offset_ns[core] = npc->offset_ns;
+		offset_valid[core] = npc->offset_valid;
+		no_fw_ts += npc->no_fw_ts;
+		no_host_ts += npc->no_host_ts;
+		spin_unlock_bh(&npc->lock);
+	}
+
+	size_wr = scnprintf(lbuf, size_al, "pkt latency: %s, no_fw_ts = %llu, no_host_ts = %llu\n",
+				nss_pkt_lat_enable ? "enabled" : "disabled", no_fw_ts, no_host_ts);
+
+	for (i = 0; i < NSS_MAX_CORES; i++) {
+		if (!offset_valid[i]) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "core %d: clock offset = %lldns\n", i, offset_ns[i]);
+	}
+
+	for (i = 0; i < NSS_MAX_NET_INTERFACES; i++) {
+		for (dir = 0; dir < NSS_PKT_LAT_DIR_MAX; dir++) {
+			struct nss_pkt_lat_hist *h = &records[i][dir];
+
+			if (!h->count) {
+				continue;
+			}
+
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+					"if %d %s: count = %llu, avg_ns = %llu, max_ns = %llu\n\t",
+					i, nss_pkt_lat_dir_str[dir], h->count, div64_u64(h->sum_ns, h->count), h->max_ns);
+
+			for (j = 0; j < NSS_PKT_LAT_BUCKETS; j++) {
+				if (!h->hist[j]) {
+					continue;
+				}
+
+				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "<%uns:%u ", 1U << j, h->hist[j]);
+			}
+
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+		}
+	}
+
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
+	vfree(records);
+
+	return bytes_read;
+}
+
+/*
+ * nss_pkt_lat_write()
+ *	Clear the histograms and restart the clock offset estimate
+ */
+static ssize_t nss_pkt_lat_write(struct file *fp, const char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_pkt_lat_core *npc;
+	int core;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		npc = &nss_pkt_lat[core];
+		spin_lock_bh(&npc->lock);
+		if (npc->records) {
+			memset(npc->records, 0, NSS_PKT_LAT_RECORDS_SIZE);
+		}
+
+		npc->offset_valid = false;
+		npc->no_fw_ts = 0;
+		npc->no_host_ts = 0;
+		spin_unlock_bh(&npc->lock);
+	}
+
+	return sz;
+}
+
+static const struct file_operations nss_pkt_lat_ops = {
+	.read = nss_pkt_lat_read,
+	.write = nss_pkt_lat_write,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_pkt_lat_enable_handler()
+ *	Enable/disable the telemetry
+ *
+ * Enabling allocates the histograms and allocates or clears the H2N slots;
+ * disabling frees the histograms, so the counts start over on re-enable.
+ */
+static int nss_pkt_lat_enable_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	struct ctl_table tmp = *ctl;
+	int enable = nss_pkt_lat_enable;
+	int ret;
+
+	/*
+	 * Parse into a local so that the data path only sees the telemetry
+	 * enabled once the slots are ready
+	 */
+	tmp.data = &enable;
+	mutex_lock(&nss_pkt_lat_ctl_lock);
+	ret = proc_dointvec(&tmp, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		goto done;
+	}
+
+	if (!enable) {
+		nss_pkt_lat_enable = 0;
+		nss_pkt_lat_records_free();
+		goto done;
+	}
+
+	if (!nss_pkt_lat_records_alloc()) {
+		nss_pkt_lat_records_free();
+		ret = -ENOMEM;
+		goto done;
+	}
+
+	nss_pkt_lat_slots_alloc();
+	nss_pkt_lat_enable = enable;
+
+done:
+	mutex_unlock(&nss_pkt_lat_ctl_lock);
+	return ret;
+}
+
+/*
+ * nss_pkt_lat_table
+ *	Registered by nss_init.c as /proc/sys/dev/nss/pkt_lat
+ */
+struct ctl_table nss_pkt_lat_table[] = {
+	{
+		.procname		= "enable",
+		.data			= &nss_pkt_lat_enable,
+		.maxlen			= sizeof(int),
+		.mode			= 0644,
+		.proc_handler		= &nss_pkt_lat_enable_handler,
+	},
+	{ }
+};
+
+/*
+ * nss_pkt_lat_init()
+ *	Initialize the latency records and the debugfs entry
+ */
+void nss_pkt_lat_init(void)
+{
+	int core;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		spin_lock_init(&nss_pkt_lat[core].lock);
+	}
+
+	nss_pkt_lat_dentry = debugfs_create_file("pkt_latency", 0600, nss_top_main.stats_dentry,
+							&nss_top_main, &nss_pkt_lat_ops);
+	if (unlikely(nss_pkt_lat_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/pkt_latency file in debugfs");
+	}
+}
+
+/*
+ * nss_pkt_lat_exit()
+ *	Stop the telemetry and release the H2N slots and histograms
+ */
+void nss_pkt_lat_exit(void)
+{
+	nss_pkt_lat_enable = 0;
+
+	debugfs_remove(nss_pkt_lat_dentry);
+	nss_pkt_lat_dentry = NULL;
+
+	nss_pkt_lat_slots_free();
+	nss_pkt_lat_records_free();
+}
@@ -55,11 +55,11 @@ static void nss_portid_sync_update(struct nss_ctx_instance *nss_ctx, struct nss_
 		 * Update PORTID base node stats.
 		 */
 		spin_lock_bh(&nss_top->stats_lock);
-		nss_top->stats_node[NSS_PORTID_INTERFACE][NSS_STATS_NODE_RX_PKTS] += npsm->node_stats.rx_packets;
-		nss_top->stats_node[NSS_PORTID_INTERFACE][NSS_STATS_NODE_RX_BYTES] += npsm->node_stats.rx_bytes;
-		nss_top->stats_node[NSS_PORTID_INTERFACE][NSS_STATS_NODE_RX_DROPPED] += npsm->node_stats.rx_dropped;
-		nss_top->stats_node[NSS_PORTID_INTERFACE][NSS_STATS_NODE_TX_PKTS] += npsm->node_stats.tx_packets;
-		nss_top->stats_node[NSS_PORTID_INTERFACE][NSS_STATS_NODE_TX_BYTES] += npsm->node_stats.tx_bytes;
+		nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_PORTID_INTERFACE)][NSS_STATS_NODE_RX_PKTS] += npsm->node_stats.rx_packets;
+		nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_PORTID_INTERFACE)][NSS_STATS_NODE_RX_BYTES] += npsm->node_stats.rx_bytes;
+		nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_PORTID_INTERFACE)][NSS_STATS_NODE_RX_DROPPED] += npsm->node_stats.rx_dropped;
+		nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_PORTID_INTERFACE)][NSS_STATS_NODE_TX_PKTS] += npsm->node_stats.tx_packets;
+		nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_PORTID_INTERFACE)][NSS_STATS_NODE_TX_BYTES] += npsm->node_stats.tx_bytes;
 		nss_top->stats_portid[NSS_STATS_PORTID_RX_INVALID_HEADER] += npsm->rx_invalid_header;
 		spin_unlock_bh(&nss_top->stats_lock);
 		return;
@@ -133,7 +133,7 @@ static void nss_portid_handler(struct nss_ctx_instance *nss_ctx, struct nss_cmn_
 	 * to the same callback/app_data.
 	 */
 	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
-		ncm->cb = (uint32_t)nss_ctx->nss_top->if_rx_msg_callback[ncm->interface];
+		ncm->cb = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].if_rx_msg_cb;
 		ncm->app_data = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].ndev;
 	}
 
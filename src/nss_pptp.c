@@ -19,12 +19,6 @@
 
 #define NSS_PPTP_TX_TIMEOUT 3000 /* 3 Seconds */
 
-/*
- * Data structures to store pptp nss debug stats
- */
-static DEFINE_SPINLOCK(nss_pptp_session_debug_stats_lock);
-static struct nss_stats_pptp_session_debug nss_pptp_session_debug_stats[NSS_MAX_PPTP_DYNAMIC_INTERFACES];
-
 /*
  * Private data structure
  */
@@ -42,35 +36,35 @@ static struct nss_pptp_pvt {
  */
 void nss_pptp_session_debug_stats_sync(struct nss_ctx_instance *nss_ctx, struct nss_pptp_sync_session_stats_msg *stats_msg, uint16_t if_num)
 {
-	int i;
-	spin_lock_bh(&nss_pptp_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_PPTP_DYNAMIC_INTERFACES; i++) {
-		if (nss_pptp_session_debug_stats[i].if_num == if_num) {
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_ENCAP_RX_PACKETS] += stats_msg->encap_stats.rx_packets;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_ENCAP_RX_BYTES] += stats_msg->encap_stats.rx_bytes;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_ENCAP_TX_PACKETS] += stats_msg->encap_stats.tx_packets;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_ENCAP_TX_BYTES] += stats_msg->encap_stats.tx_bytes;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_ENCAP_RX_DROP] += stats_msg->encap_stats.rx_dropped;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_DECAP_RX_PACKETS] += stats_msg->decap_stats.rx_packets;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_DECAP_RX_BYTES] += stats_msg->decap_stats.rx_bytes;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_DECAP_TX_PACKETS] += stats_msg->decap_stats.tx_packets;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_DECAP_TX_BYTES] += stats_msg->decap_stats.tx_bytes;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_DECAP_RX_DROP] += stats_msg->decap_stats.rx_dropped;
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_ENCAP_HEADROOM_ERR] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_ENCAP_HEADROOM_ERR];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_ENCAP_SMALL_SIZE] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_ENCAP_SMALL_SIZE];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_ENCAP_PNODE_ENQUEUE_FAIL] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_ENCAP_PNODE_ENQUEUE_FAIL];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_NO_SEQ_NOR_ACK] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_NO_SEQ_NOR_ACK];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_INVAL_GRE_FLAGS] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_INVAL_GRE_FLAGS];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_INVAL_GRE_PROTO] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_INVAL_GRE_PROTO];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_WRONG_SEQ] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_WRONG_SEQ];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_INVAL_PPP_HDR] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_INVAL_PPP_HDR];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_PPP_LCP] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_PPP_LCP];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_UNSUPPORTED_PPP_PROTO] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_UNSUPPORTED_PPP_PROTO];
-			nss_pptp_session_debug_stats[i].stats[NSS_STATS_PPTP_SESSION_DECAP_PNODE_ENQUEUE_FAIL] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_PNODE_ENQUEUE_FAIL];
-			break;
-		}
+	uint64_t *stats;
+
+	stats = nss_session_stats_update_begin(NSS_SESSION_STATS_TYPE_PPTP, if_num);
+	if (!stats) {
+		return;
 	}
-	spin_unlock_bh(&nss_pptp_session_debug_stats_lock);
+
+	stats[NSS_STATS_PPTP_ENCAP_RX_PACKETS] += stats_msg->encap_stats.rx_packets;
+	stats[NSS_STATS_PPTP_ENCAP_RX_BYTES] += stats_msg->encap_stats.rx_bytes;
+	stats[NSS_STATS_PPTP_ENCAP_TX_PACKETS] += stats_msg->encap_stats.tx_packets;
+	stats[NSS_STATS_PPTP_ENCAP_TX_BYTES] += stats_msg->encap_stats.tx_bytes;
+	stats[NSS_STATS_PPTP_ENCAP_RX_DROP] += stats_msg->encap_stats.rx_dropped;
+	stats[NSS_STATS_PPTP_DECAP_RX_PACKETS] += stats_msg->decap_stats.rx_packets;
+	stats[NSS_STATS_PPTP_DECAP_RX_BYTES] += stats_msg->decap_stats.rx_bytes;
+	stats[NSS_STATS_PPTP_DECAP_TX_PACKETS] += stats_msg->decap_stats.tx_packets;
+	stats[NSS_STATS_PPTP_DECAP_TX_BYTES] += stats_msg->decap_stats.tx_bytes;
+	stats[NSS_STATS_PPTP_DECAP_RX_DROP] += stats_msg->decap_stats.rx_dropped;
+	stats[NSS_STATS_PPTP_SESSION_ENCAP_HEADROOM_ERR] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_ENCAP_HEADROOM_ERR];
+	stats[NSS_STATS_PPTP_SESSION_ENCAP_SMALL_SIZE] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_ENCAP_SMALL_SIZE];
+	stats[NSS_STATS_PPTP_SESSION_ENCAP_PNODE_ENQUEUE_FAIL] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_ENCAP_PNODE_ENQUEUE_FAIL];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_NO_SEQ_NOR_ACK] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_NO_SEQ_NOR_ACK];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_INVAL_GRE_FLAGS] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_INVAL_GRE_FLAGS];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_INVAL_GRE_PROTO] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_INVAL_GRE_PROTO];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_WRONG_SEQ] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_WRONG_SEQ];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_INVAL_PPP_HDR] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_INVAL_PPP_HDR];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_PPP_LCP] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_PPP_LCP];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_UNSUPPORTED_PPP_PROTO] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_UNSUPPORTED_PPP_PROTO];
+	stats[NSS_STATS_PPTP_SESSION_DECAP_PNODE_ENQUEUE_FAIL] += stats_msg->exception_events[PPTP_EXCEPTION_EVENT_DECAP_PNODE_ENQUEUE_FAIL];
+	nss_session_stats_update_end(stats);
 }
 
 /*
@@ -80,21 +74,21 @@ void nss_pptp_session_debug_stats_sync(struct nss_ctx_instance *nss_ctx, struct
 void nss_pptp_session_debug_stats_get(void *stats_mem)
 {
 	struct nss_stats_pptp_session_debug *stats = (struct nss_stats_pptp_session_debug *)stats_mem;
-	int i;
+	int i, n = 0;
 
 	if (!stats) {
 		nss_warning("No memory to copy pptp session stats");
 		return;
 	}
 
-	spin_lock_bh(&nss_pptp_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_PPTP_DYNAMIC_INTERFACES; i++) {
-		if (nss_pptp_session_debug_stats[i].valid) {
-			memcpy(stats, &nss_pptp_session_debug_stats[i], sizeof(struct nss_stats_pptp_session_debug));
+	for (i = 0; (i < NSS_MAX_DYNAMIC_INTERFACES) && (n < NSS_MAX_PPTP_DYNAMIC_INTERFACES); i++) {
+		if (nss_session_stats_read(NSS_SESSION_STATS_TYPE_PPTP, NSS_DYNAMIC_IF_START + i, &stats->if_index, stats->stats)) {
+			stats->if_num = NSS_DYNAMIC_IF_START + i;
+			stats->valid = true;
 			stats++;
+			n++;
 		}
 	}
-	spin_unlock_bh(&nss_pptp_session_debug_stats_lock);
 }
 
 /*
@@ -346,7 +340,6 @@ struct nss_ctx_instance *nss_register_pptp_if(uint32_t if_num,
 					      uint32_t features,
 					      void *app_ctx)
 {
-	int i = 0;
 	nss_assert(nss_is_dynamic_interface(if_num));
 
 	nss_top_main.subsys_dp_register[if_num].ndev = netdev;
@@ -358,16 +351,7 @@ struct nss_ctx_instance *nss_register_pptp_if(uint32_t if_num,
 
 	nss_core_register_handler(if_num, nss_pptp_handler, NULL);
 
-	spin_lock_bh(&nss_pptp_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_PPTP_DYNAMIC_INTERFACES; i++) {
-		if (!nss_pptp_session_debug_stats[i].valid) {
-			nss_pptp_session_debug_stats[i].valid = true;
-			nss_pptp_session_debug_stats[i].if_num = if_num;
-			nss_pptp_session_debug_stats[i].if_index = netdev->ifindex;
-			break;
-		}
-	}
-	spin_unlock_bh(&nss_pptp_session_debug_stats_lock);
+	nss_session_stats_add(NSS_SESSION_STATS_TYPE_PPTP, if_num, netdev->ifindex);
 
 	return (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.pptp_handler_id];
 }
@@ -377,17 +361,9 @@ struct nss_ctx_instance *nss_register_pptp_if(uint32_t if_num,
  */
 void nss_unregister_pptp_if(uint32_t if_num)
 {
-	int i;
-
 	nss_assert(nss_is_dynamic_interface(if_num));
 
-	spin_lock_bh(&nss_pptp_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_PPTP_DYNAMIC_INTERFACES; i++) {
-		nss_pptp_session_debug_stats[i].valid = false;
-		nss_pptp_session_debug_stats[i].if_num = 0;
-		nss_pptp_session_debug_stats[i].if_index = 0;
-	}
-	spin_unlock_bh(&nss_pptp_session_debug_stats_lock);
+	nss_session_stats_del(NSS_SESSION_STATS_TYPE_PPTP, if_num);
 
 	nss_top_main.subsys_dp_register[if_num].ndev = NULL;
 	nss_top_main.subsys_dp_register[if_num].cb = NULL;
@@ -421,19 +397,9 @@ void nss_pptp_msg_init(struct nss_pptp_msg *ncm, uint16_t if_num, uint32_t type,
  */
 void nss_pptp_register_handler(void)
 {
-	int i;
-
 	nss_info("nss_pptp_register_handler");
 	nss_core_register_handler(NSS_PPTP_INTERFACE, nss_pptp_handler, NULL);
 
-	spin_lock_bh(&nss_pptp_session_debug_stats_lock);
-	for (i = 0; i < NSS_MAX_PPTP_DYNAMIC_INTERFACES; i++) {
-		nss_pptp_session_debug_stats[i].valid = false;
-		nss_pptp_session_debug_stats[i].if_num = 0;
-		nss_pptp_session_debug_stats[i].if_index = 0;
-	}
-	spin_unlock_bh(&nss_pptp_session_debug_stats_lock);
-
 	sema_init(&pptp_pvt.sem, 1);
 	init_completion(&pptp_pvt.complete);
 }
@@ -0,0 +1,226 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_session_stats.c
+ *	Per-session debug statistics of the tunnel interfaces
+ *
+ * Sessions are dynamic interfaces, so the store is an array indexed by
+ * dynamic interface number. A sync message finds its session in O(1) and
+ * readers walk the array under RCU without blocking the sync path.
+ */
+
+#include <linux/rcupdate.h>
+#include <linux/u64_stats_sync.h>
+#include "nss_tx_rx_common.h"
+#include "nss_dtls_stats.h"
+
+/*
+ * nss_session_stats
+ *	Statistics of one session
+ */
+struct nss_session_stats {
+	struct rcu_head rcu;		/* Freed after the readers are done */
+	struct u64_stats_sync syncp;	/* Consistent 64-bit reads against the sync writer */
+	enum nss_session_stats_type type;
+					/* Tunnel type owning the session */
+	int32_t if_index;		/* Netdevice index of the session */
+	uint64_t stats[0];		/* nss_session_stats_num[type] counters */
+};
+
+/*
+ * Number of counters per session type
+ */
+static const uint32_t nss_session_stats_num[NSS_SESSION_STATS_TYPE_MAX] = {
+	[NSS_SESSION_STATS_TYPE_DTLS] = NSS_STATS_DTLS_SESSION_MAX,
+	[NSS_SESSION_STATS_TYPE_L2TPV2] = NSS_STATS_L2TPV2_SESSION_MAX,
+	[NSS_SESSION_STATS_TYPE_PPTP] = NSS_STATS_PPTP_SESSION_MAX,
+	[NSS_SESSION_STATS_TYPE_MAP_T] = NSS_STATS_MAP_T_MAX,
+};
+
+static struct nss_session_stats __rcu *nss_session_stats_slot[NSS_MAX_DYNAMIC_INTERFACES];
+static DEFINE_SPINLOCK(nss_session_stats_lock);	/* Serializes add and delete */
+
+/*
+ * nss_session_stats_add()
+ *	Start collecting statistics for a session
+ *
+ * A stale session left on the interface number is replaced.
+ */
+int nss_session_stats_add(enum nss_session_stats_type type, uint32_t if_num, int32_t if_index)
+{
+	struct nss_session_stats *ss, *old;
+
+	if ((type == NSS_SESSION_STATS_TYPE_NONE) || (type >= NSS_SESSION_STATS_TYPE_MAX)) {
+		nss_warning("Invalid session stats type %d", type);
+		return -EINVAL;
+	}
+
+	if (!nss_is_dynamic_interface(if_num)) {
+		nss_warning("Session stats for non dynamic interface %u", if_num);
+		return -EINVAL;
+	}
+
+	ss = kzalloc(sizeof(*ss) + (nss_session_stats_num[type] * sizeof(uint64_t)), GFP_ATOMIC);
+	if (!ss) {
+		nss_warning("Failed to allocate session stats for interface %u", if_num);
+		return -ENOMEM;
+	}
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(3, 13, 0))
+	u64_stats_init(&ss->syncp);
+#endif
+	ss->type = type;
+	ss->if_index = if_index;
+
+	spin_lock_bh(&nss_session_stats_lock);
+	old = rcu_dereference_protected(nss_session_stats_slot[if_num - NSS_DYNAMIC_IF_START],
+					lockdep_is_held(&nss_session_stats_lock));
+	rcu_assign_pointer(nss_session_stats_slot[if_num - NSS_DYNAMIC_IF_START], ss);
+	spin_unlock_bh(&nss_session_stats_lock);
+
+	if (old) {
+		kfree_rcu(old, rcu);
+	}
+
+	return 0;
+}
+
+/*
+ * nss_session_stats_del()
+ *	Stop collecting statistics for a session
+ */
+void nss_session_stats_del(enum nss_session_stats_type type, uint32_t if_num)
+{
+	struct nss_session_stats *ss;
+
+	if (!nss_is_dynamic_interface(if_num)) {
+		return;
+	}
+
+	spin_lock_bh(&nss_session_stats_lock);
+	ss = rcu_dereference_protected(nss_session_stats_slot[if_num - NSS_DYNAMIC_IF_START],
+					lockdep_is_held(&nss_session_stats_lock));
+	if (!ss || (ss->type != type)) {
+		spin_unlock_bh(&nss_session_stats_lock);
+		return;
+	}
+
+	RCU_INIT_POINTER(nss_session_stats_slot[if_num - NSS_DYNAMIC_IF_START], NULL);
+	spin_unlock_bh(&nss_session_stats_lock);
+
+	kfree_rcu(ss, rcu);
+}
+
+/*
+ * nss_session_stats_del_type()
+ *	Stop collecting statistics for every session of a type
+ */
+void nss_session_stats_del_type(enum nss_session_stats_type type)
+{
+	uint32_t i;
+
+	for (i = 0; i < NSS_MAX_DYNAMIC_INTERFACES; i++) {
+		nss_session_stats_del(type, NSS_DYNAMIC_IF_START + i);
+	}
+}
+
+/*
+ * nss_session_stats_update_begin()
+ *	Counters of a session for a stats sync, NULL if it is not tracked
+ *
+ * On success the caller adds to the returned counters and then calls
+ * nss_session_stats_update_end(). Only the message handler of the session
+ * writes, so the update needs no lock.
+ */
+uint64_t *nss_session_stats_update_begin(enum nss_session_stats_type type, uint32_t if_num)
+{
+	struct nss_session_stats *ss;
+
+	if (!nss_is_dynamic_interface(if_num)) {
+		return NULL;
+	}
+
+	rcu_read_lock();
+	ss = rcu_dereference(nss_session_stats_slot[if_num - NSS_DYNAMIC_IF_START]);
+	if (!ss || (ss->type != type)) {
+		rcu_read_unlock();
+		return NULL;
+	}
+
+	u64_stats_update_begin(&ss->syncp);
+	return ss->stats;
+}
+
+/*
+ * nss_session_stats_update_end()
+ *	Publish the counters taken with nss_session_stats_update_begin()
+ */
+void nss_session_stats_update_end(uint64_t *stats)
+{
+	struct nss_session_stats *ss = container_of(stats, struct nss_session_stats, stats[0]);
+
+	u64_stats_update_end(&ss->syncp);
+	rcu_read_unlock();
+}
+
+/*
+ * nss_session_stats_read()
+ *	Copy the counters of a session, false if it is not tracked
+ *
+ * stats must hold the number of counters of the type.
+ */
+bool nss_session_stats_read(enum nss_session_stats_type type, uint32_t if_num, int32_t *if_index, uint64_t *stats)
+{
+	struct nss_session_stats *ss;
+	unsigned int start;
+
+	if (!nss_is_dynamic_interface(if_num)) {
+		return false;
+	}
+
+	rcu_read_lock();
+	ss = rcu_dereference(nss_session_stats_slot[if_num - NSS_DYNAMIC_IF_START]);
+	if (!ss || (ss->type != type)) {
+		rcu_read_unlock();
+		return false;
+	}
+
+	do {
+		start = u64_stats_fetch_begin_bh(&ss->syncp);
+		memcpy(stats, ss->stats, nss_session_stats_num[type] * sizeof(uint64_t));
+	} while (u64_stats_fetch_retry_bh(&ss->syncp, start));
+
+	*if_index = ss->if_index;
+	rcu_read_unlock();
+
+	return true;
+}
+
+/*
+ * nss_session_stats_exit()
+ *	Free every session at unload
+ */
+void nss_session_stats_exit(void)
+{
+	enum nss_session_stats_type type;
+
+	for (type = NSS_SESSION_STATS_TYPE_NONE + 1; type < NSS_SESSION_STATS_TYPE_MAX; type++) {
+		nss_session_stats_del_type(type);
+	}
+
+	rcu_barrier();
+}
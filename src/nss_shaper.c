@@ -38,23 +38,35 @@ void nss_shaper_unregister_shaping(void *nss_ctx)
 }
 
 /*
- * nss_shaper_register_shaper_bounce_interface()
- *	Register for performing shaper bounce operations for interface shaper
+ * nss_shaper_bounce_slot()
+ *	Registrant pointer of an interface for interface or bridge bouncing
  */
-void *nss_shaper_register_shaper_bounce_interface(uint32_t if_num, nss_shaper_bounced_callback_t cb, void *app_data, struct module *owner)
+static inline struct nss_shaper_bounce_registrant __rcu **nss_shaper_bounce_slot(struct nss_if_cold *cold, bool bridge)
+{
+	return bridge ? &cold->bounce_bridge : &cold->bounce_interface;
+}
+
+/*
+ * nss_shaper_bounce_register()
+ *	Register for performing shaper bounce operations
+ */
+static void *nss_shaper_bounce_register(uint32_t if_num, bool bridge, nss_shaper_bounced_callback_t cb,
+					nss_shaper_bounced_list_callback_t list_cb, void *app_data, struct module *owner)
 {
 	struct nss_top_instance *nss_top = &nss_top_main;
+	struct nss_shaper_bounce_registrant __rcu **slot;
 	struct nss_shaper_bounce_registrant *reg;
+	struct nss_if_cold *cold;
 
-	nss_info("Shaper bounce interface register: %u, cb: %p, app_data: %p, owner: %p",
-			if_num, cb, app_data, owner);
+	nss_info("Shaper bounce %s register: %u, cb: %p, list_cb: %p, app_data: %p, owner: %p",
+			bridge ? "bridge" : "interface", if_num, cb, list_cb, app_data, owner);
 
 	/*
 	 * Must be valid interface number
 	 */
 	if (if_num >= NSS_MAX_NET_INTERFACES) {
 		nss_warning("Invalid if_num: %u", if_num);
-		BUG_ON(false);
+		return NULL;
 	}
 
 	/*
@@ -73,49 +85,75 @@ void *nss_shaper_register_shaper_bounce_interface(uint32_t if_num, nss_shaper_bo
 		return NULL;
 	}
 
+	cold = nss_core_if_cold_get(if_num);
+	if (!cold) {
+		module_put(owner);
+		nss_warning("%p: No state for interface %u", __func__, if_num);
+		return NULL;
+	}
+
+	reg = kzalloc(sizeof(*reg), GFP_KERNEL);
+	if (!reg) {
+		module_put(owner);
+		nss_warning("%p: No memory for registrant of interface %u", __func__, if_num);
+		return NULL;
+	}
+
+	reg->bounced_callback = cb;
+	reg->bounced_list_callback = list_cb;
+	reg->app_data = app_data;
+	reg->owner = owner;
+
 	spin_lock_bh(&nss_top->lock);
 
 	/*
 	 * Must not have existing registrant
 	 */
-	reg = &nss_top->bounce_interface_registrants[if_num];
-	if (reg->registered) {
-		spin_unlock_bh(&nss_top->stats_lock);
+	slot = nss_shaper_bounce_slot(cold, bridge);
+	if (rcu_dereference_protected(*slot, lockdep_is_held(&nss_top->lock))) {
+		spin_unlock_bh(&nss_top->lock);
+		kfree(reg);
 		module_put(owner);
 		nss_warning("Already registered: %u", if_num);
-		BUG_ON(false);
+		return NULL;
 	}
 
 	/*
 	 * Register
 	 */
-	reg->bounced_callback = cb;
-	reg->app_data = app_data;
-	reg->owner = owner;
-	reg->registered = true;
+	rcu_assign_pointer(*slot, reg);
 	spin_unlock_bh(&nss_top->lock);
 
 	return (void *)&nss_top->nss[nss_top->shaping_handler_id];
 }
 
 /*
- * nss_shaper_unregister_shaper_bounce_interface()
- *	Unregister for shaper bounce operations for interface shaper
+ * nss_shaper_bounce_unregister()
+ *	Unregister for shaper bounce operations
+ *
+ * Returns once no bounced callback of the registrant can be running.
  */
-void nss_shaper_unregister_shaper_bounce_interface(uint32_t if_num)
+static void nss_shaper_bounce_unregister(uint32_t if_num, bool bridge)
 {
 	struct nss_top_instance *nss_top = &nss_top_main;
+	struct nss_shaper_bounce_registrant __rcu **slot;
 	struct nss_shaper_bounce_registrant *reg;
-	struct module *owner;
+	struct nss_if_cold *cold;
 
-	nss_info("Shaper bounce interface unregister: %u", if_num);
+	nss_info("Shaper bounce %s unregister: %u", bridge ? "bridge" : "interface", if_num);
 
 	/*
 	 * Must be valid interface number
 	 */
 	if (if_num >= NSS_MAX_NET_INTERFACES) {
 		nss_warning("Invalid if_num: %u", if_num);
-		BUG_ON(false);
+		return;
+	}
+
+	cold = nss_core_if_cold(nss_top, if_num);
+	if (!cold) {
+		nss_warning("Already unregistered: %u", if_num);
+		return;
 	}
 
 	spin_lock_bh(&nss_top->lock);
@@ -123,137 +161,165 @@ void nss_shaper_unregister_shaper_bounce_interface(uint32_t if_num)
 	/*
 	 * Must have existing registrant
 	 */
-	reg = &nss_top->bounce_interface_registrants[if_num];
-	if (!reg->registered) {
-		spin_unlock_bh(&nss_top->stats_lock);
+	slot = nss_shaper_bounce_slot(cold, bridge);
+	reg = rcu_dereference_protected(*slot, lockdep_is_held(&nss_top->lock));
+	if (!reg) {
+		spin_unlock_bh(&nss_top->lock);
 		nss_warning("Already unregistered: %u", if_num);
-		BUG_ON(false);
+		return;
 	}
 
 	/*
-	 * Unegister
+	 * Unregister
 	 */
-	owner = reg->owner;
-	reg->owner = NULL;
-	reg->registered = false;
+	RCU_INIT_POINTER(*slot, NULL);
 	spin_unlock_bh(&nss_top->lock);
 
-	module_put(owner);
+	/*
+	 * Wait until any bounce callback that is active is finished
+	 */
+	synchronize_rcu();
+
+	module_put(reg->owner);
+	kfree(reg);
 }
 
 /*
- * nss_shaper_register_shaper_bounce_bridge()
- *	Register for performing shaper bounce operations for bridge shaper
+ * nss_shaper_bounce_registered()
+ *	Is there a registrant for bouncing on this interface?
  */
-void *nss_shaper_register_shaper_bounce_bridge(uint32_t if_num, nss_shaper_bounced_callback_t cb, void *app_data, struct module *owner)
+static inline bool nss_shaper_bounce_registered(struct nss_top_instance *nss_top, uint32_t if_num, bool bridge)
 {
-	struct nss_top_instance *nss_top = &nss_top_main;
-	struct nss_ctx_instance *nss_ctx;
-	struct nss_shaper_bounce_registrant *reg;
+	struct nss_if_cold *cold = nss_core_if_cold(nss_top, if_num);
+
+	return cold && rcu_access_pointer(*nss_shaper_bounce_slot(cold, bridge));
+}
 
-	nss_info("Shaper bounce bridge register: %u, cb: %p, app_data: %p, owner: %p",
-			if_num, cb, app_data, owner);
+/*
+ * nss_shaper_bounce_packets()
+ *	Bounce a list of packets to the NSS and ring the doorbell once
+ *
+ * Packets are taken off the head of the list as they are queued; on failure
+ * the packets not sent are left on the list.
+ */
+static nss_tx_status_t nss_shaper_bounce_packets(struct nss_ctx_instance *nss_ctx, uint32_t if_num, struct sk_buff_head *list,
+						bool bridge)
+{
+	uint8_t buffer_type = bridge ? H2N_BUFFER_SHAPER_BOUNCE_BRIDGE : H2N_BUFFER_SHAPER_BOUNCE_INTERFACE;
+	uint16_t qid = bridge ? NSS_IF_CMD_QUEUE : 0;
+	nss_tx_status_t ret = NSS_TX_SUCCESS;
+	struct sk_buff *skb;
+	uint32_t sent = 0;
 
 	/*
 	 * Must be valid interface number
 	 */
 	if (if_num >= NSS_MAX_NET_INTERFACES) {
 		nss_warning("Invalid if_num: %u", if_num);
-		BUG_ON(false);
+		return NSS_TX_FAILURE;
 	}
 
 	/*
-	 * Shaping enabled?
+	 * Must have existing registrant
 	 */
-	if (nss_top_main.shaping_handler_id == (uint8_t)-1) {
-		nss_warning("%p: SHAPING IS NOT ENABLED", __func__);
-		return NULL;
+	if (unlikely(!nss_shaper_bounce_registered(nss_ctx->nss_top, if_num, bridge))) {
+		nss_warning("unregistered: %u", if_num);
+		return NSS_TX_FAILURE;
 	}
 
 	/*
-	 * Can we hold the module?
+	 * Dequeue before sending; the NSS may return the packet at once
 	 */
-	if (!try_module_get(owner)) {
-		nss_warning("%p: Unable to hold owner", __func__);
-		return NULL;
+	while ((skb = __skb_dequeue(list)) != NULL) {
+		if (nss_core_send_buffer(nss_ctx, if_num, skb, qid, buffer_type, 0) != NSS_CORE_STATUS_SUCCESS) {
+			__skb_queue_head(list, skb);
+			nss_info("%s: %s bounce core send rejected", __func__, bridge ? "Bridge" : "Interface");
+			ret = NSS_TX_FAILURE;
+			break;
+		}
+
+		NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->nss_top->stats_drv[NSS_STATS_DRV_TX_CMD_REQ]);
+		sent++;
 	}
 
-	spin_lock_bh(&nss_top->lock);
-
-	/*
-	 * Must not have existing registrant
-	 */
-	reg = &nss_top->bounce_bridge_registrants[if_num];
-	if (reg->registered) {
-		spin_unlock_bh(&nss_top->stats_lock);
-		module_put(owner);
-		nss_warning("Already registered: %u", if_num);
-		BUG_ON(false);
+	if (likely(sent)) {
+		nss_hal_send_interrupt(nss_ctx->nmap, nss_ctx->h2n_desc_rings[NSS_IF_CMD_QUEUE].desc_ring.int_bit,
+									NSS_REGS_H2N_INTR_STATUS_DATA_COMMAND_QUEUE);
 	}
 
-	/*
-	 * Register
-	 */
-	reg->bounced_callback = cb;
-	reg->app_data = app_data;
-	reg->owner = owner;
-	reg->registered = true;
-	spin_unlock_bh(&nss_top->lock);
-
-	nss_ctx = &nss_top->nss[nss_top->shaping_handler_id];
-	return (void *)nss_ctx;
+	return ret;
 }
 
 /*
- * nss_shaper_unregister_shaper_bounce_bridge()
- *	Unregister for shaper bounce operations for bridge shaper
+ * nss_shaper_bounce_packet()
+ *	Bounce one packet to the NSS
  */
-void nss_shaper_unregister_shaper_bounce_bridge(uint32_t if_num)
+static nss_tx_status_t nss_shaper_bounce_packet(struct nss_ctx_instance *nss_ctx, uint32_t if_num, struct sk_buff *skb, bool bridge)
 {
-	struct nss_top_instance *nss_top = &nss_top_main;
-	struct nss_shaper_bounce_registrant *reg;
-	struct module *owner;
-
-	nss_info("Shaper bounce bridge unregister: %u", if_num);
+	struct sk_buff_head list;
 
-	/*
-	 * Must be valid interface number
-	 */
-	if (if_num >= NSS_MAX_NET_INTERFACES) {
-		nss_warning("Invalid if_num: %u", if_num);
-		BUG_ON(false);
+	__skb_queue_head_init(&list);
+	__skb_queue_tail(&list, skb);
+	if (nss_shaper_bounce_packets(nss_ctx, if_num, &list, bridge) != NSS_TX_SUCCESS) {
+		__skb_unlink(skb, &list);
+		return NSS_TX_FAILURE;
 	}
 
-	spin_lock_bh(&nss_top->lock);
+	return NSS_TX_SUCCESS;
+}
 
-	/*
-	 * Must have existing registrant
-	 */
-	reg = &nss_top->bounce_bridge_registrants[if_num];
-	if (!reg->registered) {
-		spin_unlock_bh(&nss_top->stats_lock);
-		nss_warning("Already unregistered: %u", if_num);
-		BUG_ON(false);
-	}
+/*
+ * nss_shaper_register_shaper_bounce_interface()
+ *	Register for performing shaper bounce operations for interface shaper
+ */
+void *nss_shaper_register_shaper_bounce_interface(uint32_t if_num, nss_shaper_bounced_callback_t cb, void *app_data, struct module *owner)
+{
+	return nss_shaper_bounce_register(if_num, false, cb, NULL, app_data, owner);
+}
 
-	/*
-	 * Wait until any bounce callback that is active is finished
-	 */
-	while (reg->callback_active) {
-		spin_unlock_bh(&nss_top->stats_lock);
-		yield();
-		spin_lock_bh(&nss_top->stats_lock);
-	}
+/*
+ * nss_shaper_register_shaper_bounce_interface_list()
+ *	Register for interface shaper bounce operations, packets are returned in lists
+ */
+void *nss_shaper_register_shaper_bounce_interface_list(uint32_t if_num, nss_shaper_bounced_list_callback_t cb, void *app_data, struct module *owner)
+{
+	return nss_shaper_bounce_register(if_num, false, NULL, cb, app_data, owner);
+}
 
-	/*
-	 * Unegister
-	 */
-	owner = reg->owner;
-	reg->owner = NULL;
-	reg->registered = false;
-	spin_unlock_bh(&nss_top->lock);
+/*
+ * nss_shaper_unregister_shaper_bounce_interface()
+ *	Unregister for shaper bounce operations for interface shaper
+ */
+void nss_shaper_unregister_shaper_bounce_interface(uint32_t if_num)
+{
+	nss_shaper_bounce_unregister(if_num, false);
+}
 
-	module_put(owner);
+/*
+ * nss_shaper_register_shaper_bounce_bridge()
+ *	Register for performing shaper bounce operations for bridge shaper
+ */
+void *nss_shaper_register_shaper_bounce_bridge(uint32_t if_num, nss_shaper_bounced_callback_t cb, void *app_data, struct module *owner)
+{
+	return nss_shaper_bounce_register(if_num, true, cb, NULL, app_data, owner);
+}
+
+/*
+ * nss_shaper_register_shaper_bounce_bridge_list()
+ *	Register for bridge shaper bounce operations, packets are returned in lists
+ */
+void *nss_shaper_register_shaper_bounce_bridge_list(uint32_t if_num, nss_shaper_bounced_list_callback_t cb, void *app_data, struct module *owner)
+{
+	return nss_shaper_bounce_register(if_num, true, NULL, cb, app_data, owner);
+}
+
+/*
+ * nss_shaper_unregister_shaper_bounce_bridge()
+ *	Unregister for shaper bounce operations for bridge shaper
+ */
+void nss_shaper_unregister_shaper_bounce_bridge(uint32_t if_num)
+{
+	nss_shaper_bounce_unregister(if_num, true);
 }
 
 /*
@@ -264,41 +330,16 @@ void nss_shaper_unregister_shaper_bounce_bridge(uint32_t if_num)
  */
 nss_tx_status_t nss_shaper_bounce_interface_packet(void *ctx, uint32_t if_num, struct sk_buff *skb)
 {
-	struct nss_ctx_instance *nss_ctx = (struct nss_ctx_instance *)ctx;
-	struct nss_top_instance *nss_top = nss_ctx->nss_top;
-	struct nss_shaper_bounce_registrant *reg;
-	int32_t status;
-
-	/*
-	 * Must be valid interface number
-	 */
-	if (if_num >= NSS_MAX_NET_INTERFACES) {
-		nss_warning("Invalid if_num: %u", if_num);
-		BUG_ON(false);
-	}
-
-
-	/*
-	 * Must have existing registrant
-	 */
-	spin_lock_bh(&nss_top->lock);
-	reg = &nss_top->bounce_interface_registrants[if_num];
-	if (!reg->registered) {
-		spin_unlock_bh(&nss_top->stats_lock);
-		nss_warning("unregistered: %u", if_num);
-		return NSS_TX_FAILURE;
-	}
-	spin_unlock_bh(&nss_top->lock);
-
-	status = nss_core_send_buffer(nss_ctx, if_num, skb, 0, H2N_BUFFER_SHAPER_BOUNCE_INTERFACE, 0);
-	if (status != NSS_CORE_STATUS_SUCCESS) {
-		return NSS_TX_FAILURE;
-	}
-	nss_hal_send_interrupt(nss_ctx->nmap, nss_ctx->h2n_desc_rings[NSS_IF_CMD_QUEUE].desc_ring.int_bit,
-								NSS_REGS_H2N_INTR_STATUS_DATA_COMMAND_QUEUE);
+	return nss_shaper_bounce_packet((struct nss_ctx_instance *)ctx, if_num, skb, false);
+}
 
-	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->nss_top->stats_drv[NSS_STATS_DRV_TX_CMD_REQ]);
-	return NSS_TX_SUCCESS;
+/*
+ * nss_shaper_bounce_interface_packets()
+ *	Bounce a list of packets to the NSS for interface shaping.
+ */
+nss_tx_status_t nss_shaper_bounce_interface_packets(void *ctx, uint32_t if_num, struct sk_buff_head *list)
+{
+	return nss_shaper_bounce_packets((struct nss_ctx_instance *)ctx, if_num, list, false);
 }
 
 /*
@@ -309,49 +350,27 @@ nss_tx_status_t nss_shaper_bounce_interface_packet(void *ctx, uint32_t if_num, s
  */
 nss_tx_status_t nss_shaper_bounce_bridge_packet(void *ctx, uint32_t if_num, struct sk_buff *skb)
 {
-	struct nss_ctx_instance *nss_ctx = (struct nss_ctx_instance *)ctx;
-	struct nss_top_instance *nss_top = nss_ctx->nss_top;
-	struct nss_shaper_bounce_registrant *reg;
-	int32_t status;
-
-	/*
-	 * Must be valid interface number
-	 */
-	if (if_num >= NSS_MAX_NET_INTERFACES) {
-		nss_warning("Invalid if_num: %u", if_num);
-		BUG_ON(false);
-	}
-
-	/*
-	 * Must have existing registrant
-	 */
-	spin_lock_bh(&nss_top->lock);
-	reg = &nss_top->bounce_bridge_registrants[if_num];
-	if (!reg->registered) {
-		spin_unlock_bh(&nss_top->stats_lock);
-		nss_warning("unregistered: %u", if_num);
-		return NSS_TX_FAILURE;
-	}
-	spin_unlock_bh(&nss_top->lock);
-
-	nss_info("%s: Bridge bounce skb: %p, if_num: %u, ctx: %p", __func__, skb, if_num, nss_ctx);
-	status = nss_core_send_buffer(nss_ctx, if_num, skb, NSS_IF_CMD_QUEUE, H2N_BUFFER_SHAPER_BOUNCE_BRIDGE, 0);
-	if (status != NSS_CORE_STATUS_SUCCESS) {
-		nss_info("%s: Bridge bounce core send rejected", __func__);
-		return NSS_TX_FAILURE;
-	}
-	nss_hal_send_interrupt(nss_ctx->nmap, nss_ctx->h2n_desc_rings[NSS_IF_CMD_QUEUE].desc_ring.int_bit,
-								NSS_REGS_H2N_INTR_STATUS_DATA_COMMAND_QUEUE);
+	return nss_shaper_bounce_packet((struct nss_ctx_instance *)ctx, if_num, skb, true);
+}
 
-	NSS_PKT_STATS_INCREMENT(nss_ctx, &nss_ctx->nss_top->stats_drv[NSS_STATS_DRV_TX_CMD_REQ]);
-	return NSS_TX_SUCCESS;
+/*
+ * nss_shaper_bounce_bridge_packets()
+ *	Bounce a list of packets to the NSS for bridge shaping.
+ */
+nss_tx_status_t nss_shaper_bounce_bridge_packets(void *ctx, uint32_t if_num, struct sk_buff_head *list)
+{
+	return nss_shaper_bounce_packets((struct nss_ctx_instance *)ctx, if_num, list, true);
 }
 
 EXPORT_SYMBOL(nss_shaper_bounce_bridge_packet);
+EXPORT_SYMBOL(nss_shaper_bounce_bridge_packets);
 EXPORT_SYMBOL(nss_shaper_bounce_interface_packet);
+EXPORT_SYMBOL(nss_shaper_bounce_interface_packets);
 EXPORT_SYMBOL(nss_shaper_unregister_shaper_bounce_interface);
 EXPORT_SYMBOL(nss_shaper_register_shaper_bounce_interface);
+EXPORT_SYMBOL(nss_shaper_register_shaper_bounce_interface_list);
 EXPORT_SYMBOL(nss_shaper_unregister_shaper_bounce_bridge);
 EXPORT_SYMBOL(nss_shaper_register_shaper_bounce_bridge);
+EXPORT_SYMBOL(nss_shaper_register_shaper_bounce_bridge_list);
 EXPORT_SYMBOL(nss_shaper_register_shaping);
 EXPORT_SYMBOL(nss_shaper_unregister_shaping);
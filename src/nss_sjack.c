@@ -28,11 +28,11 @@ static void nss_sjack_node_sync_update(struct nss_ctx_instance *nss_ctx, struct
 	 * Update SJACK node stats.
 	 */
 	spin_lock_bh(&nss_top->stats_lock);
-	nss_top->stats_node[NSS_SJACK_INTERFACE][NSS_STATS_NODE_RX_PKTS] += nins->node_stats.rx_packets;
-	nss_top->stats_node[NSS_SJACK_INTERFACE][NSS_STATS_NODE_RX_BYTES] += nins->node_stats.rx_bytes;
-	nss_top->stats_node[NSS_SJACK_INTERFACE][NSS_STATS_NODE_RX_DROPPED] += nins->node_stats.rx_dropped;
-	nss_top->stats_node[NSS_SJACK_INTERFACE][NSS_STATS_NODE_TX_PKTS] += nins->node_stats.tx_packets;
-	nss_top->stats_node[NSS_SJACK_INTERFACE][NSS_STATS_NODE_TX_BYTES] += nins->node_stats.tx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_SJACK_INTERFACE)][NSS_STATS_NODE_RX_PKTS] += nins->node_stats.rx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_SJACK_INTERFACE)][NSS_STATS_NODE_RX_BYTES] += nins->node_stats.rx_bytes;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_SJACK_INTERFACE)][NSS_STATS_NODE_RX_DROPPED] += nins->node_stats.rx_dropped;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_SJACK_INTERFACE)][NSS_STATS_NODE_TX_PKTS] += nins->node_stats.tx_packets;
+	nss_top->stats_node[NSS_STATS_NODE_IDX(NSS_SJACK_INTERFACE)][NSS_STATS_NODE_TX_BYTES] += nins->node_stats.tx_bytes;
 	spin_unlock_bh(&nss_top->stats_lock);
 }
 
@@ -67,7 +67,7 @@ static void nss_sjack_handler(struct nss_ctx_instance *nss_ctx, struct nss_cmn_m
 	 * to the same callback/app_data.
 	 */
 	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
-		ncm->cb = (uint32_t)nss_ctx->nss_top->if_rx_msg_callback[ncm->interface];
+		ncm->cb = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].if_rx_msg_cb;
 	}
 
 	/*
@@ -173,7 +173,7 @@ struct nss_ctx_instance *nss_sjack_register_if(uint32_t if_num, struct net_devic
 
 	nss_top_main.subsys_dp_register[if_num].ndev = netdev;
 
-	nss_top_main.if_rx_msg_callback[if_num] = event_callback;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = event_callback;
 
 	return (struct nss_ctx_instance *)&nss_top_main.nss[nss_top_main.sjack_handler_id];
 }
@@ -186,7 +186,7 @@ void nss_sjack_unregister_if(uint32_t if_num)
 	nss_assert(if_num == NSS_SJACK_INTERFACE);
 
 	nss_top_main.subsys_dp_register[if_num].ndev = NULL;
-	nss_top_main.if_rx_msg_callback[if_num] = NULL;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = NULL;
 
 	return;
 }
@@ -22,6 +22,8 @@
 
 #include "nss_core.h"
 #include "nss_dtls_stats.h"
+#include <nss_hal.h>
+#include <linux/vmalloc.h>
 
 /*
  * Maximum string length:
@@ -192,6 +194,19 @@ static int8_t *nss_stats_str_drv[NSS_STATS_DRV_MAX] = {
 	"rx_frag_seg_processed"
 };
 
+/*
+ * nss_stats_str_ipsec
+ *	IPsec host driver stats strings
+ */
+static int8_t *nss_stats_str_ipsec[NSS_STATS_IPSEC_MAX] = {
+	"encap_tx_packets",
+	"decap_tx_packets",
+	"tx_queue_full",
+	"tx_failed",
+	"tx_msg",
+	"rx_notify"
+};
+
 /*
  * nss_stats_str_pppoe
  *	PPPoE stats strings
@@ -614,7 +629,7 @@ static ssize_t nss_stats_ipv4_read(struct file *fp, char __user *ubuf, size_t sz
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_IPV4_RX_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_IPV4_RX_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -703,7 +718,7 @@ static ssize_t nss_stats_ipv4_reasm_read(struct file *fp, char __user *ubuf, siz
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_IPV4_REASM_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_IPV4_REASM_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -779,7 +794,7 @@ static ssize_t nss_stats_ipv6_read(struct file *fp, char __user *ubuf, size_t sz
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_IPV6_RX_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_RX_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -868,7 +883,7 @@ static ssize_t nss_stats_ipv6_reasm_read(struct file *fp, char __user *ubuf, siz
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_IPV6_REASM_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_IPV6_REASM_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -944,7 +959,7 @@ static ssize_t nss_stats_eth_rx_read(struct file *fp, char __user *ubuf, size_t
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_ETH_RX_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_ETH_RX_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -1106,7 +1121,7 @@ static ssize_t nss_stats_lso_rx_read(struct file *fp, char __user *ubuf, size_t
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_LSO_RX_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_LSO_RX_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -1188,6 +1203,50 @@ static ssize_t nss_stats_drv_read(struct file *fp, char __user *ubuf, size_t sz,
 	return bytes_read;
 }
 
+/*
+ * nss_stats_ipsec_read()
+ *	Read IPsec stats of every core running IPsec
+ */
+static ssize_t nss_stats_ipsec_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	int32_t i, core;
+
+	/*
+	 * max output lines = (#stats + core line + blank line) per core + start tag line + end tag line + three blank lines
+	 */
+	uint32_t max_output_lines = NSS_MAX_CORES * (NSS_STATS_IPSEC_MAX + 2) + 5;
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+
+	char *lbuf = kzalloc(size_al, GFP_KERNEL);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	size_wr = scnprintf(lbuf, size_al, "ipsec stats start:\n\n");
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		if (!(nss_top_main.ipsec_cores & (1 << core))) {
+			continue;
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "core %d:\n", core);
+		for (i = 0; (i < NSS_STATS_IPSEC_MAX); i++) {
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%s = %llu\n", nss_stats_str_ipsec[i],
+						(uint64_t)NSS_PKT_STATS_READ(&nss_top_main.nss[core].stats_ipsec[i]));
+		}
+
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+	}
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "ipsec stats end\n\n");
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, strlen(lbuf));
+	kfree(lbuf);
+
+	return bytes_read;
+}
+
 /*
  * nss_stats_pppoe_read()
  *	Read PPPoE stats
@@ -1227,7 +1286,7 @@ static ssize_t nss_stats_pppoe_read(struct file *fp, char __user *ubuf, size_t s
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_PPPOE_RX_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_PPPOE_RX_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -1403,20 +1462,22 @@ static ssize_t nss_stats_wifi_read(struct file *fp, char __user *ubuf, size_t sz
 }
 
 /*
- * nss_stats_dtls_read()
- * 	Read DTLS session statistics
+ * nss_stats_session_read()
+ *	Print the sessions of one tunnel type held in the session stats store
  */
-static ssize_t nss_stats_dtls_read(struct file *fp, char __user *ubuf,
-				   size_t sz, loff_t *ppos)
+static ssize_t nss_stats_session_read(char __user *ubuf, size_t sz, loff_t *ppos, enum nss_session_stats_type type,
+				      const char *title, int8_t **stats_str, uint32_t stats_num, uint32_t max_sessions)
 {
-	uint32_t max_output_lines = 2 + (NSS_MAX_DTLS_SESSIONS
-					* (NSS_STATS_DTLS_SESSION_MAX + 2)) + 2;
+	uint32_t max_output_lines = 2 /* header & footer for session stats */
+					+ max_sessions * (stats_num + 2) /* session stats */
+					+ 2;
 	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines;
 	size_t size_wr = 0;
 	ssize_t bytes_read = 0;
 	struct net_device *dev;
-	int id, i;
-	struct nss_stats_dtls_session_debug *dtls_session_stats = NULL;
+	uint64_t *stats;
+	int32_t if_index;
+	uint32_t if_num, id = 0, i;
 
 	char *lbuf = kzalloc(size_al, GFP_KERNEL);
 	if (unlikely(lbuf == NULL)) {
@@ -1424,77 +1485,68 @@ static ssize_t nss_stats_dtls_read(struct file *fp, char __user *ubuf,
 		return 0;
 	}
 
-	dtls_session_stats = kzalloc((sizeof(struct nss_stats_dtls_session_debug)
-				     * NSS_MAX_DTLS_SESSIONS), GFP_KERNEL);
-	if (unlikely(dtls_session_stats == NULL)) {
-		nss_warning("Could not allocate memory for populating DTLS stats");
+	stats = kzalloc(stats_num * sizeof(uint64_t), GFP_KERNEL);
+	if (unlikely(stats == NULL)) {
+		nss_warning("Could not allocate memory for populating %s stats", title);
 		kfree(lbuf);
 		return 0;
 	}
 
-	/*
-	 * Get all stats
-	 */
-	nss_dtls_session_debug_stats_get(dtls_session_stats);
-
-	/*
-	 * Session stats
-	 */
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-			     "\nDTLS session stats start:\n\n");
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n%s stats start:\n\n", title);
 
-	for (id = 0; id < NSS_MAX_DTLS_SESSIONS; id++) {
-		if (!dtls_session_stats[id].valid)
-			break;
+	for (if_num = NSS_DYNAMIC_IF_START; (if_num < NSS_DYNAMIC_IF_START + NSS_MAX_DYNAMIC_INTERFACES) && (id < max_sessions); if_num++) {
+		if (!nss_session_stats_read(type, if_num, &if_index, stats)) {
+			continue;
+		}
 
-		dev = dev_get_by_index(&init_net, dtls_session_stats[id].if_index);
+		dev = dev_get_by_index(&init_net, if_index);
 		if (likely(dev)) {
-			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-					     "%d. nss interface id=%d, netdevice=%s\n",
-					     id, dtls_session_stats[id].if_num,
-					     dev->name);
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%u. nss interface id=%u, netdevice=%s\n", id,
+					if_num, dev->name);
 			dev_put(dev);
 		} else {
-			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-					     "%d. nss interface id=%d\n", id,
-					     dtls_session_stats[id].if_num);
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%u. nss interface id=%u\n", id, if_num);
 		}
 
-		for (i = 0; i < NSS_STATS_DTLS_SESSION_MAX; i++) {
+		for (i = 0; i < stats_num; i++) {
 			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-					     "\t%s = %llu\n",
-					     nss_stats_str_dtls_session_debug_stats[i],
-					     dtls_session_stats[id].stats[i]);
+					     "\t%s = %llu\n", stats_str[i], stats[i]);
 		}
-
 		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+		id++;
 	}
 
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-			     "\nDTLS session stats end\n");
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n%s stats end\n", title);
 	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
 
-	kfree(dtls_session_stats);
+	kfree(stats);
 	kfree(lbuf);
 	return bytes_read;
 }
 
 /*
- * nss_stats_l2tpv2_read()
- *	Read l2tpv2 statistics
+ * nss_stats_dtls_read()
+ *	Read DTLS session statistics
  */
-static ssize_t nss_stats_l2tpv2_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+static ssize_t nss_stats_dtls_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
 {
+	return nss_stats_session_read(ubuf, sz, ppos, NSS_SESSION_STATS_TYPE_DTLS, "DTLS session",
+				      nss_stats_str_dtls_session_debug_stats, NSS_STATS_DTLS_SESSION_MAX, NSS_MAX_DTLS_SESSIONS);
+}
 
-	uint32_t max_output_lines = 2 /* header & footer for session stats */
-					+ NSS_MAX_L2TPV2_DYNAMIC_INTERFACES * (NSS_STATS_L2TPV2_SESSION_MAX + 2) /*session stats */
-					+ 2;
-	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines ;
+/*
+ * nss_stats_rings_read()
+ *	Read the H2N/N2H descriptor ring state of every core
+ */
+static ssize_t nss_stats_rings_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	uint32_t max_output_lines = NSS_MAX_CORES * (16 + NSS_N2H_DESC_RING_NUM + 4);
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines;
 	size_t size_wr = 0;
 	ssize_t bytes_read = 0;
-	struct net_device *dev;
-	struct nss_stats_l2tpv2_session_debug l2tpv2_session_stats[NSS_MAX_L2TPV2_DYNAMIC_INTERFACES];
-	int id, i;
+	struct nss_ctx_instance *nss_ctx;
+	struct nss_if_mem_map *if_map;
+	uint32_t core, i, nss_index, hlos_index, size, h2n_rings, n2h_rings;
 
 	char *lbuf = kzalloc(size_al, GFP_KERNEL);
 	if (unlikely(lbuf == NULL)) {
@@ -1502,181 +1554,316 @@ static ssize_t nss_stats_l2tpv2_read(struct file *fp, char __user *ubuf, size_t
 		return 0;
 	}
 
-	memset(&l2tpv2_session_stats, 0, sizeof(struct nss_stats_l2tpv2_session_debug) * NSS_MAX_L2TPV2_DYNAMIC_INTERFACES);
-
-	/*
-	 * Get all stats
-	 */
-	nss_l2tpv2_session_debug_stats_get((void *)&l2tpv2_session_stats);
+	size_wr = scnprintf(lbuf, size_al, "rings stats start:\n\n");
 
-	/*
-	 * Session stats
-	 */
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\nl2tp v2 session stats start:\n\n");
-	for (id = 0; id < NSS_MAX_L2TPV2_DYNAMIC_INTERFACES; id++) {
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		nss_ctx = &nss_top_main.nss[core];
+		if (nss_ctx->state != NSS_CORE_STATE_INITIALIZED) {
+			continue;
+		}
 
-			if (!l2tpv2_session_stats[id].valid) {
-				break;
-			}
+		/*
+		 * The ring counts come from firmware shared memory; never index
+		 * past the rings the driver has
+		 */
+		if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
+		h2n_rings = min_t(uint32_t, if_map->h2n_rings, NSS_H2N_DESC_RING_NUM);
+		n2h_rings = min_t(uint32_t, if_map->n2h_rings, NSS_N2H_DESC_RING_NUM);
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "core %u:\n", core);
+
+		for (i = 0; i < h2n_rings; i++) {
+			struct hlos_h2n_desc_rings *h2n_desc_ring = &nss_ctx->h2n_desc_rings[i];
+
+			spin_lock_bh(&h2n_desc_ring->lock);
+			nss_index = if_map->h2n_nss_index[i];
+			hlos_index = h2n_desc_ring->hlos_index;
+			size = h2n_desc_ring->desc_ring.size;
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+					"\th2n%u: size = %u nss_index = %u hlos_index = %u free = %u q_full = %llu%s\n",
+					i, size, nss_index, hlos_index,
+					nss_core_h2n_ring_free(nss_index, hlos_index, size),
+					h2n_desc_ring->tx_q_full_cnt,
+					(h2n_desc_ring->flags & NSS_H2N_DESC_RING_FLAGS_TX_STOPPED) ? " stopped" : "");
+			spin_unlock_bh(&h2n_desc_ring->lock);
+		}
 
-			dev = dev_get_by_index(&init_net, l2tpv2_session_stats[id].if_index);
-			if (likely(dev)) {
+		for (i = 0; i < n2h_rings; i++) {
+			struct hlos_n2h_desc_ring *n2h_desc_ring = &nss_ctx->n2h_desc_ring[i];
 
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%d. nss interface id=%d, netdevice=%s\n", id,
-						l2tpv2_session_stats[id].if_num, dev->name);
-				dev_put(dev);
-			} else {
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%d. nss interface id=%d\n", id,
-						l2tpv2_session_stats[id].if_num);
-			}
+			nss_index = if_map->n2h_nss_index[i];
+			hlos_index = n2h_desc_ring->hlos_index;
+			size = n2h_desc_ring->desc_if.size;
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+					"\tn2h%u: size = %u nss_index = %u hlos_index = %u pending = %u\n",
+					i, size, nss_index, hlos_index,
+					nss_core_n2h_ring_pending(nss_index, hlos_index, size));
+		}
 
-			for (i = 0; i < NSS_STATS_L2TPV2_SESSION_MAX; i++) {
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-						     "\t%s = %llu\n", nss_stats_str_l2tpv2_session_debug_stats[i],
-						      l2tpv2_session_stats[id].stats[i]);
-			}
-			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
 	}
 
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\nl2tp v2 session stats end\n");
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "rings stats end\n");
 	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
-
 	kfree(lbuf);
+
 	return bytes_read;
 }
 
 /*
- * nss_stats_map_t_read()
- *	Read map_t statistics
+ * nss_stats_napi_cause_name()
+ *	Name of an N2H interrupt cause bit
  */
-static ssize_t nss_stats_map_t_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+static const char *nss_stats_napi_cause_name(uint32_t bit)
 {
+	switch (1 << bit) {
+	case NSS_REGS_N2H_INTR_STATUS_EMPTY_BUFFER_QUEUE:
+		return "empty_buffer_queue";
+	case NSS_REGS_N2H_INTR_STATUS_DATA_COMMAND_QUEUE:
+		return "data_command_queue";
+	case NSS_REGS_N2H_INTR_STATUS_DATA_QUEUE_1:
+		return "data_queue_1";
+	case NSS_REGS_N2H_INTR_STATUS_EMPTY_BUFFERS_SOS:
+		return "empty_buffers_sos";
+	case NSS_REGS_N2H_INTR_STATUS_TX_UNBLOCKED:
+		return "tx_unblocked";
+	case NSS_REGS_N2H_INTR_STATUS_COREDUMP_COMPLETE_0:
+		return "coredump_complete_0";
+	case NSS_REGS_N2H_INTR_STATUS_COREDUMP_COMPLETE_1:
+		return "coredump_complete_1";
+	}
+
+	return "unknown";
+}
 
-	uint32_t max_output_lines = 2 /* header & footer for instance stats */
-					+ NSS_MAX_MAP_T_DYNAMIC_INTERFACES * (NSS_STATS_MAP_T_MAX + 2) /*instance stats */
-					+ 2;
-	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines;
+/*
+ * nss_stats_napi_print_hist()
+ *	Print a log2 histogram on one line, bucket n holds values below 2^n
+ */
+static size_t nss_stats_napi_print_hist(char *lbuf, size_t size_al, const char *name, uint32_t idx, uint64_t *hist, uint32_t buckets)
+{
+	size_t size_wr;
+	uint32_t i;
+
+	size_wr = scnprintf(lbuf, size_al, "\t%s%u:", name, idx);
+	for (i = 0; i < buckets; i++) {
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, " %llu", hist[i]);
+	}
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+	return size_wr;
+}
+
+/*
+ * nss_stats_napi_read()
+ *	Read the NAPI poll statistics of every core and IRQ
+ */
+static ssize_t nss_stats_napi_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	uint32_t max_output_lines = NSS_MAX_CORES * 2 * (10 + NSS_NAPI_STATS_CAUSES
+					+ NSS_N2H_DESC_RING_NUM + NSS_H2N_DESC_RING_NUM) + 4;
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * 3 * max_output_lines;
 	size_t size_wr = 0;
 	ssize_t bytes_read = 0;
-	struct net_device *dev;
-	struct nss_stats_map_t_instance_debug map_t_instance_stats[NSS_MAX_MAP_T_DYNAMIC_INTERFACES];
-	int id, i;
+	struct nss_ctx_instance *nss_ctx;
+	struct nss_if_mem_map *if_map;
+	struct nss_napi_stats *ns;
+	uint32_t core, irq, i;
 
-	char *lbuf = kzalloc(size_al, GFP_KERNEL);
-	if (unlikely(!lbuf)) {
+	char *lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
 		nss_warning("Could not allocate memory for local statistics buffer");
 		return 0;
 	}
 
-	memset(&map_t_instance_stats, 0, sizeof(struct nss_stats_map_t_instance_debug) * NSS_MAX_MAP_T_DYNAMIC_INTERFACES);
+	size_wr = scnprintf(lbuf, size_al, "napi stats start: %s (dev/nss/general/napi_stats)\n"
+			"histograms use log2 buckets: 0, 1, 2-3, 4-7, ... last bucket is open ended\n\n",
+			nss_core_napi_stats_enable ? "enabled" : "disabled");
 
-	/*
-	 * Get all stats
-	 */
-	nss_map_t_instance_debug_stats_get((void *)&map_t_instance_stats);
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		nss_ctx = &nss_top_main.nss[core];
+		if (nss_ctx->state != NSS_CORE_STATE_INITIALIZED) {
+			continue;
+		}
 
-	/*
-	 * Session stats
-	 */
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\nmap_t instance stats start:\n\n");
-	for (id = 0; id < NSS_MAX_MAP_T_DYNAMIC_INTERFACES; id++) {
+		if_map = (struct nss_if_mem_map *)nss_ctx->vmap;
 
-			if (!map_t_instance_stats[id].valid) {
-				break;
+		for (irq = 0; irq < ARRAY_SIZE(nss_ctx->int_ctx); irq++) {
+			ns = &nss_ctx->int_ctx[irq].napi_stats;
+			if (!ns->polls) {
+				continue;
 			}
 
-			dev = dev_get_by_index(&init_net, map_t_instance_stats[id].if_index);
-			if (likely(dev)) {
+			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+					"core %u irq %u:\n\tpolls = %llu work = %llu budget = %llu budget_exhausted = %llu\n",
+					core, irq, ns->polls, ns->work, ns->budget, ns->budget_exhausted);
+			size_wr += nss_stats_napi_print_hist(lbuf + size_wr, size_al - size_wr, "work", 0,
+					ns->work_hist, NSS_NAPI_STATS_WORK_BUCKETS);
 
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%d. nss interface id=%d, netdevice=%s\n", id,
-						map_t_instance_stats[id].if_num, dev->name);
-				dev_put(dev);
-			} else {
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%d. nss interface id=%d\n", id,
-						map_t_instance_stats[id].if_num);
-			}
+			for (i = 0; i < NSS_NAPI_STATS_CAUSES; i++) {
+				if (!ns->cause_count[i]) {
+					continue;
+				}
 
-			for (i = 0; i < NSS_STATS_MAP_T_MAX; i++) {
 				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-						     "\t%s = %llu\n", nss_stats_str_map_t_instance_debug_stats[i],
-						      map_t_instance_stats[id].stats[i]);
+						"\tcause %s: count = %llu time_ns = %llu avg_ns = %llu\n",
+						nss_stats_napi_cause_name(i), ns->cause_count[i], ns->cause_ns[i],
+						div64_u64(ns->cause_ns[i], ns->cause_count[i]));
+			}
+
+			for (i = 0; i < if_map->n2h_rings && i < NSS_N2H_DESC_RING_NUM; i++) {
+				size_wr += nss_stats_napi_print_hist(lbuf + size_wr, size_al - size_wr, "n2h", i,
+						ns->n2h_occ_hist[i], NSS_NAPI_STATS_OCC_BUCKETS);
+			}
+
+			for (i = 0; i < if_map->h2n_rings && i < NSS_H2N_DESC_RING_NUM; i++) {
+				size_wr += nss_stats_napi_print_hist(lbuf + size_wr, size_al - size_wr, "h2n", i,
+						ns->h2n_occ_hist[i], NSS_NAPI_STATS_OCC_BUCKETS);
 			}
+
 			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+		}
 	}
 
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\nmap_t instance stats end\n");
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "napi stats end\n");
 	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
 
-	kfree(lbuf);
 	return bytes_read;
 }
 
 /*
- * nss_stats_pptp_read()
- *	Read pptp statistics
+ * nss_stats_gro_read()
+ *	Read the GRO statistics of exception packets per interface
  */
-static ssize_t nss_stats_pptp_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+static ssize_t nss_stats_gro_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
 {
-
-	uint32_t max_output_lines = 2 /* header & footer for session stats */
-					+ NSS_MAX_PPTP_DYNAMIC_INTERFACES * (NSS_STATS_PPTP_SESSION_MAX + 2) /*session stats */
-					+ 2;
-	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines ;
+	uint32_t max_output_lines = NSS_MAX_DYNAMIC_INTERFACES + NSS_MAX_VIRTUAL_INTERFACES + 4;
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * 2 * max_output_lines;
 	size_t size_wr = 0;
 	ssize_t bytes_read = 0;
-	struct net_device *dev;
-	struct nss_stats_pptp_session_debug pptp_session_stats[NSS_MAX_PPTP_DYNAMIC_INTERFACES];
-	int id, i;
+	struct nss_if_cold *cold;
+	struct nss_gro_stats *gs;
+	struct net_device *ndev;
+	uint64_t rx_packets;
+	uint32_t if_num;
 
-	char *lbuf = kzalloc(size_al, GFP_KERNEL);
+	char *lbuf = vzalloc(size_al);
 	if (unlikely(lbuf == NULL)) {
 		nss_warning("Could not allocate memory for local statistics buffer");
 		return 0;
 	}
 
-	memset(&pptp_session_stats, 0, sizeof(struct nss_stats_pptp_session_debug) * NSS_MAX_PPTP_DYNAMIC_INTERFACES);
+	size_wr = scnprintf(lbuf, size_al, "gro stats start:\n\n");
 
-	/*
-	 * Get all stats
-	 */
-	nss_pptp_session_debug_stats_get((void *)&pptp_session_stats);
+	for (if_num = 0; if_num < NSS_MAX_NET_INTERFACES; if_num++) {
+		cold = nss_core_if_cold(&nss_top_main, if_num);
+		if (!cold) {
+			continue;
+		}
 
-	/*
-	 * Session stats
-	 */
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\npptp session stats start:\n\n");
-	for (id = 0; id < NSS_MAX_PPTP_DYNAMIC_INTERFACES; id++) {
+		gs = &cold->gro_stats;
+		rx_packets = atomic64_read(&gs->rx_packets);
+		if (!rx_packets) {
+			continue;
+		}
 
-			if (!pptp_session_stats[id].valid) {
-				break;
-			}
+		ndev = nss_top_main.subsys_dp_register[if_num].ndev;
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"%u %s: rx_packets = %llu merged = %llu held = %llu normal = %llu dropped = %llu csum_none = %llu\n",
+				if_num, ndev ? ndev->name : "-", rx_packets,
+				(uint64_t)atomic64_read(&gs->merged), (uint64_t)atomic64_read(&gs->held),
+				(uint64_t)atomic64_read(&gs->normal), (uint64_t)atomic64_read(&gs->dropped),
+				(uint64_t)atomic64_read(&gs->csum_none));
+	}
 
-			dev = dev_get_by_index(&init_net, pptp_session_stats[id].if_index);
-			if (likely(dev)) {
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\ngro stats end\n");
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
 
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%d. nss interface id=%d, netdevice=%s\n", id,
-						pptp_session_stats[id].if_num, dev->name);
-				dev_put(dev);
-			} else {
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "%d. nss interface id=%d\n", id,
-						pptp_session_stats[id].if_num);
-			}
+	return bytes_read;
+}
 
-			for (i = 0; i < NSS_STATS_PPTP_SESSION_MAX; i++) {
-				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
-						     "\t%s = %llu\n", nss_stats_str_pptp_session_debug_stats[i],
-						      pptp_session_stats[id].stats[i]);
-			}
-			size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\n");
+/*
+ * nss_stats_virt_if_egress_read()
+ *	Read the virtual interface egress backlog statistics per interface
+ */
+static ssize_t nss_stats_virt_if_egress_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	uint32_t max_output_lines = NSS_MAX_DYNAMIC_INTERFACES + NSS_MAX_VIRTUAL_INTERFACES + 4;
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * 2 * max_output_lines;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	struct nss_if_cold *cold;
+	struct nss_virt_if_egress *egress;
+	struct net_device *ndev;
+	uint32_t if_num;
+
+	char *lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	size_wr = scnprintf(lbuf, size_al, "virt_if egress stats start:\n\nlimit = %d max_age_ms = %d\n\n",
+				nss_core_virt_if_egress_limit, nss_core_virt_if_egress_max_age_ms);
+
+	for (if_num = 0; if_num < NSS_MAX_NET_INTERFACES; if_num++) {
+		cold = nss_core_if_cold(&nss_top_main, if_num);
+		if (!cold) {
+			continue;
+		}
+
+		egress = &cold->egress;
+		if (!atomic64_read(&egress->queued) && !atomic64_read(&egress->busy)) {
+			continue;
+		}
+
+		ndev = nss_top_main.subsys_dp_register[if_num].ndev;
+		size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"%u %s: depth = %u max_depth = %u queued = %llu sent = %llu busy = %llu dropped_full = %llu dropped_nodev = %llu dropped_aged = %llu\n",
+				if_num, ndev ? ndev->name : "-", skb_queue_len(&egress->q), egress->max_depth,
+				atomic64_read(&egress->queued), atomic64_read(&egress->sent), atomic64_read(&egress->busy),
+				atomic64_read(&egress->dropped_full), atomic64_read(&egress->dropped_nodev),
+				atomic64_read(&egress->dropped_aged));
 	}
 
-	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\npptp session stats end\n");
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "\nvirt_if egress stats end\n");
 	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
 
-	kfree(lbuf);
 	return bytes_read;
 }
 
+/*
+ * nss_stats_l2tpv2_read()
+ *	Read l2tpv2 statistics
+ */
+static ssize_t nss_stats_l2tpv2_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	return nss_stats_session_read(ubuf, sz, ppos, NSS_SESSION_STATS_TYPE_L2TPV2, "l2tp v2 session",
+				      nss_stats_str_l2tpv2_session_debug_stats, NSS_STATS_L2TPV2_SESSION_MAX, NSS_MAX_L2TPV2_DYNAMIC_INTERFACES);
+}
+
+/*
+ * nss_stats_map_t_read()
+ *	Read map_t statistics
+ */
+static ssize_t nss_stats_map_t_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	return nss_stats_session_read(ubuf, sz, ppos, NSS_SESSION_STATS_TYPE_MAP_T, "map_t instance",
+				      nss_stats_str_map_t_instance_debug_stats, NSS_STATS_MAP_T_MAX, NSS_MAX_MAP_T_DYNAMIC_INTERFACES);
+}
+
+/*
+ * nss_stats_pptp_read()
+ *	Read pptp statistics
+ */
+static ssize_t nss_stats_pptp_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	return nss_stats_session_read(ubuf, sz, ppos, NSS_SESSION_STATS_TYPE_PPTP, "pptp session",
+				      nss_stats_str_pptp_session_debug_stats, NSS_STATS_PPTP_SESSION_MAX, NSS_MAX_PPTP_DYNAMIC_INTERFACES);
+}
+
 /*
  * nss_stats_sjack_read()
  *	Read SJACK stats
@@ -1714,7 +1901,7 @@ static ssize_t nss_stats_sjack_read(struct file *fp, char __user *ubuf, size_t s
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_SJACK_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_SJACK_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -1770,7 +1957,7 @@ static ssize_t nss_stats_portid_read(struct file *fp, char __user *ubuf, size_t
 	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr, "common node stats:\n\n");
 	spin_lock_bh(&nss_top_main.stats_lock);
 	for (i = 0; (i < NSS_STATS_NODE_MAX); i++) {
-		stats_shadow[i] = nss_top_main.stats_node[NSS_PORTID_INTERFACE][i];
+		stats_shadow[i] = nss_top_main.stats_node[NSS_STATS_NODE_IDX(NSS_PORTID_INTERFACE)][i];
 	}
 
 	spin_unlock_bh(&nss_top_main.stats_lock);
@@ -2411,73 +2598,894 @@ static int nss_stats_release(struct inode *inode, struct file *filp)
 	return 0;
 }
 
-#define NSS_STATS_DECLARE_FILE_OPERATIONS(name) \
-static const struct file_operations nss_stats_##name##_ops = { \
-	.open = nss_stats_open, \
-	.read = nss_stats_##name##_read, \
-	.llseek = generic_file_llseek, \
-	.release = nss_stats_release, \
-};
-
 /*
- * nss_ipv4_stats_ops
+ **********************************
+ Binary statistics export
+ **********************************
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(ipv4)
 
 /*
- * ipv4_reasm_stats_ops
+ * nss_stats_bin_fill_t
+ *	Copies one group of counters into the binary snapshot, called with stats_lock held.
+ *
+ * out points at the row of the group's first_instance.
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(ipv4_reasm)
+typedef void (*nss_stats_bin_fill_t)(uint64_t *out);
 
 /*
- * ipv6_stats_ops
- */
-NSS_STATS_DECLARE_FILE_OPERATIONS(ipv6)
+ * nss_stats_bin_group
+ *	Describes one group of counters in the binary snapshot
+ *
+ * A group contains num_instances rows of num_stats counters each. Session
+ * groups carry the NSS interface number of the row as an extra first column.
+ * Rows before first_instance never hold counters; the snapshot keeps them
+ * as zeros and the rate sampler leaves them out.
+ */
+struct nss_stats_bin_group {
+	char *name;			/* Group name used in the schema */
+	int8_t **strings;		/* Counter names */
+	uint32_t num_stats;		/* Number of counters per instance */
+	uint32_t num_instances;		/* Number of instances */
+	bool has_if_num;		/* First column of each row is the interface number */
+	nss_stats_bin_fill_t fill;	/* Snapshot function */
+	uint32_t first_instance;	/* First instance that holds counters */
+};
 
 /*
- * ipv6_reasm_stats_ops
+ * nss_stats_bin_fill_drv()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(ipv6_reasm)
+static void nss_stats_bin_fill_drv(uint64_t *out)
+{
+	int32_t i;
+
+	for (i = 0; i < NSS_STATS_DRV_MAX; i++) {
+		out[i] = NSS_PKT_STATS_READ(&nss_top_main.stats_drv[i]);
+	}
+}
 
 /*
- * n2h_stats_ops
+ * nss_stats_bin_fill_node()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(n2h)
+static void nss_stats_bin_fill_node(uint64_t *out)
+{
+	/*
+	 * Only special interfaces keep node statistics; the group starts at them
+	 */
+	memcpy(out, nss_top_main.stats_node, sizeof(nss_top_main.stats_node));
+}
 
 /*
- * lso_rx_stats_ops
+ * nss_stats_bin_fill_ipv4()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(lso_rx)
+static void nss_stats_bin_fill_ipv4(uint64_t *out)
+{
+	memcpy(out, nss_top_main.stats_ipv4, sizeof(nss_top_main.stats_ipv4));
+}
 
 /*
- * drv_stats_ops
+ * nss_stats_bin_fill_ipv4_exception()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(drv)
+static void nss_stats_bin_fill_ipv4_exception(uint64_t *out)
+{
+	memcpy(out, nss_top_main.stats_if_exception_ipv4, sizeof(nss_top_main.stats_if_exception_ipv4));
+}
 
 /*
- * pppoe_stats_ops
+ * nss_stats_bin_fill_ipv6()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(pppoe)
+static void nss_stats_bin_fill_ipv6(uint64_t *out)
+{
+	memcpy(out, nss_top_main.stats_ipv6, sizeof(nss_top_main.stats_ipv6));
+}
 
 /*
- * l2tpv2_stats_ops
+ * nss_stats_bin_fill_ipv6_exception()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(l2tpv2)
+static void nss_stats_bin_fill_ipv6_exception(uint64_t *out)
+{
+	memcpy(out, nss_top_main.stats_if_exception_ipv6, sizeof(nss_top_main.stats_if_exception_ipv6));
+}
 
 /*
- * map_t_stats_ops
+ * nss_stats_bin_fill_n2h()
+ *	N2H stats of every core; the node stats part is skipped as it is exported with the node group.
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(map_t)
+static void nss_stats_bin_fill_n2h(uint64_t *out)
+{
+	int32_t core;
+	int max = NSS_STATS_N2H_MAX - NSS_STATS_NODE_MAX;
+
+	for (core = 0; core < NSS_MAX_CORES; core++) {
+		memcpy(out + (core * max), &nss_top_main.nss[core].stats_n2h[NSS_STATS_NODE_MAX], max * sizeof(uint64_t));
+	}
+}
 
 /*
- * pptp_stats_ops
+ * nss_stats_bin_fill_gmac()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(pptp)
+static void nss_stats_bin_fill_gmac(uint64_t *out)
+{
+	memcpy(out, nss_top_main.stats_gmac, sizeof(nss_top_main.stats_gmac));
+}
 
 /*
- * gmac_stats_ops
+ * nss_stats_bin_fill_wifi()
  */
-NSS_STATS_DECLARE_FILE_OPERATIONS(gmac)
+static void nss_stats_bin_fill_wifi(uint64_t *out)
+{
+	memcpy(out, nss_top_main.stats_wifi, sizeof(nss_top_main.stats_wifi));
+}
+
+/*
+ * nss_stats_bin_fill_session()
+ *	Fill a session group with [if_num, stats...] per session
+ */
+static void nss_stats_bin_fill_session(enum nss_session_stats_type type, uint32_t stats_num, uint32_t max_sessions, uint64_t *out)
+{
+	uint32_t if_num, id = 0;
+	int32_t if_index;
+
+	for (if_num = NSS_DYNAMIC_IF_START; (if_num < NSS_DYNAMIC_IF_START + NSS_MAX_DYNAMIC_INTERFACES) && (id < max_sessions); if_num++) {
+		if (!nss_session_stats_read(type, if_num, &if_index, &out[1])) {
+			continue;
+		}
+
+		out[0] = if_num;
+		out += stats_num + 1;
+		id++;
+	}
+}
+
+/*
+ * nss_stats_bin_fill_l2tpv2()
+ */
+static void nss_stats_bin_fill_l2tpv2(uint64_t *out)
+{
+	nss_stats_bin_fill_session(NSS_SESSION_STATS_TYPE_L2TPV2, NSS_STATS_L2TPV2_SESSION_MAX, NSS_MAX_L2TPV2_DYNAMIC_INTERFACES, out);
+}
+
+/*
+ * nss_stats_bin_fill_pptp()
+ */
+static void nss_stats_bin_fill_pptp(uint64_t *out)
+{
+	nss_stats_bin_fill_session(NSS_SESSION_STATS_TYPE_PPTP, NSS_STATS_PPTP_SESSION_MAX, NSS_MAX_PPTP_DYNAMIC_INTERFACES, out);
+}
+
+/*
+ * nss_stats_bin_fill_map_t()
+ */
+static void nss_stats_bin_fill_map_t(uint64_t *out)
+{
+	nss_stats_bin_fill_session(NSS_SESSION_STATS_TYPE_MAP_T, NSS_STATS_MAP_T_MAX, NSS_MAX_MAP_T_DYNAMIC_INTERFACES, out);
+}
+
+/*
+ * nss_stats_bin_fill_dtls()
+ */
+static void nss_stats_bin_fill_dtls(uint64_t *out)
+{
+	nss_stats_bin_fill_session(NSS_SESSION_STATS_TYPE_DTLS, NSS_STATS_DTLS_SESSION_MAX, NSS_MAX_DTLS_SESSIONS, out);
+}
+
+/*
+ * nss_stats_bin_groups
+ *	Layout of the binary snapshot. Groups appear in the snapshot in this order.
+ *
+ * WARNING: Changing this table changes the binary layout; bump NSS_STATS_BIN_VERSION.
+ */
+static struct nss_stats_bin_group nss_stats_bin_groups[] = {
+	{"drv", nss_stats_str_drv, NSS_STATS_DRV_MAX, 1, false, nss_stats_bin_fill_drv},
+	{"node", nss_stats_str_node, NSS_STATS_NODE_MAX, NSS_MAX_NET_INTERFACES, false, nss_stats_bin_fill_node, NSS_SPECIAL_IF_START},
+	{"ipv4", nss_stats_str_ipv4, NSS_STATS_IPV4_MAX, 1, false, nss_stats_bin_fill_ipv4},
+	{"ipv4_exception", nss_stats_str_if_exception_ipv4, NSS_EXCEPTION_EVENT_IPV4_MAX, 1, false, nss_stats_bin_fill_ipv4_exception},
+	{"ipv6", nss_stats_str_ipv6, NSS_STATS_IPV6_MAX, 1, false, nss_stats_bin_fill_ipv6},
+	{"ipv6_exception", nss_stats_str_if_exception_ipv6, NSS_EXCEPTION_EVENT_IPV6_MAX, 1, false, nss_stats_bin_fill_ipv6_exception},
+	{"n2h", nss_stats_str_n2h, NSS_STATS_N2H_MAX - NSS_STATS_NODE_MAX, NSS_MAX_CORES, false, nss_stats_bin_fill_n2h},
+	{"gmac", nss_stats_str_gmac, NSS_STATS_GMAC_MAX, NSS_MAX_PHYSICAL_INTERFACES, false, nss_stats_bin_fill_gmac},
+	{"wifi", nss_stats_str_wifi, NSS_STATS_WIFI_MAX, NSS_MAX_WIFI_RADIO_INTERFACES, false, nss_stats_bin_fill_wifi},
+	{"l2tpv2_session", nss_stats_str_l2tpv2_session_debug_stats, NSS_STATS_L2TPV2_SESSION_MAX, NSS_MAX_L2TPV2_DYNAMIC_INTERFACES, true, nss_stats_bin_fill_l2tpv2},
+	{"pptp_session", nss_stats_str_pptp_session_debug_stats, NSS_STATS_PPTP_SESSION_MAX, NSS_MAX_PPTP_DYNAMIC_INTERFACES, true, nss_stats_bin_fill_pptp},
+	{"map_t_instance", nss_stats_str_map_t_instance_debug_stats, NSS_STATS_MAP_T_MAX, NSS_MAX_MAP_T_DYNAMIC_INTERFACES, true, nss_stats_bin_fill_map_t},
+	{"dtls_session", nss_stats_str_dtls_session_debug_stats, NSS_STATS_DTLS_SESSION_MAX, NSS_MAX_DTLS_SESSIONS, true, nss_stats_bin_fill_dtls},
+};
+
+#define NSS_STATS_BIN_GROUP_MAX (sizeof(nss_stats_bin_groups) / sizeof(nss_stats_bin_groups[0]))
+
+/*
+ * nss_stats_bin_group_stride()
+ *	Number of u64 slots of one row of a group
+ */
+static inline uint32_t nss_stats_bin_group_stride(struct nss_stats_bin_group *g)
+{
+	return g->num_stats + (g->has_if_num ? 1 : 0);
+}
+
+/*
+ * nss_stats_bin_group_counters()
+ *	Number of u64 slots a group occupies in the snapshot
+ */
+static inline uint32_t nss_stats_bin_group_counters(struct nss_stats_bin_group *g)
+{
+	return nss_stats_bin_group_stride(g) * g->num_instances;
+}
+
+/*
+ * nss_stats_bin_num_counters()
+ *	Total number of u64 slots in the snapshot
+ */
+static uint32_t nss_stats_bin_num_counters(void)
+{
+	uint32_t i, count = 0;
+
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		count += nss_stats_bin_group_counters(&nss_stats_bin_groups[i]);
+	}
+
+	return count;
+}
+
+/*
+ * nss_stats_bin_snapshot()
+ *	Copy every counter of the binary export into out[nss_stats_bin_num_counters()]
+ *
+ * stats_lock is held across all groups, so the counters the NSS syncs under
+ * it are consistent with each other. The drv counters are atomics and the
+ * session counters have their own store; both are updated without stats_lock
+ * and may be a few updates out of step with the rest of the snapshot.
+ */
+static void nss_stats_bin_snapshot(uint64_t *out)
+{
+	uint32_t i;
+
+	memset(out, 0, nss_stats_bin_num_counters() * sizeof(uint64_t));
+	spin_lock_bh(&nss_top_main.stats_lock);
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		struct nss_stats_bin_group *g = &nss_stats_bin_groups[i];
+
+		g->fill(out + (g->first_instance * nss_stats_bin_group_stride(g)));
+		out += nss_stats_bin_group_counters(g);
+	}
+	spin_unlock_bh(&nss_top_main.stats_lock);
+}
+
+/*
+ * nss_stats_bin_data_open()
+ *	Take a snapshot of all counters for this file descriptor.
+ */
+static int nss_stats_bin_data_open(struct inode *inode, struct file *filp)
+{
+	struct nss_stats_bin_hdr *hdr;
+	uint32_t num_counters = nss_stats_bin_num_counters();
+	size_t size = sizeof(struct nss_stats_bin_hdr) + (num_counters * sizeof(uint64_t));
+
+	hdr = vzalloc(size);
+	if (!hdr) {
+		return -ENOMEM;
+	}
+
+	hdr->magic = NSS_STATS_BIN_MAGIC;
+	hdr->version = NSS_STATS_BIN_VERSION;
+	hdr->hdr_len = sizeof(struct nss_stats_bin_hdr);
+	hdr->num_counters = num_counters;
+	filp->private_data = hdr;
+
+	return 0;
+}
+
+/*
+ * nss_stats_bin_data_read()
+ *	Read the binary counter snapshot.
+ *
+ * The snapshot is refreshed whenever a read starts at offset zero, so a collector
+ * can keep the file open and pread() the whole region once per poll.
+ */
+static ssize_t nss_stats_bin_data_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_stats_bin_hdr *hdr = fp->private_data;
+	uint64_t *out = (uint64_t *)(hdr + 1);
+	size_t size = hdr->hdr_len + (hdr->num_counters * sizeof(uint64_t));
+
+	if (*ppos == 0) {
+		nss_stats_bin_snapshot(out);
+		hdr->timestamp = ktime_to_ns(ktime_get());
+		hdr->generation++;
+	}
+
+	return simple_read_from_buffer(ubuf, sz, ppos, hdr, size);
+}
+
+/*
+ * nss_stats_bin_data_release()
+ */
+static int nss_stats_bin_data_release(struct inode *inode, struct file *filp)
+{
+	vfree(filp->private_data);
+	return 0;
+}
+
+/*
+ * nss_stats_bin_schema_read()
+ *	Describe the binary snapshot: one line per counter with its byte offset.
+ */
+static ssize_t nss_stats_bin_schema_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	uint32_t max_output_lines = nss_stats_bin_num_counters() + 2;
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * max_output_lines;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	uint32_t offset = sizeof(struct nss_stats_bin_hdr);
+	uint32_t i, id, j;
+
+	char *lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	size_wr = scnprintf(lbuf, size_al, "version %u counters %u\n",
+				NSS_STATS_BIN_VERSION, nss_stats_bin_num_counters());
+
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		struct nss_stats_bin_group *g = &nss_stats_bin_groups[i];
+
+		for (id = 0; id < g->num_instances; id++) {
+			if (g->has_if_num) {
+				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+							"%u %s %u if_num\n", offset, g->name, id);
+				offset += sizeof(uint64_t);
+			}
+
+			for (j = 0; j < g->num_stats; j++) {
+				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+							"%u %s %u %s\n", offset, g->name, id, g->strings[j]);
+				offset += sizeof(uint64_t);
+			}
+		}
+	}
+
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(lbuf);
+
+	return bytes_read;
+}
+
+/*
+ * nss_stats_bin_data_ops
+ */
+static const struct file_operations nss_stats_bin_data_ops = {
+	.open = nss_stats_bin_data_open,
+	.read = nss_stats_bin_data_read,
+	.llseek = generic_file_llseek,
+	.release = nss_stats_bin_data_release,
+};
+
+/*
+ * nss_stats_bin_schema_ops
+ */
+static const struct file_operations nss_stats_bin_schema_ops = {
+	.open = nss_stats_open,
+	.read = nss_stats_bin_schema_read,
+	.llseek = generic_file_llseek,
+	.release = nss_stats_release,
+};
+
+/*
+ **********************************
+ Statistics rate sampler
+ **********************************
+ */
+
+#define NSS_STATS_RATE_HISTORY		8	/* Samples kept in the history ring */
+#define NSS_STATS_RATE_INTERVAL_MS_MAX	60000	/* Longest sampling interval */
+
+/*
+ * nss_stats_rate
+ *	Periodic snapshots of the counters of the binary export
+ *
+ * Off by default; dev/nss/general/stats_rate_interval_ms starts sampling
+ * when set and stops it again when set to 0. A sample leaves out the rows
+ * of a group before its first_instance, and stats_lock is only held while
+ * one group is copied, so sampling does not hold off the stats syncs for
+ * the whole snapshot.
+ *
+ * Rates are derived from the two most recent samples, averages from the
+ * oldest and newest samples in the ring. Peaks are the highest per-interval
+ * rate seen since the sampler was (re)started.
+ *
+ * Session groups pack their active sessions, so a session changes rows when
+ * an earlier one goes away. Their rows are matched by interface number
+ * before any delta is taken, see nss_stats_rate_align(); the peaks follow
+ * the rows of the most recent sample.
+ */
+struct nss_stats_rate {
+	struct mutex lock;				/* Protects the ring */
+	struct delayed_work dwork;			/* Sampling work */
+	uint32_t num_counters;				/* Counters per sample */
+	uint64_t *ring[NSS_STATS_RATE_HISTORY];		/* Sample ring */
+	unsigned long ts[NSS_STATS_RATE_HISTORY];	/* Jiffies of each sample */
+	uint64_t *peak;					/* Peak per second rate of each counter */
+	uint64_t *peak_next;				/* Peaks realigned to a new sample, swapped with peak */
+	uint64_t *prev;					/* Previous sample realigned to a new sample */
+	uint32_t head;					/* Slot of the most recent sample */
+	uint32_t count;					/* Valid samples in the ring */
+	bool running;					/* Work is scheduled */
+};
+
+static struct nss_stats_rate nss_stats_rate;
+static DEFINE_MUTEX(nss_stats_rate_ctl_lock);		/* Serializes starting and stopping the sampler */
+int nss_stats_rate_interval_ms = 0;
+
+/*
+ * nss_stats_rate_group_instances()
+ *	Number of rows of a group in a rate sample
+ */
+static inline uint32_t nss_stats_rate_group_instances(struct nss_stats_bin_group *g)
+{
+	return g->num_instances - g->first_instance;
+}
+
+/*
+ * nss_stats_rate_group_counters()
+ *	Number of u64 slots a group occupies in a rate sample
+ */
+static inline uint32_t nss_stats_rate_group_counters(struct nss_stats_bin_group *g)
+{
+	return nss_stats_bin_group_stride(g) * nss_stats_rate_group_instances(g);
+}
+
+/*
+ * nss_stats_rate_num_counters()
+ *	Total number of u64 slots in a rate sample
+ */
+static uint32_t nss_stats_rate_num_counters(void)
+{
+	uint32_t i, count = 0;
+
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		count += nss_stats_rate_group_counters(&nss_stats_bin_groups[i]);
+	}
+
+	return count;
+}
+
+/*
+ * nss_stats_rate_snapshot()
+ *	Copy the counters of a rate sample into out[nss_stats_rate_num_counters()]
+ *
+ * stats_lock is taken per group, so a sample is only consistent within a
+ * group; rates are taken per counter, which is all they need.
+ */
+static void nss_stats_rate_snapshot(uint64_t *out)
+{
+	struct nss_stats_bin_group *g;
+	uint32_t i, count;
+
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		g = &nss_stats_bin_groups[i];
+		count = nss_stats_rate_group_counters(g);
+		memset(out, 0, count * sizeof(uint64_t));
+
+		spin_lock_bh(&nss_top_main.stats_lock);
+		g->fill(out);
+		spin_unlock_bh(&nss_top_main.stats_lock);
+
+		out += count;
+	}
+}
+
+/*
+ * nss_stats_rate_per_sec()
+ *	Convert a delta over the given number of jiffies to a per second rate
+ */
+static inline uint64_t nss_stats_rate_per_sec(uint64_t delta, unsigned long dt)
+{
+	uint32_t dt_ms = jiffies_to_msecs(dt);
+
+	if (!dt_ms) {
+		return 0;
+	}
+
+	return div_u64(delta * MSEC_PER_SEC, dt_ms);
+}
+
+/*
+ * nss_stats_rate_align()
+ *	Copy sample src to dst with the session rows in the order of sample ref
+ *
+ * Rows are matched by interface number. A session of ref that src does not
+ * have gets ref's own row when fill is set, so that it shows no delta, and
+ * zeros otherwise. Groups without an interface number are copied as is.
+ */
+static void nss_stats_rate_align(uint64_t *dst, uint64_t *src, uint64_t *ref, bool fill)
+{
+	struct nss_stats_bin_group *g;
+	uint64_t *row;
+	uint32_t i, id, n, stride, count, instances;
+
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		g = &nss_stats_bin_groups[i];
+		count = nss_stats_rate_group_counters(g);
+		if (!g->has_if_num) {
+			memcpy(dst, src, count * sizeof(uint64_t));
+			goto next;
+		}
+
+		stride = nss_stats_bin_group_stride(g);
+		instances = nss_stats_rate_group_instances(g);
+		for (id = 0; id < instances; id++) {
+			row = NULL;
+			for (n = 0; n < instances; n++) {
+				if (src[n * stride] == ref[id * stride]) {
+					row = &src[n * stride];
+					break;
+				}
+			}
+
+			if (row) {
+				memcpy(&dst[id * stride], row, stride * sizeof(uint64_t));
+			} else if (fill) {
+				memcpy(&dst[id * stride], &ref[id * stride], stride * sizeof(uint64_t));
+			} else {
+				memset(&dst[id * stride], 0, stride * sizeof(uint64_t));
+			}
+
+			/*
+			 * Keep the interface number so the next alignment can match the row
+			 */
+			dst[id * stride] = ref[id * stride];
+		}
+
+next:
+		dst += count;
+		src += count;
+		ref += count;
+	}
+}
+
+/*
+ * nss_stats_rate_work()
+ *	Take a sample and update the peak rates
+ */
+static void nss_stats_rate_work(struct work_struct *work)
+{
+	struct nss_stats_rate *nsr = container_of(to_delayed_work(work), struct nss_stats_rate, dwork);
+	uint32_t interval = nss_stats_rate_interval_ms;
+	uint64_t *cur, *prev, *peak;
+	unsigned long dt;
+	uint32_t i, slot;
+
+	mutex_lock(&nsr->lock);
+	slot = (nsr->head + 1) % NSS_STATS_RATE_HISTORY;
+	cur = nsr->ring[slot];
+	nss_stats_rate_snapshot(cur);
+	nsr->ts[slot] = jiffies;
+
+	if (nsr->count) {
+		prev = nsr->prev;
+		nss_stats_rate_align(prev, nsr->ring[nsr->head], cur, true);
+		nss_stats_rate_align(nsr->peak_next, nsr->peak, cur, false);
+		peak = nsr->peak;
+		nsr->peak = nsr->peak_next;
+		nsr->peak_next = peak;
+
+		dt = nsr->ts[slot] - nsr->ts[nsr->head];
+		for (i = 0; i < nsr->num_counters; i++) {
+			uint64_t rate;
+
+			/*
+			 * Gauges (free counts, depths) can go down; they have no rate.
+			 */
+			if (cur[i] < prev[i]) {
+				continue;
+			}
+
+			rate = nss_stats_rate_per_sec(cur[i] - prev[i], dt);
+			if (rate > nsr->peak[i]) {
+				nsr->peak[i] = rate;
+			}
+		}
+	}
+
+	nsr->head = slot;
+	if (nsr->count < NSS_STATS_RATE_HISTORY) {
+		nsr->count++;
+	}
+
+	/*
+	 * A zero interval stops the sampler; the sysctl handler frees the ring.
+	 */
+	if (nsr->running && interval) {
+		schedule_delayed_work(&nsr->dwork, msecs_to_jiffies(interval));
+	}
+	mutex_unlock(&nsr->lock);
+}
+
+/*
+ * nss_stats_rate_read()
+ *	Read delta, rate, average rate and peak rate of every counter that moved
+ */
+static ssize_t nss_stats_rate_read(struct file *fp, char __user *ubuf, size_t sz, loff_t *ppos)
+{
+	struct nss_stats_rate *nsr = &nss_stats_rate;
+	uint32_t max_output_lines = nsr->num_counters + 4;
+	size_t size_al = NSS_STATS_MAX_STR_LENGTH * 2 * max_output_lines;
+	size_t size_wr = 0;
+	ssize_t bytes_read = 0;
+	uint64_t *cur, *prev = NULL, *oldest = NULL;
+	unsigned long dt, dt_all;
+	uint32_t i, id, j, k = 0, label;
+
+	char *lbuf = vzalloc(size_al);
+	if (unlikely(lbuf == NULL)) {
+		nss_warning("Could not allocate memory for local statistics buffer");
+		return 0;
+	}
+
+	mutex_lock(&nsr->lock);
+	size_wr = scnprintf(lbuf, size_al, "interval_ms = %d samples = %u\n",
+				nss_stats_rate_interval_ms, nsr->count);
+	if (nsr->count < 2) {
+		mutex_unlock(&nsr->lock);
+		goto done;
+	}
+
+	prev = vmalloc(nsr->num_counters * sizeof(uint64_t));
+	oldest = vmalloc(nsr->num_counters * sizeof(uint64_t));
+	if (unlikely(!prev || !oldest)) {
+		mutex_unlock(&nsr->lock);
+		nss_warning("Could not allocate memory for local statistics buffer");
+		goto done;
+	}
+
+	cur = nsr->ring[nsr->head];
+	nss_stats_rate_align(prev, nsr->ring[(nsr->head + NSS_STATS_RATE_HISTORY - 1) % NSS_STATS_RATE_HISTORY], cur, true);
+	nss_stats_rate_align(oldest, nsr->ring[(nsr->head + NSS_STATS_RATE_HISTORY + 1 - nsr->count) % NSS_STATS_RATE_HISTORY], cur, true);
+	dt = nsr->ts[nsr->head] - nsr->ts[(nsr->head + NSS_STATS_RATE_HISTORY - 1) % NSS_STATS_RATE_HISTORY];
+	dt_all = nsr->ts[nsr->head] - nsr->ts[(nsr->head + NSS_STATS_RATE_HISTORY + 1 - nsr->count) % NSS_STATS_RATE_HISTORY];
+
+	size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+				"counter: delta rate/s avg/s peak/s (last %ums, avg over %ums)\n",
+				jiffies_to_msecs(dt), jiffies_to_msecs(dt_all));
+
+	for (i = 0; i < NSS_STATS_BIN_GROUP_MAX; i++) {
+		struct nss_stats_bin_group *g = &nss_stats_bin_groups[i];
+
+		for (id = 0; id < nss_stats_rate_group_instances(g); id++) {
+			label = g->first_instance + id;
+			if (g->has_if_num) {
+				label = (uint32_t)cur[k];
+				k++;
+			}
+
+			for (j = 0; j < g->num_stats; j++, k++) {
+				if (!nsr->peak[k] || cur[k] < prev[k]) {
+					continue;
+				}
+
+				size_wr += scnprintf(lbuf + size_wr, size_al - size_wr,
+						"%s[%u].%s: %llu %llu %llu %llu\n", g->name, label, g->strings[j],
+						cur[k] - prev[k], nss_stats_rate_per_sec(cur[k] - prev[k], dt),
+						(cur[k] >= oldest[k]) ? nss_stats_rate_per_sec(cur[k] - oldest[k], dt_all) : 0,
+						nsr->peak[k]);
+			}
+		}
+	}
+	mutex_unlock(&nsr->lock);
+
+done:
+	bytes_read = simple_read_from_buffer(ubuf, sz, ppos, lbuf, size_wr);
+	vfree(oldest);
+	vfree(prev);
+	vfree(lbuf);
+
+	return bytes_read;
+}
+
+/*
+ * nss_stats_rate_ops
+ */
+static const struct file_operations nss_stats_rate_ops = {
+	.read = nss_stats_rate_read,
+	.llseek = generic_file_llseek,
+};
+
+/*
+ * nss_stats_rate_start()
+ *	Allocate the sample ring and start sampling, ctl lock held
+ */
+static int nss_stats_rate_start(void)
+{
+	struct nss_stats_rate *nsr = &nss_stats_rate;
+	uint32_t i;
+
+	if (nsr->running) {
+		return 0;
+	}
+
+	nsr->peak = vzalloc(nsr->num_counters * sizeof(uint64_t));
+	nsr->peak_next = vzalloc(nsr->num_counters * sizeof(uint64_t));
+	nsr->prev = vzalloc(nsr->num_counters * sizeof(uint64_t));
+	if (!nsr->peak || !nsr->peak_next || !nsr->prev) {
+		nss_warning("Could not allocate memory for the stats rate sampler");
+		goto fail;
+	}
+
+	for (i = 0; i < NSS_STATS_RATE_HISTORY; i++) {
+		nsr->ring[i] = vzalloc(nsr->num_counters * sizeof(uint64_t));
+		if (!nsr->ring[i]) {
+			nss_warning("Could not allocate memory for the stats rate sampler");
+			goto fail;
+		}
+	}
+
+	mutex_lock(&nsr->lock);
+	nsr->head = 0;
+	nsr->count = 0;
+	nsr->running = true;
+	mutex_unlock(&nsr->lock);
+	schedule_delayed_work(&nsr->dwork, msecs_to_jiffies(nss_stats_rate_interval_ms));
+	return 0;
+
+fail:
+	for (i = 0; i < NSS_STATS_RATE_HISTORY; i++) {
+		vfree(nsr->ring[i]);
+		nsr->ring[i] = NULL;
+	}
+	vfree(nsr->prev);
+	nsr->prev = NULL;
+	vfree(nsr->peak_next);
+	nsr->peak_next = NULL;
+	vfree(nsr->peak);
+	nsr->peak = NULL;
+	return -ENOMEM;
+}
+
+/*
+ * nss_stats_rate_stop()
+ *	Stop sampling and free the sample ring, ctl lock held
+ */
+static void nss_stats_rate_stop(void)
+{
+	struct nss_stats_rate *nsr = &nss_stats_rate;
+	uint32_t i;
+
+	if (!nsr->running) {
+		return;
+	}
+
+	mutex_lock(&nsr->lock);
+	nsr->running = false;
+	mutex_unlock(&nsr->lock);
+	cancel_delayed_work_sync(&nsr->dwork);
+
+	/*
+	 * A reader holding the lock sees either the full ring or no samples
+	 */
+	mutex_lock(&nsr->lock);
+	nsr->count = 0;
+	for (i = 0; i < NSS_STATS_RATE_HISTORY; i++) {
+		vfree(nsr->ring[i]);
+		nsr->ring[i] = NULL;
+	}
+	vfree(nsr->prev);
+	nsr->prev = NULL;
+	vfree(nsr->peak_next);
+	nsr->peak_next = NULL;
+	vfree(nsr->peak);
+	nsr->peak = NULL;
+	mutex_unlock(&nsr->lock);
+}
+
+/*
+ * nss_stats_rate_interval_handler()
+ *	Set the sampling interval; a non zero interval starts the sampler and 0 stops it
+ */
+int nss_stats_rate_interval_handler(struct ctl_table *ctl, int write, void __user *buffer, size_t *lenp, loff_t *ppos)
+{
+	int interval;
+	int ret;
+
+	mutex_lock(&nss_stats_rate_ctl_lock);
+	interval = nss_stats_rate_interval_ms;
+	ret = proc_dointvec(ctl, write, buffer, lenp, ppos);
+	if (ret || !write) {
+		goto done;
+	}
+
+	if (nss_stats_rate_interval_ms < 0 || nss_stats_rate_interval_ms > NSS_STATS_RATE_INTERVAL_MS_MAX) {
+		nss_stats_rate_interval_ms = interval;
+		ret = -EINVAL;
+		goto done;
+	}
+
+	if (!nss_stats_rate_interval_ms) {
+		nss_stats_rate_stop();
+		goto done;
+	}
+
+	ret = nss_stats_rate_start();
+	if (ret) {
+		nss_stats_rate_interval_ms = 0;
+	}
+
+done:
+	mutex_unlock(&nss_stats_rate_ctl_lock);
+	return ret;
+}
+
+#define NSS_STATS_DECLARE_FILE_OPERATIONS(name) \
+static const struct file_operations nss_stats_##name##_ops = { \
+	.open = nss_stats_open, \
+	.read = nss_stats_##name##_read, \
+	.llseek = generic_file_llseek, \
+	.release = nss_stats_release, \
+};
+
+/*
+ * nss_ipv4_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(ipv4)
+
+/*
+ * ipv4_reasm_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(ipv4_reasm)
+
+/*
+ * ipv6_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(ipv6)
+
+/*
+ * ipv6_reasm_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(ipv6_reasm)
+
+/*
+ * n2h_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(n2h)
+
+/*
+ * lso_rx_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(lso_rx)
+
+/*
+ * drv_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(drv)
+
+/*
+ * ipsec_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(ipsec)
+
+/*
+ * pppoe_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(pppoe)
+
+/*
+ * l2tpv2_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(l2tpv2)
+
+/*
+ * map_t_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(map_t)
+
+/*
+ * pptp_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(pptp)
+
+/*
+ * gmac_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(gmac)
 
 /*
  * capwap_stats_ops
@@ -2521,6 +3529,26 @@ NSS_STATS_DECLARE_FILE_OPERATIONS(wifi)
  */
 NSS_STATS_DECLARE_FILE_OPERATIONS(dtls)
 
+/*
+ * rings_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(rings)
+
+/*
+ * napi_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(napi)
+
+/*
+ * gro_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(gro)
+
+/*
+ * virt_if_egress_stats_ops
+ */
+NSS_STATS_DECLARE_FILE_OPERATIONS(virt_if_egress)
+
 /*
  * nss_stats_init()
  * 	Enable NSS statistics
@@ -2636,6 +3664,16 @@ void nss_stats_init(void)
 		return;
 	}
 
+	/*
+	 * ipsec_stats
+	 */
+	nss_top_main.ipsec_dentry = debugfs_create_file("ipsec", 0400,
+						nss_top_main.stats_dentry, &nss_top_main, &nss_stats_ipsec_ops);
+	if (unlikely(nss_top_main.ipsec_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/ipsec file in debugfs");
+		return;
+	}
+
 	/*
 	 * pppoe_stats
 	 */
@@ -2778,6 +3816,88 @@ void nss_stats_init(void)
 		return;
 	}
 
+	/*
+	 * Descriptor ring state
+	 */
+	nss_top_main.rings_dentry = debugfs_create_file("rings", 0400,
+							nss_top_main.stats_dentry,
+							&nss_top_main,
+							&nss_stats_rings_ops);
+	if (unlikely(nss_top_main.rings_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/rings file in debugfs");
+		return;
+	}
+
+	/*
+	 * NAPI poll statistics
+	 */
+	nss_top_main.napi_dentry = debugfs_create_file("napi", 0400,
+							nss_top_main.stats_dentry,
+							&nss_top_main,
+							&nss_stats_napi_ops);
+	if (unlikely(nss_top_main.napi_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/napi file in debugfs");
+		return;
+	}
+
+	/*
+	 * Exception packet GRO statistics
+	 */
+	nss_top_main.gro_dentry = debugfs_create_file("gro", 0400,
+							nss_top_main.stats_dentry,
+							&nss_top_main,
+							&nss_stats_gro_ops);
+	if (unlikely(nss_top_main.gro_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/gro file in debugfs");
+		return;
+	}
+
+	/*
+	 * Virtual interface egress backlog statistics
+	 */
+	nss_top_main.virt_if_egress_dentry = debugfs_create_file("virt_if_egress", 0400,
+							nss_top_main.stats_dentry,
+							&nss_top_main,
+							&nss_stats_virt_if_egress_ops);
+	if (unlikely(nss_top_main.virt_if_egress_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/virt_if_egress file in debugfs");
+		return;
+	}
+
+	/*
+	 * Binary stats export
+	 */
+	nss_top_main.stats_bin_dentry = debugfs_create_dir("bin", nss_top_main.stats_dentry);
+	if (unlikely(nss_top_main.stats_bin_dentry == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/bin directory in debugfs");
+		return;
+	}
+
+	if (unlikely(debugfs_create_file("data", 0400, nss_top_main.stats_bin_dentry,
+					&nss_top_main, &nss_stats_bin_data_ops) == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/bin/data file in debugfs");
+		return;
+	}
+
+	if (unlikely(debugfs_create_file("schema", 0400, nss_top_main.stats_bin_dentry,
+					&nss_top_main, &nss_stats_bin_schema_ops) == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/bin/schema file in debugfs");
+		return;
+	}
+
+	/*
+	 * Rate sampler; started from its sysctl
+	 */
+	mutex_init(&nss_stats_rate.lock);
+	INIT_DELAYED_WORK(&nss_stats_rate.dwork, nss_stats_rate_work);
+	nss_stats_rate.num_counters = nss_stats_rate_num_counters();
+
+	if (unlikely(debugfs_create_file("rates", 0400, nss_top_main.stats_dentry,
+					&nss_top_main, &nss_stats_rate_ops) == NULL)) {
+		nss_warning("Failed to create qca-nss-drv/stats/rates file in debugfs");
+		return;
+	}
+
 	nss_log_init();
 }
 
@@ -2787,6 +3907,12 @@ void nss_stats_init(void)
  */
 void nss_stats_clean(void)
 {
+	mutex_lock(&nss_stats_rate_ctl_lock);
+	nss_stats_rate_interval_ms = 0;
+	nss_stats_rate_stop();
+	mutex_unlock(&nss_stats_rate_ctl_lock);
+	nss_log_exit();
+
 	/*
 	 * Remove debugfs tree
 	 */
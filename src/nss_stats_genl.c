@@ -0,0 +1,478 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_stats_genl.c
+ *	NSS statistics generic netlink family
+ *
+ * Firmware stats syncs are multicast to the "nss_stats_ev" group as they are
+ * folded into the driver statistics, and NSS_STATS_GENL_CMD_GET dumps the
+ * current totals. Events are only built when somebody is listening.
+ *
+ * Any user may subscribe to a generic netlink multicast group, so the group
+ * only carries aggregate counters; connection syncs are summed rather than
+ * sent with their 5-tuples. The dump requires CAP_NET_ADMIN.
+ */
+#include <linux/version.h>
+#include <net/genetlink.h>
+#include "nss_tx_rx_common.h"
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 7, 0))
+#define NSS_STATS_GENL_PORTID(skb) (NETLINK_CB(skb).pid)
+#else
+#define NSS_STATS_GENL_PORTID(skb) (NETLINK_CB(skb).portid)
+#endif
+
+static struct genl_family nss_stats_genl_family = {
+	.id = GENL_ID_GENERATE,
+	.hdrsize = 0,
+	.name = NSS_STATS_GENL_FAMILY_NAME,
+	.version = NSS_STATS_GENL_VERSION,
+	.maxattr = NSS_STATS_GENL_ATTR_MAX - 1,
+};
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 13, 0))
+static struct genl_multicast_group nss_stats_genl_mcgrp = {
+	.name = NSS_STATS_GENL_MCGRP_NAME,
+};
+#else
+static const struct genl_multicast_group nss_stats_genl_mcgrp[] = {
+	{ .name = NSS_STATS_GENL_MCGRP_NAME, },
+};
+#endif
+
+static bool nss_stats_genl_registered;
+
+/*
+ * nss_stats_genl_num_instances()
+ *	Number of instances of a statistics group
+ */
+static uint32_t nss_stats_genl_num_instances(uint32_t group)
+{
+	switch (group) {
+	case NSS_STATS_GENL_GROUP_NODE:
+		return NSS_MAX_NET_INTERFACES;
+
+	case NSS_STATS_GENL_GROUP_N2H:
+		return NSS_MAX_CORES;
+
+	case NSS_STATS_GENL_GROUP_GMAC:
+		return NSS_MAX_PHYSICAL_INTERFACES;
+
+	case NSS_STATS_GENL_GROUP_WIFI:
+		return NSS_MAX_WIFI_RADIO_INTERFACES;
+
+	case NSS_STATS_GENL_GROUP_DRV:
+	case NSS_STATS_GENL_GROUP_IPV4:
+	case NSS_STATS_GENL_GROUP_IPV6:
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * nss_stats_genl_num_counters()
+ *	Number of counters in one instance of a statistics group
+ */
+static uint32_t nss_stats_genl_num_counters(uint32_t group)
+{
+	switch (group) {
+	case NSS_STATS_GENL_GROUP_DRV:
+		return NSS_STATS_DRV_MAX;
+
+	case NSS_STATS_GENL_GROUP_NODE:
+		return NSS_STATS_NODE_MAX;
+
+	case NSS_STATS_GENL_GROUP_IPV4:
+		return NSS_STATS_IPV4_MAX + NSS_EXCEPTION_EVENT_IPV4_MAX;
+
+	case NSS_STATS_GENL_GROUP_IPV6:
+		return NSS_STATS_IPV6_MAX + NSS_EXCEPTION_EVENT_IPV6_MAX;
+
+	case NSS_STATS_GENL_GROUP_N2H:
+		return NSS_STATS_N2H_MAX;
+
+	case NSS_STATS_GENL_GROUP_GMAC:
+		return NSS_STATS_GMAC_MAX;
+
+	case NSS_STATS_GENL_GROUP_WIFI:
+		return NSS_STATS_WIFI_MAX;
+	}
+
+	return 0;
+}
+
+/*
+ * nss_stats_genl_copy_counters()
+ *	Copy the current totals of one group instance.
+ */
+static void nss_stats_genl_copy_counters(uint32_t group, uint32_t instance, uint64_t *out)
+{
+	struct nss_top_instance *nss_top = &nss_top_main;
+	uint32_t i;
+
+	if (group == NSS_STATS_GENL_GROUP_DRV) {
+		for (i = 0; i < NSS_STATS_DRV_MAX; i++) {
+			out[i] = NSS_PKT_STATS_READ(&nss_top->stats_drv[i]);
+		}
+		return;
+	}
+
+	spin_lock_bh(&nss_top->stats_lock);
+	switch (group) {
+	case NSS_STATS_GENL_GROUP_NODE:
+		/*
+		 * Only special interfaces carry node statistics
+		 */
+		if (instance < NSS_SPECIAL_IF_START) {
+			memset(out, 0, sizeof(nss_top->stats_node[0]));
+			break;
+		}
+
+		memcpy(out, nss_top->stats_node[NSS_STATS_NODE_IDX(instance)], sizeof(nss_top->stats_node[0]));
+		break;
+
+	case NSS_STATS_GENL_GROUP_IPV4:
+		memcpy(out, nss_top->stats_ipv4, sizeof(nss_top->stats_ipv4));
+		memcpy(out + NSS_STATS_IPV4_MAX, nss_top->stats_if_exception_ipv4, sizeof(nss_top->stats_if_exception_ipv4));
+		break;
+
+	case NSS_STATS_GENL_GROUP_IPV6:
+		memcpy(out, nss_top->stats_ipv6, sizeof(nss_top->stats_ipv6));
+		memcpy(out + NSS_STATS_IPV6_MAX, nss_top->stats_if_exception_ipv6, sizeof(nss_top->stats_if_exception_ipv6));
+		break;
+
+	case NSS_STATS_GENL_GROUP_N2H:
+		memcpy(out, nss_top->nss[instance].stats_n2h, sizeof(nss_top->nss[instance].stats_n2h));
+		break;
+
+	case NSS_STATS_GENL_GROUP_GMAC:
+		memcpy(out, nss_top->stats_gmac[instance], sizeof(nss_top->stats_gmac[instance]));
+		break;
+
+	case NSS_STATS_GENL_GROUP_WIFI:
+		memcpy(out, nss_top->stats_wifi[instance], sizeof(nss_top->stats_wifi[instance]));
+		break;
+	}
+	spin_unlock_bh(&nss_top->stats_lock);
+}
+
+/*
+ * nss_stats_genl_put_counters()
+ *	Add group, instance and counter attributes to a message.
+ */
+static int nss_stats_genl_put_counters(struct sk_buff *skb, uint32_t group, uint32_t instance)
+{
+	struct nlattr *nla;
+	uint32_t len = nss_stats_genl_num_counters(group) * sizeof(uint64_t);
+
+	if (nla_put_u32(skb, NSS_STATS_GENL_ATTR_GROUP, group)
+			|| nla_put_u32(skb, NSS_STATS_GENL_ATTR_INSTANCE, instance)) {
+		return -EMSGSIZE;
+	}
+
+	nla = nla_reserve(skb, NSS_STATS_GENL_ATTR_COUNTERS, len);
+	if (!nla) {
+		return -EMSGSIZE;
+	}
+
+	nss_stats_genl_copy_counters(group, instance, (uint64_t *)nla_data(nla));
+	return 0;
+}
+
+/*
+ * nss_stats_genl_has_listeners()
+ *	Check if anybody subscribed to the event group.
+ */
+static inline bool nss_stats_genl_has_listeners(void)
+{
+	if (unlikely(!nss_stats_genl_registered)) {
+		return false;
+	}
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 13, 0))
+	return netlink_has_listeners(init_net.genl_sock, nss_stats_genl_mcgrp.id);
+#else
+	return netlink_has_listeners(init_net.genl_sock, nss_stats_genl_family.mcgrp_offset);
+#endif
+}
+
+/*
+ * nss_stats_genl_multicast()
+ *	Send a completed event to the multicast group.
+ */
+static void nss_stats_genl_multicast(struct sk_buff *skb, void *hdr)
+{
+	genlmsg_end(skb, hdr);
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 13, 0))
+	genlmsg_multicast(skb, 0, nss_stats_genl_mcgrp.id, GFP_ATOMIC);
+#else
+	genlmsg_multicast(&nss_stats_genl_family, skb, 0, 0, GFP_ATOMIC);
+#endif
+}
+
+/*
+ * nss_stats_genl_sync_notify()
+ *	Multicast the totals of a group instance after the firmware synced it.
+ *
+ * Called from the stats sync handlers in softirq context, after stats_lock is released.
+ */
+void nss_stats_genl_sync_notify(struct nss_ctx_instance *nss_ctx, uint32_t group, uint32_t instance)
+{
+	struct sk_buff *skb;
+	void *hdr;
+	size_t size;
+
+	if (!nss_stats_genl_has_listeners()) {
+		return;
+	}
+
+	if (instance >= nss_stats_genl_num_instances(group)) {
+		return;
+	}
+
+	size = nla_total_size(sizeof(uint32_t)) * 3 + nla_total_size(nss_stats_genl_num_counters(group) * sizeof(uint64_t));
+	skb = genlmsg_new(size, GFP_ATOMIC);
+	if (!skb) {
+		return;
+	}
+
+	hdr = genlmsg_put(skb, 0, 0, &nss_stats_genl_family, 0, NSS_STATS_GENL_CMD_SYNC);
+	if (!hdr) {
+		goto fail;
+	}
+
+	if (nla_put_u32(skb, NSS_STATS_GENL_ATTR_CORE, nss_ctx->id)
+			|| nss_stats_genl_put_counters(skb, group, instance)) {
+		goto fail;
+	}
+
+	nss_stats_genl_multicast(skb, hdr);
+	return;
+
+fail:
+	nlmsg_free(skb);
+}
+
+/*
+ * NSS_STATS_GENL_CONN_ADD()
+ *	Add the counters of one IPv4 or IPv6 connection sync to totals[]
+ */
+#define NSS_STATS_GENL_CONN_ADD(totals, s) \
+	do { \
+		(totals)[NSS_STATS_GENL_CONN_FLOW_RX_PACKETS] += (s)->flow_rx_packet_count; \
+		(totals)[NSS_STATS_GENL_CONN_FLOW_RX_BYTES] += (s)->flow_rx_byte_count; \
+		(totals)[NSS_STATS_GENL_CONN_FLOW_TX_PACKETS] += (s)->flow_tx_packet_count; \
+		(totals)[NSS_STATS_GENL_CONN_FLOW_TX_BYTES] += (s)->flow_tx_byte_count; \
+		(totals)[NSS_STATS_GENL_CONN_RETURN_RX_PACKETS] += (s)->return_rx_packet_count; \
+		(totals)[NSS_STATS_GENL_CONN_RETURN_RX_BYTES] += (s)->return_rx_byte_count; \
+		(totals)[NSS_STATS_GENL_CONN_RETURN_TX_PACKETS] += (s)->return_tx_packet_count; \
+		(totals)[NSS_STATS_GENL_CONN_RETURN_TX_BYTES] += (s)->return_tx_byte_count; \
+	} while (0)
+
+/*
+ * nss_stats_genl_conn_sync_notify()
+ *	Multicast the summed counters of a batch of IPv4/IPv6 connection sync records.
+ *
+ * The group is open to unprivileged listeners, so the records themselves,
+ * which carry the connection 5-tuples, are not sent.
+ */
+void nss_stats_genl_conn_sync_notify(struct nss_ctx_instance *nss_ctx, uint32_t group, void *sync, size_t len, uint32_t count)
+{
+	uint64_t totals[NSS_STATS_GENL_CONN_MAX];
+	struct sk_buff *skb;
+	struct nlattr *nla;
+	uint8_t *rec = sync;
+	uint32_t i;
+	void *hdr;
+
+	if (!nss_stats_genl_has_listeners() || !count) {
+		return;
+	}
+
+	memset(totals, 0, sizeof(totals));
+	totals[NSS_STATS_GENL_CONN_SYNCS] = count;
+	for (i = 0; i < count; i++, rec += len) {
+		if (group == NSS_STATS_GENL_GROUP_IPV4) {
+			NSS_STATS_GENL_CONN_ADD(totals, (struct nss_ipv4_conn_sync *)rec);
+		} else {
+			NSS_STATS_GENL_CONN_ADD(totals, (struct nss_ipv6_conn_sync *)rec);
+		}
+	}
+
+	skb = genlmsg_new(nla_total_size(sizeof(uint32_t)) * 2 + nla_total_size(sizeof(totals)), GFP_ATOMIC);
+	if (!skb) {
+		return;
+	}
+
+	hdr = genlmsg_put(skb, 0, 0, &nss_stats_genl_family, 0, NSS_STATS_GENL_CMD_CONN_SYNC);
+	if (!hdr) {
+		goto fail;
+	}
+
+	if (nla_put_u32(skb, NSS_STATS_GENL_ATTR_CORE, nss_ctx->id)
+			|| nla_put_u32(skb, NSS_STATS_GENL_ATTR_GROUP, group)) {
+		goto fail;
+	}
+
+	nla = nla_reserve(skb, NSS_STATS_GENL_ATTR_COUNTERS, sizeof(totals));
+	if (!nla) {
+		goto fail;
+	}
+
+	memcpy(nla_data(nla), totals, sizeof(totals));
+	nss_stats_genl_multicast(skb, hdr);
+	return;
+
+fail:
+	nlmsg_free(skb);
+}
+
+/*
+ * nss_stats_genl_skip_instance()
+ *	Leave an instance out of the dump if it has nothing to report.
+ *
+ * Node statistics only exist for special interfaces; of those, interfaces
+ * nobody registered and interfaces whose counters are all zero are skipped.
+ */
+static bool nss_stats_genl_skip_instance(uint32_t group, uint32_t instance)
+{
+	struct nss_top_instance *nss_top = &nss_top_main;
+	uint64_t *stats;
+	bool zero = true;
+	uint32_t i;
+
+	if (group != NSS_STATS_GENL_GROUP_NODE) {
+		return false;
+	}
+
+	if (instance < NSS_SPECIAL_IF_START) {
+		return true;
+	}
+
+	if (!nss_top->subsys_dp_register[instance].msg_cb && !nss_top->subsys_dp_register[instance].cb) {
+		return true;
+	}
+
+	spin_lock_bh(&nss_top->stats_lock);
+	stats = nss_top->stats_node[NSS_STATS_NODE_IDX(instance)];
+	for (i = 0; i < NSS_STATS_NODE_MAX; i++) {
+		if (stats[i]) {
+			zero = false;
+			break;
+		}
+	}
+	spin_unlock_bh(&nss_top->stats_lock);
+
+	return zero;
+}
+
+/*
+ * nss_stats_genl_get_dumpit()
+ *	Dump the current totals of every group instance, one message each.
+ *
+ * Node instances with nothing to report are left out.
+ *
+ * cb->args[0] holds the group and cb->args[1] the instance to resume from.
+ */
+static int nss_stats_genl_get_dumpit(struct sk_buff *skb, struct netlink_callback *cb)
+{
+	uint32_t group = cb->args[0];
+	uint32_t instance = cb->args[1];
+	void *hdr;
+
+	for (; group < NSS_STATS_GENL_GROUP_MAX; group++, instance = 0) {
+		for (; instance < nss_stats_genl_num_instances(group); instance++) {
+			if (nss_stats_genl_skip_instance(group, instance)) {
+				continue;
+			}
+
+			hdr = genlmsg_put(skb, NSS_STATS_GENL_PORTID(cb->skb), cb->nlh->nlmsg_seq,
+					&nss_stats_genl_family, NLM_F_MULTI, NSS_STATS_GENL_CMD_GET);
+			if (!hdr) {
+				goto done;
+			}
+
+			if (nss_stats_genl_put_counters(skb, group, instance)) {
+				genlmsg_cancel(skb, hdr);
+				goto done;
+			}
+
+			genlmsg_end(skb, hdr);
+		}
+	}
+
+done:
+	cb->args[0] = group;
+	cb->args[1] = instance;
+	return skb->len;
+}
+
+static struct genl_ops nss_stats_genl_ops[] = {
+	{
+		.cmd = NSS_STATS_GENL_CMD_GET,
+		.dumpit = nss_stats_genl_get_dumpit,
+		.flags = GENL_ADMIN_PERM,
+	},
+};
+
+/*
+ * nss_stats_genl_init()
+ *	Register the NSS statistics generic netlink family
+ */
+void nss_stats_genl_init(void)
+{
+	int ret;
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 13, 0))
+	ret = genl_register_family_with_ops(&nss_stats_genl_family, nss_stats_genl_ops, ARRAY_SIZE(nss_stats_genl_ops));
+	if (ret) {
+		nss_warning("Failed to register nss_stats generic netlink family: %d", ret);
+		return;
+	}
+
+	ret = genl_register_mc_group(&nss_stats_genl_family, &nss_stats_genl_mcgrp);
+	if (ret) {
+		nss_warning("Failed to register nss_stats multicast group: %d", ret);
+		genl_unregister_family(&nss_stats_genl_family);
+		return;
+	}
+#else
+	ret = genl_register_family_with_ops_groups(&nss_stats_genl_family, nss_stats_genl_ops, nss_stats_genl_mcgrp);
+	if (ret) {
+		nss_warning("Failed to register nss_stats generic netlink family: %d", ret);
+		return;
+	}
+#endif
+
+	nss_stats_genl_registered = true;
+}
+
+/*
+ * nss_stats_genl_exit()
+ *	Unregister the NSS statistics generic netlink family
+ */
+void nss_stats_genl_exit(void)
+{
+	if (!nss_stats_genl_registered) {
+		return;
+	}
+
+	nss_stats_genl_registered = false;
+	genl_unregister_family(&nss_stats_genl_family);
+}
@@ -0,0 +1,216 @@
+/*
+ **************************************************************************
+ * Copyright (c) 2016, The Linux Foundation. All rights reserved.
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all copies.
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT
+ * OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ **************************************************************************
+ */
+
+/*
+ * nss_tracepoint.h
+ *	Static tracepoints of the NSS host data path
+ *
+ * Events show up under /sys/kernel/debug/tracing/events/nss. They compile
+ * to empty inlines when the kernel is built without CONFIG_TRACEPOINTS.
+ * The tracepoints are instantiated in nss_core.c.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM nss
+
+#if !defined(__NSS_TRACEPOINT_H) || defined(TRACE_HEADER_MULTI_READ)
+#define __NSS_TRACEPOINT_H
+
+#include <linux/tracepoint.h>
+
+/*
+ * nss_send_buffer
+ *	Buffer queued (or refused) on an H2N ring
+ */
+TRACE_EVENT(nss_send_buffer,
+	TP_PROTO(uint32_t core, uint16_t qid, uint32_t if_num, uint32_t segments, uint8_t buffer_type, uint32_t used, int32_t status),
+	TP_ARGS(core, qid, if_num, segments, buffer_type, used, status),
+
+	TP_STRUCT__entry(
+		__field(uint32_t, core)
+		__field(uint16_t, qid)
+		__field(uint32_t, if_num)
+		__field(uint32_t, segments)
+		__field(uint8_t, buffer_type)
+		__field(uint32_t, used)
+		__field(int32_t, status)
+	),
+
+	TP_fast_assign(
+		__entry->core = core;
+		__entry->qid = qid;
+		__entry->if_num = if_num;
+		__entry->segments = segments;
+		__entry->buffer_type = buffer_type;
+		__entry->used = used;
+		__entry->status = status;
+	),
+
+	TP_printk("core=%u qid=%u if_num=%u segments=%u type=%u used=%u status=%d",
+		__entry->core, __entry->qid, __entry->if_num, __entry->segments,
+		__entry->buffer_type, __entry->used, __entry->status)
+);
+
+/*
+ * nss_cause_queue
+ *	N2H ring serviced from NAPI
+ */
+TRACE_EVENT(nss_cause_queue,
+	TP_PROTO(uint32_t core, uint16_t cause, int16_t count, int16_t weight),
+	TP_ARGS(core, cause, count, weight),
+
+	TP_STRUCT__entry(
+		__field(uint32_t, core)
+		__field(uint16_t, cause)
+		__field(int16_t, count)
+		__field(int16_t, weight)
+	),
+
+	TP_fast_assign(
+		__entry->core = core;
+		__entry->cause = cause;
+		__entry->count = count;
+		__entry->weight = weight;
+	),
+
+	TP_printk("core=%u cause=0x%x count=%d weight=%d",
+		__entry->core, __entry->cause, __entry->count, __entry->weight)
+);
+
+/*
+ * nss_rx_pbuf
+ *	Buffer received from an N2H ring
+ */
+TRACE_EVENT(nss_rx_pbuf,
+	TP_PROTO(uint32_t core, uint8_t buffer_type, uint32_t interface, uint32_t len),
+	TP_ARGS(core, buffer_type, interface, len),
+
+	TP_STRUCT__entry(
+		__field(uint32_t, core)
+		__field(uint8_t, buffer_type)
+		__field(uint32_t, interface)
+		__field(uint32_t, len)
+	),
+
+	TP_fast_assign(
+		__entry->core = core;
+		__entry->buffer_type = buffer_type;
+		__entry->interface = interface;
+		__entry->len = len;
+	),
+
+	TP_printk("core=%u type=%u interface=%u len=%u",
+		__entry->core, __entry->buffer_type, __entry->interface, __entry->len)
+);
+
+/*
+ * nss_empty_refill
+ *	Empty buffer queue refilled
+ */
+TRACE_EVENT(nss_empty_refill,
+	TP_PROTO(uint32_t core, uint16_t wanted, uint16_t filled),
+	TP_ARGS(core, wanted, filled),
+
+	TP_STRUCT__entry(
+		__field(uint32_t, core)
+		__field(uint16_t, wanted)
+		__field(uint16_t, filled)
+	),
+
+	TP_fast_assign(
+		__entry->core = core;
+		__entry->wanted = wanted;
+		__entry->filled = filled;
+	),
+
+	TP_printk("core=%u wanted=%u filled=%u",
+		__entry->core, __entry->wanted, __entry->filled)
+);
+
+/*
+ * nss_tx_unblocked
+ *	H2N data queue decongested
+ */
+TRACE_EVENT(nss_tx_unblocked,
+	TP_PROTO(uint32_t core, uint32_t tx_q_full_cnt),
+	TP_ARGS(core, tx_q_full_cnt),
+
+	TP_STRUCT__entry(
+		__field(uint32_t, core)
+		__field(uint32_t, tx_q_full_cnt)
+	),
+
+	TP_fast_assign(
+		__entry->core = core;
+		__entry->tx_q_full_cnt = tx_q_full_cnt;
+	),
+
+	TP_printk("core=%u tx_q_full_cnt=%u",
+		__entry->core, __entry->tx_q_full_cnt)
+);
+
+/*
+ * nss_msg
+ *	Control message sent to or received from the NSS
+ */
+DECLARE_EVENT_CLASS(nss_msg,
+	TP_PROTO(uint32_t core, struct nss_cmn_msg *ncm),
+	TP_ARGS(core, ncm),
+
+	TP_STRUCT__entry(
+		__field(uint32_t, core)
+		__field(uint16_t, interface)
+		__field(uint32_t, type)
+		__field(uint32_t, response)
+		__field(uint32_t, error)
+		__field(uint32_t, len)
+	),
+
+	TP_fast_assign(
+		__entry->core = core;
+		__entry->interface = ncm->interface;
+		__entry->type = ncm->type;
+		__entry->response = ncm->response;
+		__entry->error = ncm->error;
+		__entry->len = ncm->len;
+	),
+
+	TP_printk("core=%u interface=%u type=%u response=%u error=%u len=%u",
+		__entry->core, __entry->interface, __entry->type,
+		__entry->response, __entry->error, __entry->len)
+);
+
+DEFINE_EVENT(nss_msg, nss_msg_tx,
+	TP_PROTO(uint32_t core, struct nss_cmn_msg *ncm),
+	TP_ARGS(core, ncm)
+);
+
+DEFINE_EVENT(nss_msg, nss_msg_rx,
+	TP_PROTO(uint32_t core, struct nss_cmn_msg *ncm),
+	TP_ARGS(core, ncm)
+);
+
+#endif /* __NSS_TRACEPOINT_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE nss_tracepoint
+
+/*
+ * This part must be outside protection
+ */
+#include <trace/define_trace.h>
@@ -17,10 +17,27 @@
 /*
  * nss_tstamp.c
  *	NSS Tstamp APIs
+ *
+ * The NSS stamps packets with its own free running counter (seconds in
+ * ts_data_hi, nanoseconds in ts_data_lo), which the host cannot read
+ * directly. Every delivery pairs a counter value with the host time it
+ * arrived; the smallest (host - counter) difference over a one second
+ * window is the best estimate of the offset between the two clocks. The
+ * offset in use only slews towards each new estimate, so consecutive
+ * conversions never jump.
+ *
+ * The PTP hardware clock runs from the host monotonic clock, with the
+ * adjustments made by a PTP daemon applied on top. A hardware timestamp is
+ * the PHC time of the host instant the counter value maps to, so gettime
+ * and the timestamps handed to the stack come from the same correlation,
+ * and gettime never moves backwards unless the daemon steps the clock.
  */
 
 #include "nss_tx_rx_common.h"
 #include <linux/etherdevice.h>
+#if IS_ENABLED(CONFIG_PTP_1588_CLOCK)
+#include <linux/ptp_clock_kernel.h>
+#endif
 
 static struct net_device_stats *nss_tstamp_ndev_stats(struct net_device *ndev);
 
@@ -37,6 +54,313 @@ struct nss_tstamp_data {
 	uint8_t ts_hdr_sz;	/* padding bytes */
 };
 
+#define NSS_TSTAMP_PHC_MAX_ADJ		100000000	/* Largest frequency adjustment in ppb */
+#define NSS_TSTAMP_PHC_WINDOW		HZ		/* Offset estimate window */
+#define NSS_TSTAMP_PHC_SLEW_PPM		500		/* Largest rate the offset in use moves at */
+
+/*
+ * nss_tstamp_phc
+ *	Correlation of the NSS counter with the host and the PHC adjustments
+ */
+struct nss_tstamp_phc {
+	spinlock_t lock;		/* Protects the fields below */
+	int64_t host_offset_ns;		/* Host monotonic time - NSS counter, in use */
+	int64_t target_offset_ns;	/* Latest estimate host_offset_ns slews towards */
+	uint64_t slew_ns;		/* Host monotonic time of the last slew step */
+	int64_t window_min_ns;		/* Smallest host - counter difference in this window */
+	unsigned long window_start;	/* Jiffies the window started */
+	bool valid;			/* host_offset_ns holds an estimate */
+	int64_t phc_offset_ns;		/* PHC time - host monotonic time at ref_ns */
+	uint64_t ref_ns;		/* Host monotonic time the frequency adjustment runs from */
+	int32_t ppb;			/* Frequency adjustment */
+#if IS_ENABLED(CONFIG_PTP_1588_CLOCK)
+	struct ptp_clock *ptp;		/* Registered PTP clock */
+	struct ptp_clock_info info;	/* PTP clock operations */
+#endif
+};
+
+static struct nss_tstamp_phc nss_tstamp_phc = {
+	.lock = __SPIN_LOCK_UNLOCKED(nss_tstamp_phc.lock),
+};
+
+/*
+ * nss_tstamp_phc_fold()
+ *	Move the frequency adjustment accumulated up to mono_ns into the offset, lock held
+ */
+static void nss_tstamp_phc_fold(uint64_t mono_ns)
+{
+	nss_tstamp_phc.phc_offset_ns += div_s64((int64_t)(mono_ns - nss_tstamp_phc.ref_ns) * nss_tstamp_phc.ppb, NSEC_PER_SEC);
+	nss_tstamp_phc.ref_ns = mono_ns;
+}
+
+/*
+ * nss_tstamp_phc_to_ns()
+ *	PHC time at host monotonic time mono_ns, lock held
+ */
+static inline uint64_t nss_tstamp_phc_to_ns(uint64_t mono_ns)
+{
+	return mono_ns + nss_tstamp_phc.phc_offset_ns
+		+ div_s64((int64_t)(mono_ns - nss_tstamp_phc.ref_ns) * nss_tstamp_phc.ppb, NSEC_PER_SEC);
+}
+
+/*
+ * nss_tstamp_phc_counter_to_mono()
+ *	Host monotonic time of an NSS counter value, lock held
+ */
+static inline uint64_t nss_tstamp_phc_counter_to_mono(uint64_t counter)
+{
+	return counter + nss_tstamp_phc.host_offset_ns;
+}
+
+/*
+ * nss_tstamp_phc_slew()
+ *	Move the offset in use towards the latest estimate, lock held
+ *
+ * The step is bounded by NSS_TSTAMP_PHC_SLEW_PPM of the time since the
+ * previous step, so a new estimate never makes the timestamps jump.
+ */
+static void nss_tstamp_phc_slew(uint64_t mono_ns)
+{
+	int64_t error = nss_tstamp_phc.target_offset_ns - nss_tstamp_phc.host_offset_ns;
+	int64_t step;
+
+	if (mono_ns <= nss_tstamp_phc.slew_ns) {
+		return;
+	}
+
+	step = (int64_t)div_u64((mono_ns - nss_tstamp_phc.slew_ns) * NSS_TSTAMP_PHC_SLEW_PPM, USEC_PER_SEC);
+	nss_tstamp_phc.slew_ns = mono_ns;
+
+	if (error > step) {
+		error = step;
+	} else if (error < -step) {
+		error = -step;
+	}
+
+	nss_tstamp_phc.host_offset_ns += error;
+}
+
+/*
+ * nss_tstamp_phc_sample()
+ *	Correlate a counter value with the host time it was delivered, lock held
+ */
+static void nss_tstamp_phc_sample(uint64_t counter, uint64_t mono_ns)
+{
+	int64_t diff = (int64_t)(mono_ns - counter);
+
+	if (!nss_tstamp_phc.valid) {
+		nss_tstamp_phc.host_offset_ns = diff;
+		nss_tstamp_phc.target_offset_ns = diff;
+		nss_tstamp_phc.slew_ns = mono_ns;
+		nss_tstamp_phc.window_min_ns = diff;
+		nss_tstamp_phc.window_start = jiffies;
+		nss_tstamp_phc.valid = true;
+		return;
+	}
+
+	if (diff < nss_tstamp_phc.window_min_ns) {
+		nss_tstamp_phc.window_min_ns = diff;
+	}
+
+	/*
+	 * Take a new estimate once per window so that both clocks may drift;
+	 * a lower difference than the estimate replaces it straight away.
+	 */
+	if (diff < nss_tstamp_phc.target_offset_ns) {
+		nss_tstamp_phc.target_offset_ns = diff;
+	}
+
+	if (time_after(jiffies, nss_tstamp_phc.window_start + NSS_TSTAMP_PHC_WINDOW)) {
+		nss_tstamp_phc.target_offset_ns = nss_tstamp_phc.window_min_ns;
+		nss_tstamp_phc.window_min_ns = diff;
+		nss_tstamp_phc.window_start = jiffies;
+	}
+
+	nss_tstamp_phc_slew(mono_ns);
+}
+
+#if IS_ENABLED(CONFIG_PTP_1588_CLOCK)
+/*
+ * nss_tstamp_phc_get_ns()
+ *	Current PHC time
+ */
+static int nss_tstamp_phc_get_ns(uint64_t *ns)
+{
+	uint64_t mono_ns = ktime_to_ns(ktime_get());
+
+	spin_lock_bh(&nss_tstamp_phc.lock);
+	*ns = nss_tstamp_phc_to_ns(mono_ns);
+	spin_unlock_bh(&nss_tstamp_phc.lock);
+
+	return 0;
+}
+
+/*
+ * nss_tstamp_phc_set_ns()
+ *	Step the PHC to ns
+ */
+static int nss_tstamp_phc_set_ns(uint64_t ns)
+{
+	uint64_t mono_ns = ktime_to_ns(ktime_get());
+
+	spin_lock_bh(&nss_tstamp_phc.lock);
+	nss_tstamp_phc.ref_ns = mono_ns;
+	nss_tstamp_phc.phc_offset_ns = (int64_t)(ns - mono_ns);
+	spin_unlock_bh(&nss_tstamp_phc.lock);
+
+	return 0;
+}
+
+/*
+ * nss_tstamp_phc_adjfreq()
+ *	Change the PHC frequency
+ */
+static int nss_tstamp_phc_adjfreq(struct ptp_clock_info *info, s32 ppb)
+{
+	uint64_t mono_ns = ktime_to_ns(ktime_get());
+
+	spin_lock_bh(&nss_tstamp_phc.lock);
+	nss_tstamp_phc_fold(mono_ns);
+	nss_tstamp_phc.ppb = ppb;
+	spin_unlock_bh(&nss_tstamp_phc.lock);
+
+	return 0;
+}
+
+/*
+ * nss_tstamp_phc_adjtime()
+ *	Shift the PHC by delta
+ */
+static int nss_tstamp_phc_adjtime(struct ptp_clock_info *info, s64 delta)
+{
+	spin_lock_bh(&nss_tstamp_phc.lock);
+	nss_tstamp_phc.phc_offset_ns += delta;
+	spin_unlock_bh(&nss_tstamp_phc.lock);
+
+	return 0;
+}
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 1, 0))
+/*
+ * nss_tstamp_phc_gettime()
+ */
+static int nss_tstamp_phc_gettime(struct ptp_clock_info *info, struct timespec64 *ts)
+{
+	uint64_t ns;
+	int ret;
+
+	ret = nss_tstamp_phc_get_ns(&ns);
+	if (!ret) {
+		*ts = ns_to_timespec64(ns);
+	}
+
+	return ret;
+}
+
+/*
+ * nss_tstamp_phc_settime()
+ */
+static int nss_tstamp_phc_settime(struct ptp_clock_info *info, const struct timespec64 *ts)
+{
+	return nss_tstamp_phc_set_ns(timespec64_to_ns(ts));
+}
+#else
+/*
+ * nss_tstamp_phc_gettime()
+ */
+static int nss_tstamp_phc_gettime(struct ptp_clock_info *info, struct timespec *ts)
+{
+	uint64_t ns;
+	int ret;
+
+	ret = nss_tstamp_phc_get_ns(&ns);
+	if (!ret) {
+		*ts = ns_to_timespec(ns);
+	}
+
+	return ret;
+}
+
+/*
+ * nss_tstamp_phc_settime()
+ */
+static int nss_tstamp_phc_settime(struct ptp_clock_info *info, const struct timespec *ts)
+{
+	return nss_tstamp_phc_set_ns(timespec_to_ns(ts));
+}
+#endif
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 7, 0))
+/*
+ * nss_tstamp_phc_getcrosststamp()
+ *	PHC time paired with the host realtime and raw monotonic clocks
+ *
+ * The PHC runs from the host monotonic clock, so the three readings are
+ * taken back to back with interrupts off and the pairing is exact.
+ */
+static int nss_tstamp_phc_getcrosststamp(struct ptp_clock_info *info, struct system_device_crosststamp *cts)
+{
+	unsigned long flags;
+	uint64_t mono_ns;
+
+	local_irq_save(flags);
+	mono_ns = ktime_to_ns(ktime_get());
+	cts->sys_realtime = ktime_get_real();
+	cts->sys_monoraw = ktime_get_raw();
+	local_irq_restore(flags);
+
+	spin_lock_bh(&nss_tstamp_phc.lock);
+	cts->device = ns_to_ktime(nss_tstamp_phc_to_ns(mono_ns));
+	spin_unlock_bh(&nss_tstamp_phc.lock);
+
+	return 0;
+}
+#endif
+
+/*
+ * nss_tstamp_phc_enable()
+ *	No alarms, external timestamps or periodic outputs
+ */
+static int nss_tstamp_phc_enable(struct ptp_clock_info *info, struct ptp_clock_request *rq, int on)
+{
+	return -EOPNOTSUPP;
+}
+
+static const struct ptp_clock_info nss_tstamp_phc_info = {
+	.owner = THIS_MODULE,
+	.name = "qca-nss-tstamp",
+	.max_adj = NSS_TSTAMP_PHC_MAX_ADJ,
+	.adjfreq = nss_tstamp_phc_adjfreq,
+	.adjtime = nss_tstamp_phc_adjtime,
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 1, 0))
+	.gettime64 = nss_tstamp_phc_gettime,
+	.settime64 = nss_tstamp_phc_settime,
+#else
+	.gettime = nss_tstamp_phc_gettime,
+	.settime = nss_tstamp_phc_settime,
+#endif
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 7, 0))
+	.getcrosststamp = nss_tstamp_phc_getcrosststamp,
+#endif
+	.enable = nss_tstamp_phc_enable,
+};
+#endif
+
+/*
+ * nss_tstamp_get_phc_index()
+ *	Index of the NSS PTP clock, -1 if there is none
+ */
+int nss_tstamp_get_phc_index(void)
+{
+#if IS_ENABLED(CONFIG_PTP_1588_CLOCK)
+	if (nss_tstamp_phc.ptp) {
+		return ptp_clock_index(nss_tstamp_phc.ptp);
+	}
+#endif
+	return -1;
+}
+EXPORT_SYMBOL(nss_tstamp_get_phc_index);
+
 /*
  * nss_tstamp_ndev_setup()
  *	Dummy setup for net_device handler
@@ -62,10 +386,23 @@ static struct net_device_stats *nss_tstamp_ndev_stats(struct net_device *ndev)
 static void nss_tstamp_copy_data(struct nss_tstamp_data *ntm, struct sk_buff *skb)
 {
 	struct skb_shared_hwtstamps *tstamp;
+	uint64_t counter = ((uint64_t)ntm->ts_data_hi * NSEC_PER_SEC) + ntm->ts_data_lo;
+	uint64_t mono_ns = ktime_to_ns(ktime_get());
 
 	tstamp = skb_hwtstamps(skb);
-	tstamp->hwtstamp = ktime_set(ntm->ts_data_hi, ntm->ts_data_lo);
-	tstamp->syststamp = ktime_set(ntm->ts_data_hi, ntm->ts_data_lo);
+
+	/*
+	 * Map the counter to the host instant it stands for, then to the PHC;
+	 * the system stamp is the same instant on the host realtime clock.
+	 */
+	spin_lock_bh(&nss_tstamp_phc.lock);
+	nss_tstamp_phc_sample(counter, mono_ns);
+	tstamp->hwtstamp = ns_to_ktime(nss_tstamp_phc_to_ns(nss_tstamp_phc_counter_to_mono(counter)));
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(3, 17, 0))
+	tstamp->syststamp = ktime_add(ns_to_ktime(nss_tstamp_phc_counter_to_mono(counter)),
+				ktime_sub(ktime_get_real(), ns_to_ktime(mono_ns)));
+#endif
+	spin_unlock_bh(&nss_tstamp_phc.lock);
 }
 
 /*
@@ -168,9 +505,39 @@ struct net_device *nss_tstamp_register_netdev(void)
 		return NULL;
 	}
 
+#if IS_ENABLED(CONFIG_PTP_1588_CLOCK)
+	/*
+	 * Timestamps still work without the PTP clock, just not for PTP daemons
+	 */
+	nss_tstamp_phc.info = nss_tstamp_phc_info;
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(3, 7, 0))
+	nss_tstamp_phc.ptp = ptp_clock_register(&nss_tstamp_phc.info, &ndev->dev);
+#else
+	nss_tstamp_phc.ptp = ptp_clock_register(&nss_tstamp_phc.info);
+#endif
+	if (IS_ERR(nss_tstamp_phc.ptp)) {
+		nss_warning("Tstamp: Could not register PTP clock %ld", PTR_ERR(nss_tstamp_phc.ptp));
+		nss_tstamp_phc.ptp = NULL;
+	}
+#endif
+
 	return ndev;
 }
 
+/*
+ * nss_tstamp_unregister_clock()
+ *	Remove the PTP clock
+ */
+void nss_tstamp_unregister_clock(void)
+{
+#if IS_ENABLED(CONFIG_PTP_1588_CLOCK)
+	if (nss_tstamp_phc.ptp) {
+		ptp_clock_unregister(nss_tstamp_phc.ptp);
+		nss_tstamp_phc.ptp = NULL;
+	}
+#endif
+}
+
 /*
  * nss_tstamp_register_handler()
  */
@@ -184,7 +551,6 @@ void nss_tstamp_register_handler(struct net_device *ndev)
 	nss_ctx->nss_top->subsys_dp_register[NSS_TSTAMP_INTERFACE].app_data = NULL;
 	nss_ctx->nss_top->subsys_dp_register[NSS_TSTAMP_INTERFACE].ndev = ndev;
 	nss_ctx->nss_top->subsys_dp_register[NSS_TSTAMP_INTERFACE].features = features;
-
 }
 
 
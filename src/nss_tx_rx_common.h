@@ -177,7 +177,7 @@ extern int32_t nss_tx_rx_virt_if_copy_stats(int32_t if_num, int i, char *line);
  */
 void nss_phys_if_register_handler(uint32_t if_num);
 extern void nss_crypto_register_handler(void);
-extern void nss_ipsec_register_handler(void);
+extern void nss_ipsec_register_handler(uint8_t core_id);
 extern void nss_ipv4_register_handler(void);
 extern void nss_ipv4_reasm_register_handler(void);
 extern void nss_ipv6_register_handler(void);
@@ -189,12 +189,16 @@ extern void nss_freq_register_handler(void);
 extern void nss_eth_rx_register_handler(void);
 extern void nss_lag_register_handler(void);
 extern void nss_dynamic_interface_register_handler(void);
+extern void nss_dynamic_interface_init(void);
+extern void nss_dynamic_interface_exit(void);
+extern struct ctl_table nss_dynamic_interface_table[];
 extern void nss_gre_redir_register_handler(void);
 extern void nss_lso_rx_register_handler(void);
 extern void nss_sjack_register_handler(void);
 extern void nss_wifi_register_handler(void);
 extern struct net_device *nss_tstamp_register_netdev(void);
 extern void nss_tstamp_register_handler(struct net_device *ndev);
+extern void nss_tstamp_unregister_clock(void);
 extern void nss_portid_register_handler(void);
 extern void nss_oam_register_handler(void);
 extern void nss_dtls_register_handler(void);
@@ -117,7 +117,7 @@ static void nss_virt_if_msg_handler(struct nss_ctx_instance *nss_ctx,
 	 * to the same callback/app_data.
 	 */
 	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
-		ncm->cb = (uint32_t)nss_ctx->nss_top->if_rx_msg_callback[ncm->interface];
+		ncm->cb = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].if_rx_msg_cb;
 		ncm->app_data = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].ndev;
 	}
 
@@ -665,6 +665,7 @@ nss_tx_status_t nss_virt_if_destroy(struct nss_virt_if_handle *handle, nss_virt_
 	nss_top_main.subsys_dp_register[if_num].ndev = NULL;
 	spin_unlock_bh(&nss_top_main.lock);
 	dev_put(dev);
+	nss_core_virt_if_egress_purge(if_num);
 
 	status = nss_virt_if_handle_destroy(handle);
 	if (status != NSS_TX_SUCCESS) {
@@ -718,6 +719,7 @@ nss_tx_status_t nss_virt_if_destroy_sync(struct nss_virt_if_handle *handle)
 	nss_top_main.subsys_dp_register[if_num].ndev = NULL;
 	spin_unlock_bh(&nss_top_main.lock);
 	dev_put(dev);
+	nss_core_virt_if_egress_purge(if_num);
 
 	status = nss_virt_if_handle_destroy_sync(handle);
 	if (status != NSS_TX_SUCCESS) {
@@ -888,7 +890,7 @@ void nss_virt_if_register(struct nss_virt_if_handle *handle,
 	nss_top_main.subsys_dp_register[if_num].app_data = NULL;
 	nss_top_main.subsys_dp_register[if_num].features = (uint32_t)netdev->features;
 
-	nss_top_main.if_rx_msg_callback[if_num] = NULL;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = NULL;
 }
 EXPORT_SYMBOL(nss_virt_if_register);
 
@@ -911,7 +913,9 @@ void nss_virt_if_unregister(struct nss_virt_if_handle *handle)
 	nss_top_main.subsys_dp_register[if_num].app_data = NULL;
 	nss_top_main.subsys_dp_register[if_num].features = 0;
 
-	nss_top_main.if_rx_msg_callback[if_num] = NULL;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = NULL;
+
+	nss_core_virt_if_egress_purge(if_num);
 }
 EXPORT_SYMBOL(nss_virt_if_unregister);
 
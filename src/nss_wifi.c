@@ -108,6 +108,7 @@ static void nss_wifi_handler(struct nss_ctx_instance *nss_ctx, struct nss_cmn_ms
 		 * To create the old API gmac statistics, we use the new extended GMAC stats.
 		 */
 		nss_wifi_stats_sync(nss_ctx, &ntm->msg.statsmsg, ncm->interface);
+		nss_stats_genl_sync_notify(nss_ctx, NSS_STATS_GENL_GROUP_WIFI, ncm->interface - NSS_WIFI_INTERFACE0);
 		break;
 	}
 
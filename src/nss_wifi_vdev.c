@@ -52,7 +52,7 @@ static void nss_wifi_vdev_handler(struct nss_ctx_instance *nss_ctx, struct nss_c
 	}
 
 	if (ncm->response == NSS_CMM_RESPONSE_NOTIFY) {
-		ncm->cb = (uint32_t)nss_ctx->nss_top->if_rx_msg_callback[ncm->interface];
+		ncm->cb = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].if_rx_msg_cb;
 		ncm->app_data = (uint32_t)nss_ctx->nss_top->subsys_dp_register[ncm->interface].ndev;
 	}
 
@@ -261,7 +261,7 @@ uint32_t nss_register_wifi_vdev_if(struct nss_ctx_instance *nss_ctx,
 	nss_top_main.subsys_dp_register[if_num].app_data = NULL;
 	nss_top_main.subsys_dp_register[if_num].features = features;
 
-	nss_top_main.if_rx_msg_callback[if_num] = vdev_event_callback;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = vdev_event_callback;
 
 	nss_core_register_handler(if_num, nss_wifi_vdev_handler, NULL);
 
@@ -281,7 +281,7 @@ void nss_unregister_wifi_vdev_if(uint32_t if_num)
 	nss_top_main.subsys_dp_register[if_num].app_data = NULL;
 	nss_top_main.subsys_dp_register[if_num].features = 0;
 
-	nss_top_main.if_rx_msg_callback[if_num] = NULL;
+	nss_top_main.subsys_dp_register[if_num].if_rx_msg_cb = NULL;
 
 	nss_core_unregister_handler(if_num);
 }